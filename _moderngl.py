@@ -258,6 +258,22 @@ class DefaultLoader:
         pass
 
 
+class NullLoader:
+    def __init__(self):
+        from moderngl import mgl
+
+        self.load_opengl_function = mgl.null_gl_function
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *args):
+        pass
+
+    def release(self):
+        pass
+
+
 class Error(Exception):
     pass
 
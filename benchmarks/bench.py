@@ -0,0 +1,391 @@
+"""
+Micro-benchmarks of the binding hot paths.
+
+Run against a standalone context and store the results as JSON::
+
+    python benchmarks/bench.py -o main.json
+    python benchmarks/bench.py --backend null -o null.json
+
+Compare two runs, the exit code is non-zero when a benchmark regressed::
+
+    python benchmarks/bench.py --compare main.json branch.json --threshold 1.1
+"""
+
+import argparse
+import fnmatch
+import json
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+import moderngl
+from _moderngl import UNIFORM_LOOKUP_TABLE
+
+SIZES = [64, 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024, 256 * 1024 * 1024]
+TEXTURE_SIZES = [16, 64, 256, 1024, 4096]
+
+GLSL_TYPES = {
+    0x8B56: "bool", 0x8B57: "bvec2", 0x8B58: "bvec3", 0x8B59: "bvec4",
+    0x1404: "int", 0x8B53: "ivec2", 0x8B54: "ivec3", 0x8B55: "ivec4",
+    0x1405: "uint", 0x8DC6: "uvec2", 0x8DC7: "uvec3", 0x8DC8: "uvec4",
+    0x1406: "float", 0x8B50: "vec2", 0x8B51: "vec3", 0x8B52: "vec4",
+    0x140A: "double", 0x8FFC: "dvec2", 0x8FFD: "dvec3", 0x8FFE: "dvec4",
+    0x8B5D: "sampler1D", 0x8DC0: "sampler1DArray", 0x8DC9: "isampler1D", 0x8DCE: "isampler1DArray",
+    0x8B5E: "sampler2D", 0x8DCA: "isampler2D", 0x8DD2: "usampler2D",
+    0x8DC1: "sampler2DArray", 0x8DCF: "isampler2DArray", 0x8DD7: "usampler2DArray",
+    0x8B5F: "sampler3D", 0x8DCB: "isampler3D", 0x8DD3: "usampler3D", 0x8B62: "sampler2DShadow",
+    0x9108: "sampler2DMS", 0x9109: "isampler2DMS", 0x910A: "usampler2DMS",
+    0x910B: "sampler2DMSArray", 0x910C: "isampler2DMSArray", 0x910D: "usampler2DMSArray",
+    0x8B60: "samplerCube", 0x8DCC: "isamplerCube", 0x8DD4: "usamplerCube", 0x904D: "image2D",
+    0x8B5A: "mat2", 0x8B65: "mat2x3", 0x8B66: "mat2x4", 0x8B67: "mat3x2", 0x8B5B: "mat3",
+    0x8B68: "mat3x4", 0x8B69: "mat4x2", 0x8B6A: "mat4x3", 0x8B5C: "mat4",
+    0x8F46: "dmat2", 0x8F49: "dmat2x3", 0x8F4A: "dmat2x4", 0x8F4B: "dmat3x2", 0x8F47: "dmat3",
+    0x8F4C: "dmat3x4", 0x8F4D: "dmat4x2", 0x8F4E: "dmat4x3", 0x8F48: "dmat4",
+}
+
+VERTEX_SHADER = """
+    #version 330 core
+
+    in vec2 in_vert;
+
+    void main() {
+        gl_Position = vec4(in_vert, 0.0, 1.0);
+    }
+"""
+
+FRAGMENT_SHADER = """
+    #version %d core
+
+    %s uniform %s u;
+    out vec4 color;
+
+    void main() {
+        color = vec4(%s);
+    }
+"""
+
+_benchmarks = []
+
+
+def benchmark(func):
+    _benchmarks.append(func)
+    return func
+
+
+def selected(args, *names):
+    # The benchmarks check their names before allocating anything, square brackets in the patterns match literally
+    if not args.filter:
+        return True
+    return any(fnmatch.fnmatchcase(name, pattern.replace("[", "[[]")) for name in names for pattern in args.filter)
+
+
+def size_name(size):
+    for unit in ("B", "KB", "MB"):
+        if size < 1024:
+            return f"{size}{unit}"
+        size //= 1024
+    return f"{size}GB"
+
+
+def measure(func, budget, repeat, nbytes=None):
+    # Calibrate the number of calls per sample to the time budget
+    number = 1
+    while True:
+        start = time.perf_counter()
+        for _ in range(number):
+            func()
+        elapsed = time.perf_counter() - start
+        if elapsed * repeat >= budget or number >= 1 << 20:
+            break
+        number *= 2 if elapsed == 0.0 else max(2, min(10, int(budget / repeat / elapsed)))
+
+    samples = []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        for _ in range(number):
+            func()
+        samples.append((time.perf_counter() - start) / number)
+
+    res = {
+        "number": number,
+        "min_ns": min(samples) * 1e9,
+        "median_ns": statistics.median(samples) * 1e9,
+    }
+    if nbytes:
+        res["gbps"] = nbytes / min(samples) / 1e9
+    return res
+
+
+@benchmark
+def buffer(ctx, args):
+    for size in args.sizes:
+        write, read = f"buffer.write[{size_name(size)}]", f"buffer.read[{size_name(size)}]"
+        if not selected(args, write, read):
+            continue
+        data = bytes(size)
+        buf = ctx.buffer(reserve=size)
+        yield write, lambda: buf.write(data), size
+        yield read, lambda: buf.read(), size
+        buf.release()
+
+
+@benchmark
+def chunks(ctx, args):
+    # one attribute of a 48 byte vertex, patched across the whole buffer
+    for chunk in (4, 12, 16, 64):
+        write, read = f"buffer.write_chunks[{chunk}B]", f"buffer.read_chunks[{chunk}B]"
+        if not selected(args, write, read):
+            continue
+        count = args.sizes[-1] // 64
+        data = bytes(chunk * count)
+        buf = ctx.buffer(reserve=count * 64)
+        yield write, lambda: buf.write_chunks(data, 0, 64, count), len(data)
+        yield read, lambda: buf.read_chunks(chunk, 0, 64, count), len(data)
+        buf.release()
+
+
+def _uniform_source(ctx, gl_type, glsl_type):
+    version = 330
+    qualifier = ""
+    if glsl_type.startswith("d"):
+        version = 400
+    if glsl_type == "image2D":
+        version = 420
+        qualifier = "layout(rgba8) readonly"
+
+    if glsl_type == "image2D":
+        expr = "float(imageSize(u).x)"
+    elif "sampler" in glsl_type:
+        lod = "" if "MS" in glsl_type else ", 0"
+        comp = "" if glsl_type.endswith("1D") else ".x"
+        expr = f"float(textureSize(u{lod}){comp})"
+    elif UNIFORM_LOOKUP_TABLE[gl_type][0]:
+        expr = "float(u[0][0])"
+    elif UNIFORM_LOOKUP_TABLE[gl_type][1] > 1:
+        expr = "float(u[0])"
+    else:
+        expr = "float(u)"
+
+    if version > ctx.version_code:
+        return None
+    return FRAGMENT_SHADER % (version, qualifier, glsl_type, expr)
+
+
+@benchmark
+def uniform(ctx, args):
+    for gl_type, (matrix, dimension, size, fmt) in UNIFORM_LOOKUP_TABLE.items():
+        glsl_type = GLSL_TYPES[gl_type]
+        if not selected(args, f"uniform.set[{glsl_type}]", f"uniform.get[{glsl_type}]"):
+            continue
+        source = _uniform_source(ctx, gl_type, glsl_type)
+        if source is None:
+            continue
+
+        try:
+            prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=source)
+        except moderngl.Error:
+            continue
+
+        member = prog["u"]
+        scalar = 1.0 if fmt[-1] in "fd" else 1
+        value = scalar if dimension == 1 else (scalar,) * dimension
+
+        def set_value(member=member, value=value):
+            member.value = value
+
+        def get_value(member=member):
+            return member.value
+
+        yield f"uniform.set[{glsl_type}]", set_value, None
+        yield f"uniform.get[{glsl_type}]", get_value, None
+        prog.release()
+
+
+@benchmark
+def render(ctx, args):
+    if not selected(args, "vertex_array.render", "vertex_array.render[instanced]"):
+        return
+    prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=FRAGMENT_SHADER % (330, "", "float", "u"))
+    vbo = ctx.buffer(reserve=24)
+    vao = ctx.vertex_array(prog, [(vbo, "2f", "in_vert")])
+    fbo = ctx.simple_framebuffer((4, 4))
+    fbo.use()
+    yield "vertex_array.render", lambda: vao.render(vertices=3), None
+    yield "vertex_array.render[instanced]", lambda: vao.render(vertices=3, instances=4), None
+    ctx.finish()
+    for obj in (vao, vbo, prog, fbo):
+        obj.release()
+
+
+@benchmark
+def scope(ctx, args):
+    if not selected(args, "scope.enter_exit"):
+        return
+    fbo = ctx.simple_framebuffer((4, 4))
+    tex = ctx.texture((4, 4), 4)
+    buf = ctx.buffer(reserve=256)
+    scope = ctx.scope(fbo, moderngl.BLEND, textures=[(tex, 0)], uniform_buffers=[(buf, 0)])
+
+    def enter_exit():
+        with scope:
+            pass
+
+    yield "scope.enter_exit", enter_exit, None
+    for obj in (scope, buf, tex, fbo):
+        obj.release()
+
+
+@benchmark
+def program(ctx, args):
+    source = FRAGMENT_SHADER % (330, "", "vec4", "u")
+
+    def compile_introspect():
+        prog = ctx.program(vertex_shader=VERTEX_SHADER, fragment_shader=source)
+        list(prog)
+        prog.release()
+
+    yield "context.program", compile_introspect, None
+
+
+@benchmark
+def texture(ctx, args):
+    for size in args.texture_sizes:
+        names = (f"texture.write[{size}x{size}]", f"texture.read[{size}x{size}]", f"framebuffer.read[{size}x{size}]")
+        if not selected(args, *names):
+            continue
+        data = bytes(size * size * 4)
+        tex = ctx.texture((size, size), 4)
+        fbo = ctx.framebuffer(tex)
+        yield names[0], lambda: tex.write(data), len(data)
+        yield names[1], lambda: tex.read(), len(data)
+        yield names[2], lambda: fbo.read(components=4), len(data)
+        fbo.release()
+        tex.release()
+
+
+@benchmark
+def copies(ctx, args):
+    # many small copies like a compaction pass
+    count = 1000
+    if not selected(args, f"copy_buffer[{count}x48B]", f"copy_buffers[{count}x48B]"):
+        return
+    src = ctx.buffer(reserve=count * 64)
+    dst = ctx.buffer(reserve=count * 64)
+    copies = [(dst, src, 48, i * 64, i * 64) for i in range(count)]
+
+    def copy_loop():
+        for args in copies:
+            ctx.copy_buffer(*args)
+
+    yield f"copy_buffer[{count}x48B]", copy_loop, None
+    yield f"copy_buffers[{count}x48B]", lambda: ctx.copy_buffers(copies), None
+    src.release()
+    dst.release()
+
+
+@benchmark
+def context(ctx, args):
+    settings = {"backend": args.backend} if args.backend else {}
+
+    def create_release():
+        moderngl.create_context(standalone=True, **settings).release()
+
+    yield "create_context", create_release, None
+
+    # The new contexts were made current
+    ctx.mglo.__enter__()
+
+
+def git_commit():
+    try:
+        return subprocess.check_output(["git", "rev-parse", "HEAD"], stderr=subprocess.DEVNULL, text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def run(ctx, args):
+    results = {}
+    for bench in _benchmarks:
+        for name, func, nbytes in bench(ctx, args):
+            if not selected(args, name):
+                continue
+            results[name] = measure(func, args.budget, args.repeat, nbytes)
+            if args.verbose:
+                print(f"{name:40} {results[name]['min_ns']:14.1f} ns", file=sys.stderr)
+
+    return {
+        "meta": {
+            "commit": git_commit(),
+            "moderngl": moderngl.__version__,
+            "python": platform.python_version(),
+            "platform": platform.platform(),
+            "backend": args.backend or "default",
+            "renderer": ctx.info["GL_RENDERER"],
+            "version_code": ctx.version_code,
+        },
+        "results": results,
+    }
+
+
+def compare(base_path, new_path, threshold):
+    with open(base_path) as f:
+        base = json.load(f)["results"]
+    with open(new_path) as f:
+        new = json.load(f)["results"]
+
+    regressed = False
+    for name in sorted(set(base) & set(new)):
+        ratio = new[name]["min_ns"] / base[name]["min_ns"]
+        mark = ""
+        if threshold and ratio > threshold:
+            mark = " REGRESSED"
+            regressed = True
+        print(f"{name:40} {base[name]['min_ns']:14.1f} {new[name]['min_ns']:14.1f} {ratio:8.3f}{mark}")
+
+    for name in sorted(set(base) ^ set(new)):
+        print(f"{name:40} {'only in ' + (base_path if name in base else new_path)}")
+
+    return 1 if regressed else 0
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description="moderngl micro-benchmarks")
+    parser.add_argument("-o", "--output", help="write the results to a json file")
+    parser.add_argument("-k", "--filter", action="append", help="glob pattern of the benchmarks to run")
+    parser.add_argument("--backend", help="glcontext backend, 'null' for the stub backend")
+    parser.add_argument("--budget", type=float, default=0.2, help="seconds spent per benchmark")
+    parser.add_argument("--repeat", type=int, default=5, help="samples per benchmark")
+    parser.add_argument("--max-size", type=int, default=SIZES[-1], help="largest buffer size in bytes")
+    parser.add_argument("--compare", nargs=2, metavar=("BASE", "NEW"), help="compare two result files")
+    parser.add_argument("--threshold", type=float, help="fail when NEW / BASE exceeds this ratio")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args(argv)
+    args.sizes = [size for size in SIZES if size <= args.max_size]
+    args.texture_sizes = [size for size in TEXTURE_SIZES if size * size * 4 <= args.max_size]
+    return args
+
+
+def main(argv=None):
+    args = parse_args(argv)
+
+    if args.compare:
+        return compare(*args.compare, args.threshold)
+
+    settings = {"backend": args.backend} if args.backend else {}
+    ctx = moderngl.create_context(standalone=True, **settings)
+    results = run(ctx, args)
+    ctx.release()
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
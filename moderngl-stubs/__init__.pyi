@@ -1,7 +1,8 @@
 from __future__ import annotations
 
+import os
 from contextlib import AbstractContextManager
-from typing import Any, Deque, Dict, Generator, List, Optional, Protocol, Set, Tuple, Union
+from typing import Any, Deque, Dict, Generator, Iterable, List, Mapping, Optional, Protocol, Set, Tuple, Union
 
 class ConvertibleToShaderSource(Protocol):
     def to_shader_source(self) -> str | bytes: ...
@@ -426,6 +427,9 @@ class Buffer:
     dynamic: bool
     """Is the buffer created with the dynamic flag?."""
 
+    page_size: Optional[int]
+    """The commitment page size of a sparse buffer. ``None`` for regular buffers."""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -460,6 +464,32 @@ class Buffer:
         Keyword Args:
             offset (int): The offset in bytes.
         """
+    def write_from_file(
+        self,
+        path: Union[str, os.PathLike],
+        offset: int = 0,
+        size: int = -1,
+        file_offset: int = 0,
+        chunk: int = 4 * 1024 * 1024,
+    ) -> None:
+        """
+        Write the content of a file without loading it into memory first.
+
+        The file is read in chunks directly into a persistently mapped staging
+        buffer owned by the context. While a chunk is read the GPU copies the
+        previous ones, so large files are uploaded with a bounded memory footprint.
+        When persistent mapping is not available the chunks are uploaded from
+        a temporary host buffer instead.
+
+        Args:
+            path (str): The path of the file.
+
+        Keyword Args:
+            offset (int): The offset in bytes in the buffer.
+            size (int): The number of bytes to read. Value ``-1`` means the rest of the file.
+            file_offset (int): The offset in bytes in the file.
+            chunk (int): The size of the staging chunks in bytes.
+        """
     def write_chunks(self, data: Any, start: int, step: int, count: int) -> None:
         """
         Split data to count equal parts.
@@ -538,6 +568,43 @@ class Buffer:
         Keyword Args:
             write_offset (int): The write offset.
         """
+    def scatter(self, src: Buffer, start: int, step: int, count: int, chunk_size: int, offset: int = 0) -> None:
+        """
+        Copy tightly packed chunks from another buffer to strided offsets on the GPU.
+
+        Chunk ``i`` is read from ``src`` at ``offset + i * chunk_size`` and written
+        at ``start + i * step``. Neither buffer is mapped, the copy is queued behind
+        the draws already using the buffers instead of waiting for them.
+        Large aligned copies run as a built-in compute shader on OpenGL 4.3,
+        other copies use one ``glCopyBufferSubData`` per chunk.
+
+        Args:
+            src (Buffer): The buffer holding the packed chunks.
+            start (int): First offset in bytes.
+            step (int): Offset increment in bytes.
+            count (int): The number of chunks.
+            chunk_size (int): The chunk size in bytes.
+
+        Keyword Args:
+            offset (int): The offset of the first chunk in ``src``.
+        """
+    def gather(self, dst: Buffer, start: int, step: int, count: int, chunk_size: int, offset: int = 0) -> None:
+        """
+        Copy chunks from strided offsets into another buffer on the GPU, tightly packed.
+
+        The inverse of :py:meth:`scatter`. Chunk ``i`` is read at ``start + i * step``
+        and written to ``dst`` at ``offset + i * chunk_size``.
+
+        Args:
+            dst (Buffer): The buffer receiving the packed chunks.
+            start (int): First offset in bytes.
+            step (int): Offset increment in bytes.
+            count (int): The number of chunks.
+            chunk_size (int): The chunk size in bytes.
+
+        Keyword Args:
+            offset (int): The offset of the first chunk in ``dst``.
+        """
     def clear(self, size: int = -1, offset: int = 0, chunk: Any = None) -> None:
         """
         Clear the content.
@@ -571,6 +638,27 @@ class Buffer:
             offset (int): The offset.
             size (int): The size. Value ``-1`` means all.
         """
+    def commit(self, offset: int = 0, size: int = -1) -> None:
+        """
+        Commit physical memory for a range of a sparse buffer.
+
+        The range must start on a page boundary and cover whole pages
+        unless it reaches the end of the buffer.
+
+        Keyword Args:
+            offset (int): The offset in bytes.
+            size (int): The size in bytes. Value ``-1`` means the rest of the buffer.
+        """
+    def decommit(self, offset: int = 0, size: int = -1) -> None:
+        """
+        Release the physical memory of a range of a sparse buffer.
+
+        The content of the range becomes undefined.
+
+        Keyword Args:
+            offset (int): The offset in bytes.
+            size (int): The size in bytes. Value ``-1`` means the rest of the buffer.
+        """
     def orphan(self, size: int = -1) -> None:
         """
         Orphan the buffer with the option to specify a new size.
@@ -620,6 +708,31 @@ class Buffer:
 
             >> vbo.orphan(vbo.size * 2)
         """
+    def view(
+        self,
+        dtype: Any = "u1",
+        shape: Union[int, Tuple[int, ...], None] = None,
+        offset: int = 0,
+        access: str = "rw",
+    ) -> memoryview:
+        """
+        Map a range of the buffer as a typed ``memoryview`` without copying.
+
+        The view has a PEP 3118 format, shape and strides,
+        ``numpy.asarray(view)`` returns a typed array over the mapped memory.
+        The range is unmapped when the view and the objects created from it are released.
+        The buffer must not be used by the GPU while it is mapped.
+
+        Args:
+            dtype: ``"f4"``, ``"u2"``, ... a numpy dtype or a PEP 3118 format.
+                Only the native byte order is accepted, ``">f4"`` raises an error on little endian hosts.
+            shape (tuple): The shape of the view, by default the rest of the buffer.
+            offset (int): The offset in bytes.
+            access (str): ``"r"``, ``"w"`` or ``"rw"``.
+
+        Returns:
+            memoryview
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
     def bind(self, *attribs, layout=None):
@@ -637,6 +750,135 @@ class Buffer:
             (self, index) tuple
         """
 
+class BufferSlice:
+    """
+    A range of a :py:class:`BufferArena`.
+
+    Slices can be used in place of a :py:class:`Buffer` in the content and as the index buffer
+    of :py:meth:`Context.vertex_array` and in :py:meth:`VertexArray.bind`.
+    Create a :py:class:`BufferSlice` using :py:meth:`BufferArena.allocate`.
+    """
+
+    arena: Optional[BufferArena]
+    """The arena the slice belongs to. ``None`` once the slice is released."""
+
+    buffer: Buffer
+    """The buffer of the arena."""
+
+    offset: int
+    """The offset of the slice in the buffer. Changes when the arena is defragmented."""
+
+    size: int
+    """The size of the slice in bytes."""
+
+    extra: Any
+    """User defined data."""
+
+    def write(self, data: Any, offset: int = 0) -> None:
+        """
+        Write the content.
+
+        Args:
+            data (bytes): The data.
+
+        Keyword Args:
+            offset (int): The offset in bytes relative to the slice.
+        """
+    def read(self, size: int = -1, offset: int = 0) -> bytes:
+        """
+        Read the content.
+
+        Args:
+            size (int): The size in bytes. Value ``-1`` means the rest of the slice.
+
+        Keyword Args:
+            offset (int): The offset in bytes relative to the slice.
+        """
+    def bind(self, *attribs, layout=None) -> Tuple[BufferSlice, Optional[str], ...]:
+        """
+        Helper method for binding a slice in :py:meth:`Context.vertex_array`.
+        """
+    def bind_to_uniform_block(self, binding: int = 0) -> None:
+        """
+        Bind the slice to a uniform block.
+
+        Args:
+            binding (int): The uniform block binding.
+        """
+    def bind_to_storage_buffer(self, binding: int = 0) -> None:
+        """
+        Bind the slice to a shader storage buffer.
+
+        Args:
+            binding (int): The shader storage binding.
+        """
+    def release(self) -> None:
+        """Return the slice to the arena."""
+
+class BufferArena:
+    """
+    Sub-allocates :py:class:`BufferSlice` objects from a single :py:class:`Buffer`.
+
+    Free blocks are kept in an address ordered free list and are merged with their
+    neighbours when a slice is released.
+    Create a :py:class:`BufferArena` using :py:meth:`Context.buffer_arena`.
+
+    .. code:: python
+
+        arena = ctx.buffer_arena(64 * 1024 * 1024)
+        vertices = arena.allocate(len(mesh_data))
+        vertices.write(mesh_data)
+        vao = ctx.vertex_array(prog, [(vertices, '3f 3f', 'in_vert', 'in_norm')])
+    """
+
+    ctx: Context
+    """The context this arena belongs to."""
+
+    buffer: Buffer
+    """The buffer holding the slices."""
+
+    capacity: int
+    """The size of the arena in bytes."""
+
+    alignment: int
+    """The alignment of the slice offsets."""
+
+    used: int
+    """The number of bytes allocated by slices."""
+
+    largest_free_block: int
+    """The size of the largest free block in bytes."""
+
+    def allocate(self, size: int) -> BufferSlice:
+        """
+        Allocate a slice using first fit.
+
+        Args:
+            size (int): The size in bytes.
+
+        Returns:
+            :py:class:`BufferSlice` object
+        """
+    def free(self, buffer_slice: BufferSlice) -> None:
+        """
+        Return a slice to the arena.
+
+        Args:
+            buffer_slice (BufferSlice): The slice to free.
+        """
+    def defragment(self) -> int:
+        """
+        Move the slices to the beginning of the buffer using ``glCopyBufferSubData``.
+
+        The offsets of the moved slices change, vertex arrays referencing them
+        must be created again.
+
+        Returns:
+            int: The number of moved slices.
+        """
+    def release(self) -> None:
+        """Release the buffer of the arena. The slices become invalid."""
+
 class ComputeShader:
     """
     A Compute Shader is a Shader Stage that is used entirely for computing arbitrary information.
@@ -773,6 +1015,74 @@ class ConditionalRender:
     def __enter__(self): ...
     def __exit__(self, *args): ...
 
+class Limits(Mapping[str, Any]):
+    """
+    The implementation limits of a context, queried once when the context is created.
+
+    The limits are named after the ``GL_`` constants in lowercase, without the prefix.
+    Limits not defined by the version of the context are ``0``.
+    """
+
+    max_texture_size: int
+    max_3d_texture_size: int
+    max_cube_map_texture_size: int
+    max_array_texture_layers: int
+    max_rectangle_texture_size: int
+    max_texture_buffer_size: int
+    max_renderbuffer_size: int
+    max_texture_lod_bias: float
+    max_texture_max_anisotropy: float
+    max_samples: int
+    max_integer_samples: int
+    max_color_texture_samples: int
+    max_depth_texture_samples: int
+    max_color_attachments: int
+    max_draw_buffers: int
+    max_dual_source_draw_buffers: int
+    max_viewport_dims: Tuple[int, int]
+    point_size_range: Tuple[float, float]
+    aliased_line_width_range: Tuple[float, float]
+    max_vertex_attribs: int
+    max_elements_vertices: int
+    max_elements_indices: int
+    max_texture_image_units: int
+    max_vertex_texture_image_units: int
+    max_combined_texture_image_units: int
+    max_vertex_uniform_components: int
+    max_fragment_uniform_components: int
+    max_varying_components: int
+    max_geometry_output_vertices: int
+    max_clip_distances: int
+    max_uniform_buffer_bindings: int
+    max_uniform_block_size: int
+    uniform_buffer_offset_alignment: int
+    max_server_wait_timeout: int
+    max_label_length: int
+    max_debug_message_length: int
+    max_debug_group_stack_depth: int
+    max_patch_vertices: int
+    max_tess_gen_level: int
+    max_transform_feedback_buffers: int
+    max_viewports: int
+    min_map_buffer_alignment: int
+    max_atomic_counter_buffer_bindings: int
+    max_image_units: int
+    max_shader_storage_buffer_bindings: int
+    max_shader_storage_block_size: int
+    shader_storage_buffer_offset_alignment: int
+    max_compute_work_group_count: Tuple[int, int, int]
+    max_compute_work_group_size: Tuple[int, int, int]
+    max_compute_work_group_invocations: int
+    max_compute_shared_memory_size: int
+    max_vertex_attrib_bindings: int
+    max_vertex_attrib_relative_offset: int
+    max_element_index: int
+    max_framebuffer_width: int
+    max_framebuffer_height: int
+    max_framebuffer_layers: int
+    max_framebuffer_samples: int
+    max_uniform_locations: int
+
 class Context:
     """
     Class exposing OpenGL features.
@@ -1066,6 +1376,8 @@ class Context:
     Moderngl objects scheduled for deletion.
 
     These are deleted when calling :py:meth:`Context.gc`.
+    Dead objects are queued natively in ``'context_gc'`` mode, this deque
+    stays empty unless objects are appended by hand.
     """
 
     def gc(self) -> int:
@@ -1074,12 +1386,14 @@ class Context:
 
         This method must be called to garbage collect
         OpenGL resources when ``gc_mode`` is ``'context_gc'```.
+        Buffers, textures, renderbuffers, samplers, vertex arrays and framebuffers
+        are deleted with one ``glDelete*`` call per type.
 
         Calling this method with any other ``gc_mode`` configuration
         has no effect and is perfectly safe.
 
         Returns:
-            int: Number of objects deleted
+            int: Number of objects deleted, objects already released are not counted
         """
     line_width: float
     """
@@ -1545,6 +1859,18 @@ class Context:
         }
     """
 
+    limits: Limits
+    """
+    Limits: The implementation limits of the context as an immutable mapping with typed attributes.
+
+    Example::
+
+        >> ctx.limits.max_texture_size
+        16384
+        >> ctx.limits['max_shader_storage_block_size']
+        134217728
+    """
+
     includes: Dict[str, str]
     """Mapping used for include statements."""
 
@@ -1715,6 +2041,18 @@ class Context:
             read_offset (int): The read offset.
             write_offset (int): The write offset.
         """
+    def copy_buffers(self, copies: Iterable[Tuple[Buffer, Buffer, int, int, int]]) -> None:
+        """
+        Copy many buffer ranges in a single call.
+
+        Every item is a ``(dst, src, size, read_offset, write_offset)`` tuple with the
+        meaning of the :py:meth:`copy_buffer` arguments, the trailing items may be omitted.
+        All the copies are validated before the first one is issued.
+        Uses ``glCopyNamedBufferSubData`` when direct state access is available.
+
+        Args:
+            copies (list): The copies.
+        """
     def copy_framebuffer(self, dst: Union[Framebuffer, Texture], src: Framebuffer) -> None:
         """
         Copy framebuffer content.
@@ -1770,6 +2108,39 @@ class Context:
             reserve (int): The number of bytes to reserve.
             dynamic (bool): Treat buffer as dynamic.
 
+        Returns:
+            :py:class:`Buffer` object
+        """
+    def buffer_arena(self, capacity: Union[int, str], alignment: int = 256, dynamic: bool = False) -> BufferArena:
+        """
+        Create a :py:class:`BufferArena` sub-allocating :py:class:`BufferSlice` objects
+        from a single buffer.
+
+        Many small meshes sharing one buffer object avoid switching buffers
+        between draw calls.
+
+        Args:
+            capacity (int): The size of the arena in bytes.
+
+        Keyword Args:
+            alignment (int): The alignment of the slice offsets in bytes.
+                             Use at least ``GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT``
+                             for slices bound as storage buffers.
+            dynamic (bool): Treat the buffer as dynamic.
+
+        Returns:
+            :py:class:`BufferArena` object
+        """
+    def sparse_buffer(self, size: Union[int, str]) -> Buffer:
+        """
+        Create a sparse :py:class:`Buffer` object.
+
+        Only the address space is reserved, physical memory is committed
+        page by page with :py:meth:`Buffer.commit`. Requires ``GL_ARB_sparse_buffer``.
+
+        Args:
+            size (int): The size in bytes, rounded up to a whole number of pages.
+
         Returns:
             :py:class:`Buffer` object
         """
@@ -1870,6 +2241,54 @@ class Context:
             alignment (int): The byte alignment 1, 2, 4 or 8.
             dtype (str): Data type.
 
+        Returns:
+            :py:class:`Texture3D` object
+        """
+    def sparse_texture(
+        self,
+        size: Tuple[int, int],
+        components: int,
+        dtype: str = "f1",
+        levels: int = 1,
+    ) -> Texture:
+        """
+        Create a sparse :py:class:`Texture` object.
+
+        No physical memory is committed initially, use :py:meth:`Texture.commit`.
+        Requires ``GL_ARB_sparse_texture``.
+
+        Args:
+            size (tuple): The width and height of the texture.
+            components (int): The number of components 1, 2, 3 or 4.
+
+        Keyword Args:
+            dtype (str): Data type.
+            levels (int): The number of mipmap levels.
+
+        Returns:
+            :py:class:`Texture` object
+        """
+    def sparse_texture3d(
+        self,
+        size: Tuple[int, int, int],
+        components: int,
+        dtype: str = "f1",
+        levels: int = 1,
+    ) -> Texture3D:
+        """
+        Create a sparse :py:class:`Texture3D` object.
+
+        No physical memory is committed initially, use :py:meth:`Texture3D.commit`.
+        Requires ``GL_ARB_sparse_texture``.
+
+        Args:
+            size (tuple): The width, height and depth of the texture.
+            components (int): The number of components 1, 2, 3 or 4.
+
+        Keyword Args:
+            dtype (str): Data type.
+            levels (int): The number of mipmap levels.
+
         Returns:
             :py:class:`Texture3D` object
         """
@@ -2086,6 +2505,7 @@ class Context:
         any_samples: bool = False,
         time: bool = False,
         primitives: bool = False,
+        statistics: bool = False,
     ) -> "Query":
         """
         Create a :py:class:`Query` object.
@@ -2095,6 +2515,41 @@ class Context:
             any_samples (bool): Query ``GL_ANY_SAMPLES_PASSED`` or not.
             time (bool): Query ``GL_TIME_ELAPSED`` or not.
             primitives (bool): Query ``GL_PRIMITIVES_GENERATED`` or not.
+            statistics (bool): Query the ``GL_ARB_pipeline_statistics_query`` counters or not.
+        """
+    def occlusion_culler(self, max_objects: int) -> OcclusionCuller:
+        """
+        Create an :py:class:`OcclusionCuller` object.
+
+        Args:
+            max_objects (int): The number of pooled queries.
+
+        Returns:
+            :py:class:`OcclusionCuller` object
+        """
+    def create_upload_worker(self, **settings: Any) -> UploadWorker:
+        """
+        Create an :py:class:`UploadWorker` object.
+
+        The worker creates a context sharing objects with this one,
+        the settings should select the same backend as this context.
+
+        Keyword Args:
+            settings: Arguments for :py:func:`create_context`.
+
+        Returns:
+            :py:class:`UploadWorker` object
+        """
+    def gpu_profiler(self, history: int = 120, debug_scopes: bool = True) -> GPUProfiler:
+        """
+        Create a :py:class:`GPUProfiler` object.
+
+        Args:
+            history (int): The number of collected frames to keep.
+            debug_scopes (bool): Wrap the zones in :py:meth:`Context.debug_scope`.
+
+        Returns:
+            :py:class:`GPUProfiler` object
         """
     def scope(
         self,
@@ -2205,6 +2660,28 @@ class Context:
         Returns:
             :py:class:`Renderbuffer` object
         """
+    def tiled_renderer(
+        self,
+        size: Tuple[int, int],
+        tile: Tuple[int, int] = (1024, 1024),
+        components: int = 4,
+        dtype: str = "f1",
+    ) -> "TiledRenderer":
+        """
+        Create a :py:class:`TiledRenderer` for output images larger than a single framebuffer.
+
+        The image is rendered tile by tile into a framebuffer of the tile size
+        and assembled into a file on disk.
+
+        Args:
+            size (tuple): The width and height of the output image.
+            tile (tuple): The width and height of a single tile.
+            components (int): The number of components 1, 2, 3 or 4.
+            dtype (str): Data type.
+
+        Returns:
+            :py:class:`TiledRenderer` object
+        """
     def compute_shader(self, source: str | bytes | ConvertibleToShaderSource) -> "ComputeShader":
         """
         A :py:class:`ComputeShader` is a Shader Stage that is used entirely \
@@ -2352,6 +2829,61 @@ class Context:
             then you most likely won't need this method.
         """
 
+    def enable_gl_stats(self, trace: int = 0) -> None:
+        """
+        Replace the GL dispatch table of the context with an instrumented one.
+
+        Every GL call issued by moderngl is counted and timed on the CPU.
+        Only one context can be instrumented at a time.
+
+        Keyword Args:
+            trace (int): The size of the ring buffer logging the most recent calls.
+        """
+    def disable_gl_stats(self) -> None:
+        """Restore the original GL dispatch table."""
+    def gl_stats(self) -> Dict[str, Tuple[int, int]]:
+        """
+        Get the GL call counters.
+
+        Returns:
+            dict: The number of calls and the CPU time in nanoseconds keyed by GL function name.
+        """
+    def gl_trace(self) -> List[Tuple[str, int, int]]:
+        """
+        Get the logged GL calls.
+
+        Returns:
+            list: ``(name, start, duration)`` tuples in nanoseconds, oldest first.
+        """
+    def reset_gl_stats(self) -> None:
+        """Reset the GL call counters and the trace."""
+    def memory_stats(self, reset_peak: bool = False) -> Dict[str, Any]:
+        """
+        Get the memory allocated by the buffers, textures and renderbuffers of the context.
+
+        Sizes are computed from the dimensions, format, samples and mip chain of the objects.
+        External and sparse objects are not counted.
+
+        Keyword Args:
+            reset_peak (bool): Reset the peaks to the current totals after reading them.
+
+        Returns:
+            dict: ``count``, ``total`` and ``peak`` bytes per object type, the overall
+            ``total`` and ``peak``, the bytes per object ``label`` and the ``gpu``
+            memory reported by ``GL_NVX_gpu_memory_info`` or ``GL_ATI_meminfo`` or None.
+        """
+    def capture(self, path: Union[str, os.PathLike]) -> AbstractContextManager["Context"]:
+        """
+        Record every GL call issued inside the ``with`` block to a file.
+
+        The arguments and the uploaded client memory are stored in a compact
+        binary format that :py:func:`moderngl.replay` executes against a fresh context.
+        Start the capture before creating the objects it uses.
+        Data written through persistently mapped buffers is not recorded.
+
+        Args:
+            path (str): The capture file.
+        """
     def debug_scope(
         self,
         label: str,
@@ -2403,7 +2935,14 @@ def create_context(
         # Create a headless context requiring OpenGL 4.3
         ctx = moderngl.create_context(require=430, standalone=True)
 
-    Keyword Arguments:
+        # Create a context without a GPU for measuring the CPU overhead
+        ctx = moderngl.create_context(standalone=True, backend="null")
+
+    The ``null`` backend stubs every GL function, nothing is rendered
+    and buffer contents are not stored. Programs report the uniforms
+    and vertex shader inputs declared in their source.
+
+    Keyword Arguments:
         require (int): OpenGL version code (default: 330)
         standalone (bool): Headless flag
         share (bool): Attempt to create a shared context
@@ -2440,6 +2979,25 @@ def create_standalone_context(
         :py:class:`Context` object
     """
 
+def replay(path: Union[str, os.PathLike], ctx: Optional["Context"] = None, require: Optional[int] = None, **settings: Any) -> Tuple[int, int]:
+    """
+    Execute the GL calls recorded by :py:meth:`Context.capture` as fast as possible.
+
+    A new standalone context is created and released when ``ctx`` is not set.
+    The object names generated by the replay are checked against the captured ones.
+
+    Args:
+        path (str): The capture file.
+
+    Keyword Args:
+        ctx (Context): The context to replay into.
+        require (int): OpenGL version code of the new context.
+        settings: Keyword arguments of :py:func:`create_context` for the new context, like ``backend``.
+
+    Returns:
+        tuple: The number of calls and the elapsed time in nanoseconds.
+    """
+
 def init_context(loader=None) -> None:
     """
         Initialize the default moderngl context
@@ -2676,9 +3234,309 @@ class Framebuffer:
             dtype (str): Data type.
             write_offset (int): The write offset.
         """
+    def resolve(self, attachment: int = 0) -> Texture:
+        """
+        Resolve a (multisample) attachment into a single-sample texture.
+
+        The resolve target is created on first use with the size, components and dtype
+        of the attachment and is reused by later calls. Only the requested attachment is blitted.
+        The returned texture is owned by the framebuffer and released with it,
+        a target released by the caller is replaced on the next call.
+
+        .. code:: python
+
+            fbo = ctx.simple_framebuffer((512, 512), samples=4)
+            ...
+            texture = fbo.resolve()
+            texture.use(0)
+
+        Args:
+            attachment (int): The color attachment number. -1 for the depth attachment
+
+        Returns:
+            :py:class:`Texture` object
+        """
+    def read_resolved(
+        self,
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        components: int = 3,
+        attachment: int = 0,
+        alignment: int = 1,
+        dtype: str = "f1",
+        clamp: bool = False,
+    ) -> bytes:
+        """
+        Resolve an attachment and read its pixels from the resolve target.
+
+        Works like :py:meth:`Framebuffer.read` for multisample framebuffers.
+
+        Args:
+            viewport (tuple): The viewport.
+            components (int): The number of components to read.
+
+        Keyword Args:
+            attachment (int): The color attachment number. -1 for the depth attachment
+            alignment (int): The byte alignment of the pixels.
+            dtype (str): Data type.
+            clamp (bool): Clamps floating point values to ``[0.0, 1.0]``
+
+        Returns:
+            bytes
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
 
+class GPUZone:
+    """
+    A timed zone of a :py:class:`GPUProfiler` frame.
+
+    The timestamps are in nanoseconds and are ``None`` until the frame is collected.
+    """
+
+    name: str
+    """The name of the zone."""
+
+    depth: int
+    """The nesting depth. The frame itself has depth ``0``."""
+
+    start: Optional[int]
+    """The GPU timestamp at the beginning of the zone."""
+
+    end: Optional[int]
+    """The GPU timestamp at the end of the zone."""
+
+    duration: Optional[int]
+    """The GPU time spent in the zone in nanoseconds."""
+
+    children: List[GPUZone]
+    """The nested zones."""
+
+    def walk(self) -> Generator[GPUZone, None, None]:
+        """Iterate the zone and all nested zones depth first."""
+    def as_dict(self) -> Dict[str, Any]:
+        """Return the zone tree as nested dictionaries."""
+
+class GPUProfiler:
+    """
+    Hierarchical GPU timer built on timestamp queries.
+
+    Every zone issues a pair of ``glQueryCounter(GL_TIMESTAMP)`` calls using queries
+    from a recycled pool. The results are collected without stalling the pipeline
+    once the GPU has finished the frame, usually a few frames later.
+    Create a :py:class:`GPUProfiler` using :py:meth:`Context.gpu_profiler`.
+
+    .. code:: python
+
+        prof = ctx.gpu_profiler()
+
+        with prof.frame():
+            with prof.zone('shadow'):
+                shadow_pass()
+            with prof.zone('lighting'):
+                lighting_pass()
+
+        for frame in prof.frames:
+            print(frame.as_dict())
+
+        prof.save_chrome_trace('trace.json')
+    """
+
+    ctx: Context
+    """The context this object belongs to."""
+
+    frames: Deque[GPUZone]
+    """The collected frames, oldest first."""
+
+    debug_scopes: bool
+    """Are the zones wrapped in debug scopes?"""
+
+    pending: int
+    """The number of frames waiting for their results."""
+
+    def begin_frame(self, name: str = "frame") -> None:
+        """
+        Start a frame.
+
+        Keyword Args:
+            name (str): The name of the root zone.
+        """
+    def end_frame(self) -> List[GPUZone]:
+        """
+        End the frame and collect the finished frames.
+
+        Returns:
+            list: The newly collected frames.
+        """
+    def frame(self, name: str = "frame") -> AbstractContextManager[GPUProfiler]:
+        """
+        Context manager calling :py:meth:`begin_frame` and :py:meth:`end_frame`.
+
+        Keyword Args:
+            name (str): The name of the root zone.
+        """
+    def zone(self, name: str) -> AbstractContextManager[GPUZone]:
+        """
+        Context manager timing the commands issued inside it.
+
+        Zones can be nested and must be inside a frame.
+        The zone is also a debug scope with the same label when :py:attr:`debug_scopes` is set.
+
+        Args:
+            name (str): The name of the zone.
+        """
+    def collect(self) -> List[GPUZone]:
+        """
+        Collect the finished frames without blocking.
+
+        Returns:
+            list: The newly collected frames.
+        """
+    def chrome_trace(self, frames: Optional[List[GPUZone]] = None) -> Dict[str, Any]:
+        """
+        Export the frames in the Chrome trace event format.
+
+        Keyword Args:
+            frames (list): The frames to export. Defaults to :py:attr:`frames`.
+        """
+    def save_chrome_trace(self, path: str, frames: Optional[List[GPUZone]] = None) -> None:
+        """
+        Write :py:meth:`chrome_trace` to a json file.
+
+        Args:
+            path (str): The output file.
+
+        Keyword Args:
+            frames (list): The frames to export. Defaults to :py:attr:`frames`.
+        """
+    def release(self) -> None:
+        """Delete the query objects of the profiler."""
+
+class OcclusionCuller:
+    """
+    Pooled ``GL_ANY_SAMPLES_PASSED_CONSERVATIVE`` queries testing bounding boxes.
+
+    The bounding boxes are read from a buffer of ``count`` x ``6`` floats
+    (``min_x, min_y, min_z, max_x, max_y, max_z``) and rasterized against the
+    current depth buffer without writing color or depth.
+    The results are collected without blocking, visibility lags a frame or more behind.
+    """
+
+    max_objects: int
+    """The number of queries in the pool."""
+
+    visible: bytes
+    """The visibility bitset, bit ``i % 8`` of byte ``i // 8`` is set for visible objects."""
+
+    mglo: Any
+    """Internal representation for debug purposes only."""
+
+    ctx: "Context"
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def test(self, aabbs: Buffer, mvp: Any, count: Optional[int] = None) -> int:
+        """
+        Render the bounding box proxies, one draw and one query per object.
+
+        Objects with a query still in flight are skipped and keep their last visibility.
+
+        Args:
+            aabbs (Buffer): The bounding boxes.
+            mvp (bytes): The model-view-projection matrix, 16 floats in column-major order.
+
+        Keyword Args:
+            count (int): The number of objects. Defaults to the size of the buffer.
+
+        Returns:
+            int: The number of queries issued.
+        """
+    def collect(self) -> bytes:
+        """
+        Read the available results without blocking.
+
+        Returns:
+            bytes: The visibility bitset.
+        """
+    def is_visible(self, index: int) -> bool:
+        """
+        Was the object visible when its last query completed?
+
+        Objects never tested are visible.
+        """
+    def conditional(self, index: int) -> AbstractContextManager["OcclusionCuller"]:
+        """
+        Render conditionally on the query of an object.
+
+        The draw calls are discarded by the GPU when the object was occluded.
+        Queries still in flight do not stall, the draw calls are executed.
+        """
+    def release(self) -> None:
+        """Delete the queries and the proxy program."""
+
+class UploadJob:
+    """
+    An upload submitted to an :py:class:`UploadWorker`.
+    """
+
+    ctx: "Context"
+    """The context receiving the created objects"""
+
+    def done(self) -> bool:
+        """Has the worker finished the job?"""
+    def result(self, timeout: Optional[float] = None) -> Any:
+        """
+        Wait for the job and return the created objects.
+
+        The context waits on the fence of the worker before the objects are used,
+        then the objects are moved to the context.
+
+        Keyword Args:
+            timeout (float): Seconds to wait for the worker. Waits forever by default.
+
+        Returns:
+            The value returned by the job.
+        """
+
+class UploadWorker:
+    """
+    A background thread owning a context shared with the main one.
+
+    Buffers, textures and programs are created off-thread,
+    large uploads run without holding the GIL.
+    """
+
+    ctx: "Context"
+    """The context receiving the created objects"""
+
+    def submit(self, func: Any) -> UploadJob:
+        """
+        Run a function on the worker thread.
+
+        The function receives the shared context and returns the created object or a list of objects.
+
+        Args:
+            func (callable): The job.
+
+        Returns:
+            :py:class:`UploadJob` object
+        """
+    def buffer(self, data: Optional[Any] = None, reserve: Union[int, str] = 0, dynamic: bool = False) -> UploadJob:
+        """Create a :py:class:`Buffer` on the worker thread."""
+    def texture(
+        self,
+        size: Tuple[int, int],
+        components: int,
+        data: Optional[Any] = None,
+        **kwargs: Any,
+    ) -> UploadJob:
+        """Create a :py:class:`Texture` on the worker thread."""
+    def program(self, **kwargs: Any) -> UploadJob:
+        """Create a :py:class:`Program` on the worker thread."""
+    def release(self) -> None:
+        """Finish the submitted jobs, stop the thread and release the shared context."""
+
 class Program:
     """
     A Program object represents fully processed executable code in the OpenGL Shading Language, \
@@ -2900,6 +3758,18 @@ class Query:
     elapsed: int
     """The time elapsed in nanoseconds."""
 
+    statistics: Dict[str, int]
+    """
+    The pipeline statistics counters: ``vertices_submitted``, ``primitives_submitted``,
+    ``vertex_shader_invocations``, ``tess_control_shader_patches``,
+    ``tess_evaluation_shader_invocations``, ``geometry_shader_invocations``,
+    ``geometry_shader_primitives_emitted``, ``fragment_shader_invocations``,
+    ``compute_shader_invocations``, ``clipping_input_primitives`` and ``clipping_output_primitives``.
+    """
+
+    available: bool
+    """Are the results available without waiting for the GPU?"""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -2911,6 +3781,32 @@ class Query:
 
     def __enter__(self): ...
     def __exit__(self, *args: Tuple[Any]): ...
+    def try_get(self) -> Optional[Dict[str, int]]:
+        """
+        Get the results without blocking.
+
+        Returns:
+            dict: The results keyed by ``samples``, ``any_samples``, ``elapsed``,
+            ``primitives`` and ``statistics`` for the enabled queries, or ``None`` when
+            the results are not available yet.
+        """
+    def write_to(self, buffer: Buffer, offset: int = 0, result: str = "samples", wide: bool = False) -> None:
+        """
+        Write a result into a buffer using ``GL_QUERY_BUFFER``.
+
+        The GPU writes the result once it is available, the CPU does not wait.
+        The buffer can be consumed by compute shaders or indirect draws.
+        The query must have run at least once.
+        Requires OpenGL 4.4 or ``GL_ARB_query_buffer_object``.
+
+        Args:
+            buffer (Buffer): The destination buffer.
+
+        Keyword Args:
+            offset (int): The offset in bytes. Must be aligned to the result size.
+            result (str): ``samples``, ``any_samples``, ``elapsed`` or ``primitives``.
+            wide (bool): Write a 64-bit result instead of a 32-bit one.
+        """
 
 class Renderbuffer:
     """
@@ -3302,6 +4198,9 @@ class Texture3D:
     dtype: str
     """Data type."""
 
+    page_size: Optional[Tuple[int, int, int]]
+    """The virtual page size of a sparse texture. ``None`` for regular textures."""
+
     mglo: Any
     """Internal representation for debug purposes only."""
 
@@ -3503,6 +4402,29 @@ class Texture3D:
         Keyword Args:
             resident (bool): Make the texture resident.
         """
+    def commit(self, viewport: Optional[Tuple[int, int, int, int, int, int]] = None, level: int = 0) -> None:
+        """
+        Commit physical memory for a region of a sparse texture.
+
+        The region must be aligned to :py:attr:`page_size` unless it reaches
+        the edge of the mipmap level.
+
+        Args:
+            viewport (tuple): The region (x, y, z, width, height, depth). Value ``None`` means the whole level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def decommit(self, viewport: Optional[Tuple[int, int, int, int, int, int]] = None, level: int = 0) -> None:
+        """
+        Release the physical memory of a region of a sparse texture.
+
+        Args:
+            viewport (tuple): The region (x, y, z, width, height, depth). Value ``None`` means the whole level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
 
@@ -4318,6 +5240,9 @@ class Texture:
     dtype: str
     """Data type."""
 
+    page_size: Optional[Tuple[int, int, int]]
+    """The virtual page size of a sparse texture. ``None`` for regular textures."""
+
     depth: bool
     """Is the texture a depth texture?."""
 
@@ -4429,6 +5354,32 @@ class Texture:
             level (int): The mipmap level.
             alignment (int): The byte alignment of the pixels.
         """
+    def write_from_file(
+        self,
+        path: Union[str, os.PathLike],
+        viewport: Optional[Union[Tuple[int, int], Tuple[int, int, int, int]]] = None,
+        level: int = 0,
+        alignment: int = 1,
+        file_offset: int = 0,
+        chunk: int = 4 * 1024 * 1024,
+    ) -> None:
+        """
+        Update the content of the texture from a file.
+
+        The pixels are uploaded in bands of whole rows through the staging
+        buffer of the context. The file must contain the pixels of the viewport
+        in the same layout :py:meth:`write` expects.
+
+        Args:
+            path (str): The path of the file.
+            viewport (tuple): The sub-section of the texture to update.
+
+        Keyword Args:
+            level (int): The mipmap level.
+            alignment (int): The byte alignment of the pixels.
+            file_offset (int): The offset in bytes in the file.
+            chunk (int): The size of the row bands in bytes.
+        """
     def build_mipmaps(self, base: int = 0, max_level: int = 1000) -> None:
         """
         Generate mipmaps.
@@ -4535,6 +5486,129 @@ class Texture:
         Keyword Args:
             resident (bool): Make the texture resident.
         """
+    def commit(self, viewport: Optional[Tuple[int, int, int, int]] = None, level: int = 0) -> None:
+        """
+        Commit physical memory for a region of a sparse texture.
+
+        The region must be aligned to :py:attr:`page_size` unless it reaches
+        the edge of the mipmap level.
+
+        Args:
+            viewport (tuple): The region (x, y, width, height). Value ``None`` means the whole level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def decommit(self, viewport: Optional[Tuple[int, int, int, int]] = None, level: int = 0) -> None:
+        """
+        Release the physical memory of a region of a sparse texture.
+
+        Args:
+            viewport (tuple): The region (x, y, width, height). Value ``None`` means the whole level.
+
+        Keyword Args:
+            level (int): The mipmap level.
+        """
+    def release(self) -> None:
+        """Release the ModernGL object."""
+
+class Tile:
+    """
+    A single tile of a :py:class:`TiledRenderer`.
+    """
+
+    x: int
+    """The x offset of the tile in the output image."""
+
+    y: int
+    """The y offset of the tile in the output image."""
+
+    width: int
+    """The width of the tile."""
+
+    height: int
+    """The height of the tile."""
+
+    size: Tuple[int, int]
+    """The size of the output image."""
+
+    viewport: Tuple[int, int, int, int]
+    """The area of the output image covered by the tile."""
+
+    scale: Tuple[float, float]
+    """
+    The scale to apply to normalized device coordinates to render the tile.
+
+    ``tile_ndc = ndc * scale + offset``
+    """
+
+    offset: Tuple[float, float]
+    """The offset to apply to normalized device coordinates to render the tile."""
+
+    matrix: Tuple[float, ...]
+    """
+    A column major 4x4 matrix applying :py:attr:`scale` and :py:attr:`offset` in clip space.
+
+    Multiply the projection matrix with it from the left to render the tile.
+    """
+
+class TiledRenderer:
+    """
+    Renders images larger than the maximum framebuffer size tile by tile.
+
+    Each tile is read back through alternating pixel buffers while the next tile is rendered
+    and is written into a memory-mapped file, so the memory usage is bounded by the tile size.
+    Create a :py:class:`TiledRenderer` using :py:meth:`Context.tiled_renderer`.
+
+    .. code:: python
+
+        renderer = ctx.tiled_renderer((32768, 32768), tile=(4096, 4096))
+
+        def render_tile(tile):
+            ctx.clear()
+            prog['projection'].write(crop(tile.matrix) @ projection)
+            vao.render()
+
+        renderer.render('poster.raw', render_tile)
+    """
+
+    framebuffer: Framebuffer
+    """The framebuffer the tiles are rendered into."""
+
+    size: Tuple[int, int]
+    """The size of the output image."""
+
+    tile: Tuple[int, int]
+    """The size of a single tile."""
+
+    components: int
+    """The number of components."""
+
+    dtype: str
+    """Data type."""
+
+    ctx: "Context"
+    """The context this object belongs to"""
+
+    extra: Any
+    """Attribute for storing user defined objects"""
+
+    def tiles(self) -> Generator[Tile, None, None]:
+        """
+        Iterate the tiles of the output image row by row starting from the lower left corner.
+        """
+    def render(self, path: Any, callback: Any) -> None:
+        """
+        Render all tiles and write the output image to a file.
+
+        The tile framebuffer is bound and its viewport is set before the callback
+        is called with the :py:class:`Tile`. The file contains tightly packed rows
+        starting from the bottom row, like the output of :py:meth:`Framebuffer.read`.
+
+        Args:
+            path (str): The output file.
+            callback (callable): Renders a single tile.
+        """
     def release(self) -> None:
         """Release the ModernGL object."""
 
@@ -4574,7 +5648,7 @@ class VertexArray:
     The program used when rendering or transforming primitives.
     """
 
-    index_buffer: Buffer
+    index_buffer: Union[Buffer, BufferSlice]
     """Index buffer"""
 
     index_element_size: int
@@ -4645,6 +5719,8 @@ class VertexArray:
         The render primitive (mode) must be the same as the input primitive of the GeometryShader.
 
         The draw commands are 5 integers: (count, instanceCount, firstIndex, baseVertex, baseInstance).
+        When the index buffer is a :py:class:`BufferSlice` the firstIndex counts from the start
+        of the underlying buffer, add ``slice.offset // index_element_size`` to it.
 
         Args:
             buffer (Buffer): Indirect drawing commands.
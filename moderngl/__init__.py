@@ -1,5 +1,11 @@
+import bisect
+import queue
+import struct
+import sys
+import threading
 import warnings
 from collections import deque
+from collections.abc import Mapping
 from contextlib import contextmanager
 
 from _moderngl import (
@@ -35,6 +41,18 @@ class _store:
     default_context = None
 
 
+def _bind_native_methods(obj):
+    # The hot methods of the native object are set on the instance, the calls skip the Python wrapper.
+    # The native methods take the same arguments and defaults as the wrappers on the class
+    for name in obj._native_methods:
+        setattr(obj, name, getattr(obj.mglo, name))
+
+
+def _unbind_native_methods(obj):
+    for name in obj._native_methods:
+        obj.__dict__.pop(name, None)
+
+
 # OpenGL Object type constants
 _BUFFER = 0x82E0
 _PROGRAM = 0x82E2
@@ -45,12 +63,33 @@ _VERTEX_ARRAY = 0x8074
 _FRAMEBUFFER = 0x8D40
 _RENDERBUFFER = 0x8D41
 
+# Buffer view dtypes to PEP 3118 formats, other formats are passed as they are
+_VIEW_FORMATS = {
+    "u1": "B",
+    "u2": "H",
+    "u4": "I",
+    "u8": "Q",
+    "i1": "b",
+    "i2": "h",
+    "i4": "i",
+    "i8": "q",
+    "f2": "e",
+    "f4": "f",
+    "f8": "d",
+}
+
+# The mapped memory holds the values in the byte order of the host
+_VIEW_BYTE_ORDERS = {"<": "little", ">": "big", "!": "big"}
+
 
 class Buffer:
+    _native_methods = ("write", "read")
+
     def __init__(self):
         self.mglo = None
         self._size = None
         self._dynamic = None
+        self._page_size = None
         self._glo = None
         self.ctx = None
         self.extra = None
@@ -64,7 +103,7 @@ class Buffer:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def size(self):
@@ -74,6 +113,10 @@ class Buffer:
     def dynamic(self):
         return self._dynamic
 
+    @property
+    def page_size(self):
+        return self._page_size
+
     @property
     def glo(self):
         return self._glo
@@ -100,6 +143,9 @@ class Buffer:
     def write(self, data, offset=0):
         self.mglo.write(data, offset)
 
+    def write_from_file(self, path, offset=0, size=-1, file_offset=0, chunk=4 * 1024 * 1024):
+        self.mglo.write_from_file(path, offset, size, file_offset, chunk)
+
     def write_chunks(self, data, start, step, count):
         self.mglo.write_chunks(data, start, step, count)
 
@@ -113,7 +159,13 @@ class Buffer:
         return self.mglo.read_chunks(chunk_size, start, step, count)
 
     def read_chunks_into(self, buffer, chunk_size, start, step, count, write_offset=0):
-        return self.mglo.read(buffer, chunk_size, start, step, count, write_offset)
+        return self.mglo.read_chunks_into(buffer, chunk_size, start, step, count, write_offset)
+
+    def scatter(self, src, start, step, count, chunk_size, offset=0):
+        self.mglo.scatter(src.mglo, start, step, count, chunk_size, offset)
+
+    def gather(self, dst, start, step, count, chunk_size, offset=0):
+        self.mglo.gather(dst.mglo, start, step, count, chunk_size, offset)
 
     def clear(self, size=-1, offset=0, chunk=None):
         self.mglo.clear(size, offset, chunk)
@@ -127,10 +179,42 @@ class Buffer:
     def orphan(self, size=-1):
         self.mglo.orphan(size)
 
+    def view(self, dtype="u1", shape=None, offset=0, access="rw"):
+        # Numpy dtypes are accepted by their type string, only the native byte order can be viewed
+        dtype = getattr(dtype, "str", dtype)
+        if _VIEW_BYTE_ORDERS.get(dtype[:1], sys.byteorder) != sys.byteorder:
+            raise Error("the view must use the native byte order, %s is %s endian" % (dtype, _VIEW_BYTE_ORDERS[dtype[:1]]))
+        dtype = dtype.lstrip("<>!|=@")
+        fmt = _VIEW_FORMATS.get(dtype, dtype)
+        itemsize = struct.calcsize(fmt)
+
+        if shape is None:
+            shape = ((self.size - offset) // itemsize,)
+        elif isinstance(shape, int):
+            shape = (shape,)
+
+        return memoryview(self.mglo.view(fmt, itemsize, tuple(shape), offset, access))
+
+    def commit(self, offset=0, size=-1):
+        self._check_pages(offset, size)
+        self.mglo.commit(offset, size, True)
+
+    def decommit(self, offset=0, size=-1):
+        self._check_pages(offset, size)
+        self.mglo.commit(offset, size, False)
+
+    def _check_pages(self, offset, size):
+        if self._page_size is None:
+            raise Error("the buffer is not sparse")
+        if size < 0:
+            size = self._size - offset
+        _check_sparse_region((self._page_size,), (offset,), (size,), (self._size,))
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
     def bind(self, *attribs, layout=None):
         return (self, layout, *attribs)
@@ -139,6 +223,156 @@ class Buffer:
         return (self, index)
 
 
+class BufferSlice:
+    def __init__(self, arena, offset, size):
+        self.arena = arena
+        self.offset = offset
+        self.size = size
+        self.extra = None
+
+    def __repr__(self):
+        return f"<BufferSlice: {self.offset}, {self.size}>"
+
+    @property
+    def buffer(self):
+        return self.arena.buffer
+
+    @property
+    def _range(self):
+        return (self.arena.buffer.mglo, self.offset, self.size)
+
+    def write(self, data, offset=0):
+        if offset + len(memoryview(data).cast("B")) > self.size:
+            raise Error("data does not fit in the slice")
+        self.arena.buffer.write(data, self.offset + offset)
+
+    def read(self, size=-1, offset=0):
+        if size < 0:
+            size = self.size - offset
+        if offset < 0 or offset + size > self.size:
+            raise Error("out of range offset or size")
+        return self.arena.buffer.read(size, self.offset + offset)
+
+    def bind(self, *attribs, layout=None):
+        return (self, layout, *attribs)
+
+    def bind_to_uniform_block(self, binding=0):
+        self.arena.buffer.bind_to_uniform_block(binding, self.offset, self.size)
+
+    def bind_to_storage_buffer(self, binding=0):
+        self.arena.buffer.bind_to_storage_buffer(binding, self.offset, self.size)
+
+    def release(self):
+        if self.arena is not None:
+            self.arena.free(self)
+
+
+class BufferArena:
+    def __init__(self):
+        self.ctx = None
+        self.buffer = None
+        self._alignment = None
+        self._free = None
+        self._slices = None
+        self._used = None
+        self._scratch = None
+        raise TypeError()
+
+    @property
+    def capacity(self):
+        return self.buffer.size
+
+    @property
+    def alignment(self):
+        return self._alignment
+
+    @property
+    def used(self):
+        return self._used
+
+    @property
+    def largest_free_block(self):
+        return max((size for _, size in self._free), default=0)
+
+    def allocate(self, size):
+        aligned = (size + self._alignment - 1) // self._alignment * self._alignment
+        for index, (offset, free_size) in enumerate(self._free):
+            if free_size >= aligned:
+                if free_size == aligned:
+                    del self._free[index]
+                else:
+                    self._free[index] = (offset + aligned, free_size - aligned)
+                res = BufferSlice(self, offset, size)
+                self._slices[offset] = res
+                self._used += size
+                return res
+        raise Error(f"cannot allocate {size} bytes in the buffer arena")
+
+    def free(self, buffer_slice):
+        if buffer_slice.arena is not self:
+            raise Error("the slice belongs to a different arena")
+
+        del self._slices[buffer_slice.offset]
+        self._used -= buffer_slice.size
+        buffer_slice.arena = None
+
+        offset = buffer_slice.offset
+        size = (buffer_slice.size + self._alignment - 1) // self._alignment * self._alignment
+
+        # Keep the free list sorted and merge the neighbouring blocks
+        index = bisect.bisect(self._free, (offset, size))
+        if index < len(self._free) and offset + size == self._free[index][0]:
+            size += self._free.pop(index)[1]
+        if index > 0 and self._free[index - 1][0] + self._free[index - 1][1] == offset:
+            offset, prev_size = self._free.pop(index - 1)
+            size += prev_size
+            index -= 1
+        self._free.insert(index, (offset, size))
+
+    def defragment(self):
+        alignment = self._alignment
+        cursor = 0
+        moved = 0
+        slices = {}
+        for _, buffer_slice in sorted(self._slices.items()):
+            if buffer_slice.offset != cursor:
+                self._move(buffer_slice, cursor)
+                moved += 1
+            slices[cursor] = buffer_slice
+            cursor += (buffer_slice.size + alignment - 1) // alignment * alignment
+
+        self._slices = slices
+        self._free = [(cursor, self.buffer.size - cursor)] if cursor < self.buffer.size else []
+        return moved
+
+    def _move(self, buffer_slice, offset):
+        size = buffer_slice.size
+        if offset + size <= buffer_slice.offset:
+            self.ctx.copy_buffer(self.buffer, self.buffer, size, buffer_slice.offset, offset)
+        else:
+            # Overlapping ranges of the same buffer cannot be copied directly
+            if self._scratch is None or self._scratch.size < size:
+                if self._scratch is not None:
+                    self._scratch.release()
+                self._scratch = self.ctx.buffer(reserve=size)
+            self.ctx.copy_buffer(self._scratch, self.buffer, size, buffer_slice.offset, 0)
+            self.ctx.copy_buffer(self.buffer, self._scratch, size, 0, offset)
+        buffer_slice.offset = offset
+
+    def release(self):
+        if self.buffer is not None:
+            for buffer_slice in self._slices.values():
+                buffer_slice.arena = None
+            self._slices = {}
+            self._used = 0
+            self._free = []
+            self.buffer.release()
+            self.buffer = None
+            if self._scratch is not None:
+                self._scratch.release()
+                self._scratch = None
+
+
 class ConditionalRender:
     def __init__(self):
         self.mglo = None
@@ -180,8 +414,69 @@ class Query:
     def elapsed(self):
         return self.mglo.elapsed
 
+    @property
+    def statistics(self):
+        return self.mglo.statistics
+
+    @property
+    def available(self):
+        return self.mglo.available
+
+    def try_get(self):
+        return self.mglo.try_get()
+
+    def write_to(self, buffer, offset=0, result="samples", wide=False):
+        keys = ("samples", "any_samples", "elapsed", "primitives")
+        if result not in keys:
+            raise ValueError(f"result must be one of {keys}, got '{result}'")
+        self.mglo.write_to(buffer.mglo, offset, keys.index(result), wide)
+
+
+class OcclusionCuller:
+    def __init__(self):
+        self.mglo = None
+        self.ctx = None
+        self.max_objects = None
+        self.extra = None
+        raise TypeError()
+
+    def test(self, aabbs, mvp, count=None):
+        if count is None:
+            count = min(aabbs.size // 24, self.max_objects)
+        if not isinstance(mvp, (bytes, bytearray, memoryview)):
+            import struct
+
+            mvp = struct.pack("16f", *mvp)
+        return self.mglo.test(aabbs.mglo, count, mvp)
+
+    def collect(self):
+        return self.mglo.collect()
+
+    @property
+    def visible(self):
+        return self.mglo.collect()
+
+    def is_visible(self, index):
+        return self.mglo.is_visible(index)
+
+    @contextmanager
+    def conditional(self, index):
+        active = self.mglo.begin_render(index)
+        try:
+            yield self
+        finally:
+            if active:
+                self.mglo.end_render()
+
+    def release(self):
+        if self.mglo is not None:
+            self.mglo.release()
+            self.mglo = None
+
 
 class ComputeShader:
+    _native_methods = ("run",)
+
     def __init__(self):
         self.mglo = None
         self._members = {}
@@ -198,7 +493,7 @@ class ComputeShader:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     def __getitem__(self, key):
         return self._members[key]
@@ -226,6 +521,7 @@ class ComputeShader:
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
     @property
     def label(self):
@@ -257,6 +553,7 @@ class Framebuffer:
         self._glo = None
         self.ctx = None
         self._is_reference = None
+        self._resolve_targets = {}
         self.extra = None
         self._label = None
         raise TypeError()
@@ -273,7 +570,7 @@ class Framebuffer:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def viewport(self):
@@ -431,8 +728,49 @@ class Framebuffer:
             write_offset,
         )
 
+    def resolve(self, attachment=0):
+        # A cached target released by the caller is replaced
+        target = self._resolve_targets.get(attachment)
+        if target is None or isinstance(target.mglo, InvalidObject):
+            if attachment == -1:
+                target = self.ctx.depth_texture(self.size)
+            elif self._color_attachments:
+                source = self._color_attachments[attachment]
+                target = self.ctx.texture(self.size, source.components, dtype=source.dtype)
+            else:
+                target = self.ctx.texture(self.size, 4)
+
+        self.mglo.resolve(target.mglo, attachment)
+        self._resolve_targets[attachment] = target
+        return target
+
+    def read_resolved(
+        self,
+        viewport=None,
+        components=3,
+        attachment=0,
+        alignment=1,
+        dtype="f1",
+        clamp=False,
+    ):
+        self.resolve(attachment)
+        if viewport is None:
+            viewport = (0, 0, self.width, self.height)
+        if len(viewport) == 2:
+            viewport = (0, 0, *viewport)
+        res, mem = mgl.writable_bytes(
+            mgl.expected_size(viewport[2], viewport[3], 1, components, alignment, dtype)
+        )
+        self.mglo.read_into(
+            mem, viewport, components, attachment, alignment, clamp, dtype, 0, True
+        )
+        return res
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
+            for target in self._resolve_targets.values():
+                target.release()
+            self._resolve_targets = {}
             self._color_attachments = None
             self._depth_attachment = None
             self.mglo.release()
@@ -461,7 +799,7 @@ class Program:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     def __getitem__(self, key):
         return self._members[key]
@@ -554,7 +892,7 @@ class Renderbuffer:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def width(self):
@@ -630,7 +968,7 @@ class Sampler:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     def use(self, location=0):
         if self.texture is not None:
@@ -766,7 +1104,7 @@ class Scope:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
@@ -780,6 +1118,8 @@ class Scope:
 
 
 class Texture:
+    _native_methods = ("use",)
+
     def __init__(self):
         self.mglo = None
         self._size = (None, None)
@@ -787,6 +1127,7 @@ class Texture:
         self._samples = None
         self._dtype = None
         self._depth = None
+        self._page_size = None
         self._glo = None
         self.ctx = None
         self.extra = None
@@ -800,7 +1141,7 @@ class Texture:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def repeat_x(self):
@@ -916,6 +1257,9 @@ class Texture:
 
         self.mglo.write(data, viewport, level, alignment)
 
+    def write_from_file(self, path, viewport=None, level=0, alignment=1, file_offset=0, chunk=4 * 1024 * 1024):
+        self.mglo.write_from_file(path, viewport, level, alignment, file_offset, chunk)
+
     def build_mipmaps(self, base=0, max_level=1000):
         self.mglo.build_mipmaps(base, max_level)
 
@@ -928,19 +1272,42 @@ class Texture:
     def get_handle(self, resident=True):
         return self.mglo.get_handle(resident)
 
+    @property
+    def page_size(self):
+        return self._page_size
+
+    def commit(self, viewport=None, level=0):
+        self.mglo.commit(level, self._sparse_region(viewport, level), True)
+
+    def decommit(self, viewport=None, level=0):
+        self.mglo.commit(level, self._sparse_region(viewport, level), False)
+
+    def _sparse_region(self, viewport, level):
+        if self._page_size is None:
+            raise Error("the texture is not sparse")
+        level_size = tuple(max(x >> level, 1) for x in self._size)
+        if viewport is None:
+            viewport = (0, 0) + level_size
+        _check_sparse_region(self._page_size[:2], viewport[:2], viewport[2:], level_size)
+        return tuple(viewport)
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
 
 class Texture3D:
+    _native_methods = ("use",)
+
     def __init__(self):
         self.mglo = None
         self._size = (None, None, None)
         self._components = None
         self._samples = None
         self._dtype = None
+        self._page_size = None
         self._glo = None
         self.ctx = None
         self.extra = None
@@ -954,7 +1321,7 @@ class Texture3D:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def repeat_x(self):
@@ -1070,13 +1437,35 @@ class Texture3D:
     def get_handle(self, resident=True):
         return self.mglo.get_handle(resident)
 
+    @property
+    def page_size(self):
+        return self._page_size
+
+    def commit(self, viewport=None, level=0):
+        self.mglo.commit(level, self._sparse_region(viewport, level), True)
+
+    def decommit(self, viewport=None, level=0):
+        self.mglo.commit(level, self._sparse_region(viewport, level), False)
+
+    def _sparse_region(self, viewport, level):
+        if self._page_size is None:
+            raise Error("the texture is not sparse")
+        level_size = tuple(max(x >> level, 1) for x in self._size)
+        if viewport is None:
+            viewport = (0, 0, 0) + level_size
+        _check_sparse_region(self._page_size, viewport[:3], viewport[3:], level_size)
+        return tuple(viewport)
+
     def release(self):
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
 
 class TextureCube:
+    _native_methods = ("use",)
+
     def __init__(self):
         self.mglo = None
         self._size = (None, None)
@@ -1096,7 +1485,7 @@ class TextureCube:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def size(self):
@@ -1200,9 +1589,12 @@ class TextureCube:
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
 
 class TextureArray:
+    _native_methods = ("use",)
+
     def __init__(self):
         self.mglo = None
         self._size = (None, None, None)
@@ -1223,7 +1615,7 @@ class TextureArray:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def repeat_x(self):
@@ -1343,6 +1735,7 @@ class TextureArray:
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.release()
             self.mglo = InvalidObject()
+            _unbind_native_methods(self)
 
 
 class VertexArray:
@@ -1367,7 +1760,7 @@ class VertexArray:
         if self.ctx.gc_mode == "auto":
             self.release()
         elif self.ctx.gc_mode == "context_gc":
-            self.ctx.objects.append(self.mglo)
+            self.ctx.mglo.defer_release(self.mglo)
 
     @property
     def mode(self):
@@ -1385,6 +1778,11 @@ class VertexArray:
     def index_buffer(self):
         return self._index_buffer
 
+    @index_buffer.setter
+    def index_buffer(self, value):
+        self.mglo.index_buffer = _buffer_range(value)
+        self._index_buffer = value
+
     @property
     def index_element_size(self):
         return self._index_element_size
@@ -1488,6 +1886,10 @@ class VertexArray:
         divisor=0,
         normalize=False,
     ):
+        if type(buffer) is BufferSlice:
+            offset += buffer.offset
+            buffer = buffer.buffer
+
         self.mglo.bind(
             attribute, cls, buffer.mglo, fmt, offset, stride, divisor, normalize
         )
@@ -1501,6 +1903,452 @@ class VertexArray:
             self.mglo = InvalidObject()
 
 
+class Tile:
+    def __init__(self, x, y, width, height, size):
+        self.x = x
+        self.y = y
+        self.width = width
+        self.height = height
+        self.size = size
+
+    def __repr__(self):
+        return f"<Tile: {self.x}, {self.y}, {self.width}, {self.height}>"
+
+    @property
+    def viewport(self):
+        return (self.x, self.y, self.width, self.height)
+
+    @property
+    def scale(self):
+        return (self.size[0] / self.width, self.size[1] / self.height)
+
+    @property
+    def offset(self):
+        return (
+            (self.size[0] - 2 * self.x - self.width) / self.width,
+            (self.size[1] - 2 * self.y - self.height) / self.height,
+        )
+
+    @property
+    def matrix(self):
+        sx, sy = self.scale
+        ox, oy = self.offset
+        return (
+            sx, 0.0, 0.0, 0.0,
+            0.0, sy, 0.0, 0.0,
+            0.0, 0.0, 1.0, 0.0,
+            ox, oy, 0.0, 1.0,
+        )
+
+
+class TiledRenderer:
+    def __init__(self):
+        self.framebuffer = None
+        self._size = None
+        self._tile = None
+        self._components = None
+        self._dtype = None
+        self._pbos = None
+        self._scratch = None
+        self.ctx = None
+        self.extra = None
+        raise TypeError()
+
+    def __del__(self):
+        if not hasattr(self, "ctx"):
+            return
+
+        if self.ctx.gc_mode == "auto":
+            self.release()
+
+    @property
+    def size(self):
+        return self._size
+
+    @property
+    def tile(self):
+        return self._tile
+
+    @property
+    def components(self):
+        return self._components
+
+    @property
+    def dtype(self):
+        return self._dtype
+
+    def tiles(self):
+        width, height = self._size
+        tile_width, tile_height = self._tile
+        for y in range(0, height, tile_height):
+            for x in range(0, width, tile_width):
+                yield Tile(x, y, min(tile_width, width - x), min(tile_height, height - y), self._size)
+
+    def render(self, path, callback):
+        import mmap
+
+        width, height = self._size
+        row_size = mgl.expected_size(width, 1, 1, self._components, 1, self._dtype)
+
+        with open(path, "w+b") as f:
+            f.truncate(row_size * height)
+            output = mmap.mmap(f.fileno(), row_size * height)
+
+        previous_framebuffer = self.ctx.fbo
+        try:
+            # Tiles are read into alternating pixel buffers so the readback
+            # of a tile overlaps with rendering the next one
+            pending = None
+            for index, tile in enumerate(self.tiles()):
+                self.framebuffer.use()
+                self.framebuffer.viewport = (0, 0, tile.width, tile.height)
+                callback(tile)
+
+                pbo = self._pbos[index % 2]
+                self.framebuffer.read_into(
+                    pbo, (0, 0, tile.width, tile.height), self._components, dtype=self._dtype
+                )
+
+                if pending is not None:
+                    self._store(output, row_size, *pending)
+                pending = (pbo, tile)
+
+            if pending is not None:
+                self._store(output, row_size, *pending)
+
+            output.flush()
+        finally:
+            output.close()
+            if previous_framebuffer is not None:
+                previous_framebuffer.use()
+
+    def _store(self, output, row_size, pbo, tile):
+        tile_row_size = mgl.expected_size(tile.width, 1, 1, self._components, 1, self._dtype)
+        pixel_size = tile_row_size // tile.width
+        pbo.read_into(self._scratch, tile_row_size * tile.height)
+
+        scratch = memoryview(self._scratch)
+        for row in range(tile.height):
+            src = row * tile_row_size
+            dst = (tile.y + row) * row_size + tile.x * pixel_size
+            output[dst : dst + tile_row_size] = scratch[src : src + tile_row_size]
+
+    def release(self):
+        if self._pbos is not None:
+            for pbo in self._pbos:
+                pbo.release()
+            self._pbos = None
+            self.framebuffer.release()
+            self._scratch = None
+
+
+class GPUZone:
+    def __init__(self, name, depth=0):
+        self.name = name
+        self.depth = depth
+        self.start = None
+        self.end = None
+        self.children = []
+        self._queries = None
+
+    def __repr__(self):
+        return f"<GPUZone: {self.name} {self.duration}>"
+
+    @property
+    def duration(self):
+        if self.start is None or self.end is None:
+            return None
+        return self.end - self.start
+
+    def walk(self):
+        yield self
+        for child in self.children:
+            yield from child.walk()
+
+    def as_dict(self):
+        return {
+            "name": self.name,
+            "start": self.start,
+            "end": self.end,
+            "duration": self.duration,
+            "children": [child.as_dict() for child in self.children],
+        }
+
+
+class GPUProfiler:
+    def __init__(self):
+        self.ctx = None
+        self.frames = None
+        self.debug_scopes = None
+        self._free = None
+        self._pending = None
+        self._stack = None
+        self._frame_queries = None
+        raise TypeError()
+
+    @property
+    def pending(self):
+        return len(self._pending)
+
+    def begin_frame(self, name="frame"):
+        if self._stack:
+            raise Error("the previous frame was not ended")
+        root = GPUZone(name)
+        self._frame_queries = []
+        root._queries = (self._timestamp(), None)
+        self._stack = [root]
+
+    def end_frame(self):
+        if len(self._stack) != 1:
+            raise Error("the frame was not started or has open zones")
+        root = self._stack.pop()
+        root._queries = (root._queries[0], self._timestamp())
+        self._pending.append((root, tuple(self._frame_queries)))
+        self._frame_queries = None
+        return self.collect()
+
+    @contextmanager
+    def frame(self, name="frame"):
+        self.begin_frame(name)
+        try:
+            yield self
+        finally:
+            self.end_frame()
+
+    @contextmanager
+    def zone(self, name):
+        if not self._stack:
+            raise Error("zones must be inside a frame")
+
+        parent = self._stack[-1]
+        zone = GPUZone(name, parent.depth + 1)
+        parent.children.append(zone)
+        self._stack.append(zone)
+
+        begin = self._timestamp()
+        try:
+            if self.debug_scopes:
+                with self.ctx.debug_scope(name):
+                    yield zone
+            else:
+                yield zone
+        finally:
+            zone._queries = (begin, self._timestamp())
+            self._stack.pop()
+
+    def collect(self):
+        # Frames finish in order, stop at the first one still in flight
+        collected = []
+        while self._pending:
+            root, queries = self._pending[0]
+            timestamps = self.ctx.mglo.query_timestamps(queries)
+            if timestamps is None:
+                break
+
+            self._pending.popleft()
+            results = dict(zip(queries, timestamps))
+            for zone in root.walk():
+                zone.start, zone.end = results[zone._queries[0]], results[zone._queries[1]]
+                zone._queries = None
+
+            self._free.extend(queries)
+            self.frames.append(root)
+            collected.append(root)
+        return collected
+
+    def chrome_trace(self, frames=None):
+        events = []
+        for root in self.frames if frames is None else frames:
+            for zone in root.walk():
+                events.append({
+                    "name": zone.name,
+                    "cat": "gpu",
+                    "ph": "X",
+                    "ts": zone.start / 1000.0,
+                    "dur": zone.duration / 1000.0,
+                    "pid": 0,
+                    "tid": "GPU",
+                    "args": {"depth": zone.depth},
+                })
+        return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+    def save_chrome_trace(self, path, frames=None):
+        import json
+
+        with open(path, "w") as f:
+            json.dump(self.chrome_trace(frames), f)
+
+    def _timestamp(self):
+        if not self._free:
+            self._free.extend(self.ctx.mglo.timestamp_queries(32))
+        query = self._free.pop()
+        self.ctx.mglo.query_counter(query)
+        self._frame_queries.append(query)
+        return query
+
+    def release(self):
+        if self._free is not None:
+            queries = list(self._free)
+            for _, frame_queries in self._pending:
+                queries.extend(frame_queries)
+            if self._frame_queries is not None:
+                queries.extend(self._frame_queries)
+            self.ctx.mglo.delete_queries(tuple(queries))
+            self._free = None
+            self._pending = None
+            self._stack = None
+            self._frame_queries = None
+
+
+class UploadJob:
+    def __init__(self):
+        self.ctx = None
+        self._worker = None
+        self._func = None
+        self._event = None
+        self._result = None
+        self._error = None
+        self._fence = None
+        self._adopted = None
+        raise TypeError()
+
+    def done(self):
+        return self._event.is_set()
+
+    def result(self, timeout=None):
+        if not self._event.wait(timeout):
+            raise TimeoutError("the upload job is not finished")
+
+        if self._error is not None:
+            raise self._error
+
+        if not self._adopted:
+            self._adopted = True
+
+            # The commands of the worker are complete before the context uses the objects,
+            # the fence is already deleted when the worker was released first
+            fence = self._worker._take_fence(self._fence)
+            if fence is not None:
+                self.ctx.mglo.wait_fence(fence, False)
+
+            objects = self._result if isinstance(self._result, (list, tuple)) else [self._result]
+            for obj in objects:
+                if not hasattr(obj, "mglo"):
+                    continue
+                self.ctx.mglo.adopt(obj.mglo)
+                obj.ctx = self.ctx
+                for member in getattr(obj, "_members", {}).values():
+                    if hasattr(member, "ctx"):
+                        member.ctx = self.ctx.mglo
+
+        return self._result
+
+
+class UploadWorker:
+    def __init__(self):
+        self.ctx = None
+        self._worker_ctx = None
+        self._jobs = None
+        self._thread = None
+        self._lock = None
+        self._fences = None
+        raise TypeError()
+
+    def _take_fence(self, fence):
+        with self._lock:
+            if fence not in self._fences:
+                return None
+            self._fences.remove(fence)
+            return fence
+
+    def _run(self):
+        self._worker_ctx.mglo.__enter__()
+
+        while True:
+            job = self._jobs.get()
+            if job is None:
+                break
+
+            try:
+                job._result = job._func(self._worker_ctx)
+                with self._lock:
+                    job._fence = self._worker_ctx.mglo.fence()
+                    self._fences.add(job._fence)
+            except Exception as e:
+                job._error = e
+
+            job._event.set()
+
+        # The fences of the jobs whose result was never taken are deleted here,
+        # their objects are complete when the result is taken later
+        with self._lock:
+            for fence in self._fences:
+                self._worker_ctx.mglo.wait_fence(fence, True)
+            self._fences.clear()
+
+        self._worker_ctx.release()
+
+    def submit(self, func):
+        if self._thread is None:
+            raise RuntimeError("the upload worker is released")
+
+        job = UploadJob.__new__(UploadJob)
+        job.ctx = self.ctx
+        job._worker = self
+        job._func = func
+        job._event = threading.Event()
+        job._result = None
+        job._error = None
+        job._fence = None
+        job._adopted = False
+        self._jobs.put(job)
+        return job
+
+    def buffer(self, data=None, reserve=0, dynamic=False):
+        return self.submit(lambda ctx: ctx.buffer(data, reserve=reserve, dynamic=dynamic))
+
+    def texture(self, size, components, data=None, **kwargs):
+        return self.submit(lambda ctx: ctx.texture(size, components, data, **kwargs))
+
+    def program(self, **kwargs):
+        return self.submit(lambda ctx: ctx.program(**kwargs))
+
+    def release(self):
+        if self._thread is None:
+            return
+
+        self._jobs.put(None)
+        self._thread.join()
+        self._thread = None
+
+
+class Limits(Mapping):
+    def __init__(self):
+        self._values = None
+        raise TypeError()
+
+    def __getitem__(self, key):
+        return self._values[key]
+
+    def __iter__(self):
+        return iter(self._values)
+
+    def __len__(self):
+        return len(self._values)
+
+    def __getattr__(self, name):
+        try:
+            return self._values[name]
+        except KeyError:
+            raise AttributeError(name) from None
+
+    def __setattr__(self, name, value):
+        raise AttributeError("the limits are read only")
+
+    def __repr__(self):
+        return "<Limits: {}>".format(self._values)
+
+
 class Context:
     _valid_gc_modes = [None, "context_gc", "auto"]
 
@@ -1588,6 +2436,7 @@ class Context:
         self.mglo = None
         self._screen = None
         self._info = None
+        self._limits = None
         self._extensions = None
         self.version_code = None
         self.fbo = None
@@ -1616,16 +2465,10 @@ class Context:
         return self._objects
 
     def gc(self):
-        count = 0
-        # Keep iterating until there are no more objects.
-        # An object deletion can trigger new objects to be added
+        # Objects appended to Context.objects by hand are released with the deferred ones
         while self._objects:
-            # Remove the oldest objects first
-            obj = self._objects.popleft()
-            obj.release()
-            count += 1
-
-        return count
+            self.mglo.defer_release(self._objects.popleft())
+        return self.mglo.release_deferred()
 
     @property
     def line_width(self):
@@ -1840,6 +2683,14 @@ class Context:
 
         return self._info
 
+    @property
+    def limits(self):
+        if self._limits is None:
+            self._limits = Limits.__new__(Limits)
+            object.__setattr__(self._limits, "_values", self.mglo.limits)
+
+        return self._limits
+
     @property
     def includes(self):
         return self.mglo.includes
@@ -1882,6 +2733,9 @@ class Context:
     ):
         self.mglo.copy_buffer(dst.mglo, src.mglo, size, read_offset, write_offset)
 
+    def copy_buffers(self, copies):
+        self.mglo.copy_buffers(copies)
+
     def copy_framebuffer(self, dst, src):
         self.mglo.copy_framebuffer(dst.mglo, src.mglo)
 
@@ -1892,6 +2746,7 @@ class Context:
         res._depth_attachment = None
         res.ctx = self
         res._is_reference = True
+        res._resolve_targets = {}
         res.extra = None
         return res
 
@@ -1902,16 +2757,49 @@ class Context:
         res = Buffer.__new__(Buffer)
         res.mglo, res._size, res._glo = self.mglo.buffer(data, reserve, dynamic)
         res._dynamic = dynamic
+        res._page_size = None
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
+        return res
+
+    def buffer_arena(self, capacity, alignment=256, dynamic=False):
+        if type(capacity) is str:
+            capacity = mgl.strsize(capacity)
+
+        res = BufferArena.__new__(BufferArena)
+        res.ctx = self
+        res.buffer = self.buffer(reserve=capacity, dynamic=dynamic)
+        res._alignment = alignment
+        res._free = [(0, res.buffer.size)]
+        res._slices = {}
+        res._used = 0
+        res._scratch = None
+        return res
+
+    def sparse_buffer(self, size):
+        if "GL_ARB_sparse_buffer" not in self.extensions:
+            raise Error("sparse buffers are not supported")
+
+        if type(size) is str:
+            size = mgl.strsize(size)
+
+        res = Buffer.__new__(Buffer)
+        res.mglo, res._size, res._glo, res._page_size = self.mglo.sparse_buffer(size)
+        res._dynamic = True
+        res.ctx = self
+        res.extra = None
+        _bind_native_methods(res)
         return res
 
     def external_buffer(self, glo, size):
         res = Buffer.__new__(Buffer)
         res.mglo, res._size, res._glo = self.mglo.external_buffer(glo, size)
         res._dynamic = False
+        res._page_size = None
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def external_texture(self, glo, size, components, samples, dtype):
@@ -1924,8 +2812,10 @@ class Context:
         res._samples = samples
         res._dtype = dtype
         res._depth = False
+        res._page_size = None
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def texture(
@@ -1955,8 +2845,10 @@ class Context:
         res._samples = samples
         res._dtype = dtype
         res._depth = False
+        res._page_size = None
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def texture_array(self, size, components, data=None, alignment=1, dtype="f1"):
@@ -1969,6 +2861,7 @@ class Context:
         res._dtype = dtype
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def texture3d(self, size, components, data=None, alignment=1, dtype="f1"):
@@ -1976,11 +2869,47 @@ class Context:
         res._size = size
         res._components = components
         res._dtype = dtype
+        res._page_size = None
         res.mglo, res._glo = self.mglo.texture3d(
             size, components, data, alignment, dtype
         )
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
+        return res
+
+    def sparse_texture(self, size, components, dtype="f1", levels=1):
+        if "GL_ARB_sparse_texture" not in self.extensions:
+            raise Error("sparse textures are not supported")
+
+        res = Texture.__new__(Texture)
+        res.mglo, res._glo, res._page_size = self.mglo.sparse_texture(
+            tuple(size), components, dtype, levels
+        )
+        res._size = tuple(size)
+        res._components = components
+        res._samples = 0
+        res._dtype = dtype
+        res._depth = False
+        res.ctx = self
+        res.extra = None
+        _bind_native_methods(res)
+        return res
+
+    def sparse_texture3d(self, size, components, dtype="f1", levels=1):
+        if "GL_ARB_sparse_texture" not in self.extensions:
+            raise Error("sparse textures are not supported")
+
+        res = Texture3D.__new__(Texture3D)
+        res.mglo, res._glo, res._page_size = self.mglo.sparse_texture3d(
+            tuple(size), components, dtype, levels
+        )
+        res._size = tuple(size)
+        res._components = components
+        res._dtype = dtype
+        res.ctx = self
+        res.extra = None
+        _bind_native_methods(res)
         return res
 
     def texture_cube(
@@ -1995,6 +2924,7 @@ class Context:
         res._dtype = dtype
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def depth_texture(
@@ -2009,8 +2939,10 @@ class Context:
         res._samples = samples
         res._dtype = "f4"
         res._depth = True
+        res._page_size = None
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def depth_texture_cube(self, size, data=None, alignment=4):
@@ -2022,10 +2954,11 @@ class Context:
         res._depth = True
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def vertex_array(self, *args, **kwargs):
-        if len(args) > 2 and type(args[1]) is Buffer:
+        if len(args) > 2 and type(args[1]) in (Buffer, BufferSlice):
             return self.simple_vertex_array(*args, **kwargs)
         return self._vertex_array(*args, **kwargs)
 
@@ -2040,7 +2973,7 @@ class Context:
     ):
         locations = program._attribute_locations
         types = program._attribute_types
-        index_buffer_mglo = None if index_buffer is None else index_buffer.mglo
+        index_buffer_mglo = None if index_buffer is None else _buffer_range(index_buffer)
         mgl_content = []
 
         for buffer, layout, *attribs in content:
@@ -2059,7 +2992,7 @@ class Context:
                 attribs = [
                     types[x] if type(x) is int else types[locations[x]] for x in attribs
                 ]
-            mgl_content.append((buffer.mglo, layout, *attribs))
+            mgl_content.append((_buffer_range(buffer), layout, *attribs))
 
         res = VertexArray.__new__(VertexArray)
         res.mglo, res._glo = self.mglo.vertex_array(
@@ -2163,9 +3096,9 @@ class Context:
         res.extra = None
         return res
 
-    def query(self, samples=False, any_samples=False, time=False, primitives=False):
+    def query(self, samples=False, any_samples=False, time=False, primitives=False, statistics=False):
         res = Query.__new__(Query)
-        res.mglo = self.mglo.query(samples, any_samples, time, primitives)
+        res.mglo = self.mglo.query(samples, any_samples, time, primitives, statistics)
         res.crender = None
 
         if samples or any_samples:
@@ -2176,6 +3109,25 @@ class Context:
         res.extra = None
         return res
 
+    def occlusion_culler(self, max_objects):
+        res = OcclusionCuller.__new__(OcclusionCuller)
+        res.mglo = self.mglo.occlusion_culler(max_objects)
+        res.ctx = self
+        res.max_objects = max_objects
+        res.extra = None
+        return res
+
+    def gpu_profiler(self, history=120, debug_scopes=True):
+        res = GPUProfiler.__new__(GPUProfiler)
+        res.ctx = self
+        res.frames = deque(maxlen=history)
+        res.debug_scopes = debug_scopes
+        res._free = []
+        res._pending = deque()
+        res._stack = []
+        res._frame_queries = None
+        return res
+
     def scope(
         self,
         framebuffer=None,
@@ -2240,6 +3192,7 @@ class Context:
         res._depth_attachment = depth_attachment
         res.ctx = self
         res._is_reference = False
+        res._resolve_targets = {}
         res.extra = None
         return res
 
@@ -2252,6 +3205,7 @@ class Context:
         res._depth_attachment = None
         res.ctx = self
         res._is_reference = False
+        res._resolve_targets = {}
         res.extra = None
         return res
 
@@ -2281,6 +3235,46 @@ class Context:
         res.extra = None
         return res
 
+    def create_upload_worker(self, **settings):
+        # The shared context shares the objects of the current context, this one is made current first.
+        # The new context is handed over to the thread and this one is made current again
+        default_context = _store.default_context
+        self.mglo.__enter__()
+        worker_ctx = create_context(require=self.version_code, share=True, **settings)
+        _store.default_context = default_context
+        self.mglo.__enter__()
+
+        res = UploadWorker.__new__(UploadWorker)
+        res.ctx = self
+        res._worker_ctx = worker_ctx
+        res._jobs = queue.Queue()
+        res._lock = threading.Lock()
+        res._fences = set()
+        res._thread = threading.Thread(target=res._run, name="moderngl-upload", daemon=True)
+        res._thread.start()
+        return res
+
+    def tiled_renderer(self, size, tile=(1024, 1024), components=4, dtype="f1"):
+        width, height = size
+        tile_width, tile_height = min(tile[0], width), min(tile[1], height)
+
+        if width < 1 or height < 1 or tile_width < 1 or tile_height < 1:
+            raise ValueError("invalid size or tile")
+
+        tile_size = mgl.expected_size(tile_width, tile_height, 1, components, 1, dtype)
+
+        res = TiledRenderer.__new__(TiledRenderer)
+        res.framebuffer = self.simple_framebuffer((tile_width, tile_height), components, dtype=dtype)
+        res._size = (width, height)
+        res._tile = (tile_width, tile_height)
+        res._components = components
+        res._dtype = dtype
+        res._pbos = (self.buffer(reserve=tile_size), self.buffer(reserve=tile_size))
+        res._scratch = bytearray(tile_size)
+        res.ctx = self
+        res.extra = None
+        return res
+
     def compute_shader(self, source):
         res = ComputeShader.__new__(ComputeShader)
         res.mglo, _members, _, _, res._glo = self.mglo.program(
@@ -2300,6 +3294,7 @@ class Context:
 
         res.ctx = self
         res.extra = None
+        _bind_native_methods(res)
         return res
 
     def sampler(
@@ -2371,6 +3366,38 @@ class Context:
         if not isinstance(self.mglo, InvalidObject):
             self.mglo.clear_errors()
 
+    def enable_gl_stats(self, trace=0):
+        self.mglo.enable_gl_stats(trace)
+
+    def disable_gl_stats(self):
+        self.mglo.disable_gl_stats()
+
+    def gl_stats(self):
+        return self.mglo.gl_stats()
+
+    def gl_trace(self):
+        return self.mglo.gl_trace()
+
+    def reset_gl_stats(self):
+        self.mglo.reset_gl_stats()
+
+    def memory_stats(self, reset_peak=False):
+        res = self.mglo.memory_stats(reset_peak)
+        labels = {}
+        for (label_type, glo), size in res.pop("objects").items():
+            label = self.mglo.get_label(label_type, glo) if self.supports_labels else None
+            labels[label] = labels.get(label, 0) + size
+        res["labels"] = labels
+        return res
+
+    @contextmanager
+    def capture(self, path):
+        self.mglo.begin_capture(path)
+        try:
+            yield self
+        finally:
+            self.mglo.end_capture()
+
     @contextmanager
     def debug_scope(self, label, group_id=None, source="application"):
         if not isinstance(label, str):
@@ -2438,6 +3465,7 @@ def create_context(require=None, standalone=False, share=False, **settings):
         glversion=require, mode=mode, **settings
     )
     ctx._info = None
+    ctx._limits = None
     ctx._extensions = None
     ctx.extra = None
     ctx._gc_mode = None
@@ -2473,6 +3501,7 @@ def init_context(loader=None):
     ctx = Context.__new__(Context)
     ctx.mglo, ctx.version_code = mgl.create_context(context=loader)
     ctx._info = None
+    ctx._limits = None
     ctx._extensions = None
     ctx.extra = None
     ctx._gc_mode = None
@@ -2494,6 +3523,17 @@ def create_standalone_context(**kwargs):
     return create_context(standalone=True, **kwargs)
 
 
+def replay(path, ctx=None, require=None, **settings):
+    if ctx is not None:
+        return ctx.mglo.replay(path)
+
+    ctx = create_context(require=require, standalone=True, **settings)
+    try:
+        return ctx.mglo.replay(path)
+    finally:
+        ctx.release()
+
+
 def detect_format(program, attributes, mode="mgl"):
     def fmt(attr):
         # Translate shape format into attribute format
@@ -2518,6 +3558,20 @@ def detect_format(program, attributes, mode="mgl"):
     )
 
 
+def _check_sparse_region(page_size, offset, size, limit):
+    # Regions must start on a page boundary and cover whole pages
+    # unless they reach the end of the resource
+    for o, s, p, m in zip(offset, size, page_size, limit):
+        if o % p or (s % p and o + s != m):
+            raise Error("the region must be aligned to the page size %s" % (page_size,))
+
+
+def _buffer_range(buffer):
+    if type(buffer) is BufferSlice:
+        return buffer._range
+    return buffer.mglo
+
+
 def _resolve_module_constants(scope):
     _constants = [
         "NOTHING",
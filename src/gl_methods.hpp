@@ -1,5 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "glcorearb.h"
 
 #ifdef MemoryBarrier
@@ -756,10 +764,10 @@ struct GLMethods {
     // PFNGLISNAMEDSTRINGARBPROC IsNamedStringARB;
     // PFNGLGETNAMEDSTRINGARBPROC GetNamedStringARB;
     // PFNGLGETNAMEDSTRINGIVARBPROC GetNamedStringivARB;
-    // PFNGLBUFFERPAGECOMMITMENTARBPROC BufferPageCommitmentARB;
+    PFNGLBUFFERPAGECOMMITMENTARBPROC BufferPageCommitmentARB;
     // PFNGLNAMEDBUFFERPAGECOMMITMENTEXTPROC NamedBufferPageCommitmentEXT;
     // PFNGLNAMEDBUFFERPAGECOMMITMENTARBPROC NamedBufferPageCommitmentARB;
-    // PFNGLTEXPAGECOMMITMENTARBPROC TexPageCommitmentARB;
+    PFNGLTEXPAGECOMMITMENTARBPROC TexPageCommitmentARB;
     // PFNGLTEXBUFFERARBPROC TexBufferARB;
     // PFNGLDEPTHRANGEARRAYDVNVPROC DepthRangeArraydvNV;
     // PFNGLDEPTHRANGEINDEXEDDNVPROC DepthRangeIndexeddNV;
@@ -1299,12 +1307,14 @@ void * load_opengl_function(PyObject * loader, const char * method, const char *
     return PyLong_AsVoidPtr(res);
 }
 
-GLMethods load_gl_methods(PyObject * loader) {
-    GLMethods res = {};
-
-    const char * method = PyObject_HasAttrString(loader, "load_opengl_function") ? "load_opengl_function" : "load";
+template <int Line>
+struct GLMethodId {
+};
 
-    #define load(name) res.name = (decltype(res.name))load_opengl_function(loader, method, "gl" # name);
+// Calls visit(res.Name, "glName", GLMethodId<line>()) for every loaded method
+template <typename Visitor>
+void visit_gl_methods(GLMethods & res, Visitor & visit) {
+    #define load(name) visit(res.name, "gl" # name, GLMethodId<__LINE__>());
 
     load(CullFace);
     load(FrontFace);
@@ -2055,10 +2065,10 @@ GLMethods load_gl_methods(PyObject * loader) {
     // load(IsNamedStringARB);
     // load(GetNamedStringARB);
     // load(GetNamedStringivARB);
-    // load(BufferPageCommitmentARB);
+    load(BufferPageCommitmentARB);
     // load(NamedBufferPageCommitmentEXT);
     // load(NamedBufferPageCommitmentARB);
-    // load(TexPageCommitmentARB);
+    load(TexPageCommitmentARB);
     // load(TexBufferARB);
     // load(DepthRangeArraydvNV);
     // load(DepthRangeIndexeddNV);
@@ -2586,6 +2596,1513 @@ GLMethods load_gl_methods(PyObject * loader) {
     // load(FramebufferTextureMultiviewOVR);
 
     #undef load
+}
+
+struct GLMethodLoader {
+    PyObject * loader;
+    const char * method;
+
+    template <typename T, int Line>
+    void operator () (T & proc, const char * name, GLMethodId<Line>) {
+        proc = (T)load_opengl_function(loader, method, name);
+    }
+};
+
+// Resolved tables shared by the contexts of the process.
+// The entry points only depend on the library and the driver, a table is reused for the same loader type,
+// the same glGetString address, which identifies the library the loader resolves from, and the same driver strings
+static std::mutex gl_methods_cache_lock;
+static std::map<std::string, GLMethods> gl_methods_cache;
+
+static bool gl_methods_cache_key(PyObject * loader, const char * method, std::string & key) {
+    PFNGLGETSTRINGPROC GetString = (PFNGLGETSTRINGPROC)load_opengl_function(loader, method, "glGetString");
+    if (!GetString) {
+        return false;
+    }
+
+    PyObject * loader_type = PyObject_Str((PyObject *)Py_TYPE(loader));
+    if (!loader_type) {
+        return false;
+    }
+
+    key = PyUnicode_AsUTF8(loader_type);
+    Py_DECREF(loader_type);
+
+    key += '\n';
+    key += std::to_string((unsigned long long)GetString);
+
+    const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    for (GLenum name : names) {
+        const char * value = (const char *)GetString(name);
+        if (!value) {
+            return false;
+        }
+        key += '\n';
+        key += value;
+    }
+
+    return true;
+}
+
+// Only the loaders created by a known backend are cached, a loader passed in by the caller may resolve anything
+GLMethods load_gl_methods(PyObject * loader, bool known_backend) {
+    GLMethods res = {};
+
+    GLMethodLoader visit;
+    visit.loader = loader;
+    visit.method = PyObject_HasAttrString(loader, "load_opengl_function") ? "load_opengl_function" : "load";
+
+    // Without the driver strings the context is not current, every method is loaded and nothing is cached
+    std::string key;
+    bool cached = known_backend && gl_methods_cache_key(loader, visit.method, key);
+
+    if (cached) {
+        std::lock_guard<std::mutex> guard(gl_methods_cache_lock);
+        auto it = gl_methods_cache.find(key);
+        if (it != gl_methods_cache.end()) {
+            return it->second;
+        }
+    }
+
+    visit_gl_methods(res, visit);
+
+    if (cached && !PyErr_Occurred()) {
+        std::lock_guard<std::mutex> guard(gl_methods_cache_lock);
+        gl_methods_cache[key] = res;
+    }
 
     return res;
+}
+
+#define GL_TRACE_MAX_METHODS 1024
+#define GL_CAPTURE_BUFFER_SIZE (1 << 20)
+#define GL_CAPTURE_MAX_MAPPINGS 8
+#define GL_CAPTURE_DEFAULT_OUTPUT (1 << 16)
+#define GL_REPLAY_MAX_BLOBS 16
+#define GL_REPLAY_MAX_SYNCS 256
+
+static const char gl_capture_magic[8] = {'M', 'G', 'L', 'C', 'A', 'P', '0', '2'};
+
+enum GLCaptureBlob {
+    GL_CAPTURE_END,
+    GL_CAPTURE_INPUT,
+    GL_CAPTURE_OUTPUT,
+    GL_CAPTURE_STRINGS,
+    GL_CAPTURE_NAMES,
+    GL_CAPTURE_MAPPED,
+};
+
+struct GLTraceEvent {
+    int method;
+    long long start;
+    long long duration;
+};
+
+struct GLCaptureMapping {
+    unsigned long long target;
+    char * pointer;
+    unsigned long long length;
+};
+
+// Every call is written as the method index, one 8 byte slot per argument,
+// the tagged blobs holding the client memory and the 8 byte return value
+struct GLCapture {
+    FILE * file;
+    char * data;
+    size_t size;
+    int pack_alignment;
+    int unpack_alignment;
+    int pack_buffer;
+    int unpack_buffer;
+    int query_buffer;
+    GLCaptureMapping mappings[GL_CAPTURE_MAX_MAPPINGS];
 };
+
+// Counters of the instrumented dispatch table, only one context can be traced at a time
+struct GLTrace {
+    GLMethods original;
+    int num_methods;
+    const char * names[GL_TRACE_MAX_METHODS];
+    long long calls[GL_TRACE_MAX_METHODS];
+    long long time[GL_TRACE_MAX_METHODS];
+    GLTraceEvent * events;
+    int max_events;
+    long long num_events;
+    std::chrono::steady_clock::time_point origin;
+    GLCapture * capture;
+    bool stats;
+};
+
+static GLTrace * gl_trace;
+
+// The traced context is process wide, contexts on other threads and interpreters may race for it.
+// The traced calls are serialized, the counters and the capture are written under the lock
+static std::mutex gl_trace_lock;
+
+struct GLTraceScope {
+    int method;
+    std::chrono::steady_clock::time_point start;
+
+    GLTraceScope(int method) : method(method), start(std::chrono::steady_clock::now()) {
+    }
+
+    ~GLTraceScope() {
+        GLTrace * trace = gl_trace;
+        if (!trace) {
+            return;
+        }
+
+        long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        trace->calls[method] += 1;
+        trace->time[method] += duration;
+
+        if (trace->max_events) {
+            GLTraceEvent & event = trace->events[trace->num_events % trace->max_events];
+            event.method = method;
+            event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - trace->origin).count();
+            event.duration = duration;
+            trace->num_events += 1;
+        }
+    }
+};
+
+static void gl_capture_flush(GLCapture & capture) {
+    fwrite(capture.data, 1, capture.size, capture.file);
+    capture.size = 0;
+}
+
+static void gl_capture_write(GLCapture & capture, const void * data, size_t size) {
+    if (capture.size + size > GL_CAPTURE_BUFFER_SIZE) {
+        gl_capture_flush(capture);
+        if (size > GL_CAPTURE_BUFFER_SIZE) {
+            fwrite(data, 1, size, capture.file);
+            return;
+        }
+    }
+    memcpy(capture.data + capture.size, data, size);
+    capture.size += size;
+}
+
+static void gl_capture_blob_header(GLCapture & capture, int kind, int arg, unsigned long long size) {
+    unsigned char header[2] = {(unsigned char)kind, (unsigned char)arg};
+    gl_capture_write(capture, header, 2);
+    gl_capture_write(capture, &size, 8);
+}
+
+static void gl_capture_blob(GLCapture & capture, int kind, int arg, const void * data, unsigned long long size) {
+    gl_capture_blob_header(capture, kind, arg, size);
+    if (data) {
+        gl_capture_write(capture, data, size);
+    }
+}
+
+static unsigned long long gl_image_size(unsigned long long width, unsigned long long height, unsigned long long depth, unsigned long long format, unsigned long long type, int alignment) {
+    int components = 4;
+    switch (format) {
+        case GL_RED: case GL_RED_INTEGER: case GL_GREEN: case GL_BLUE: case GL_ALPHA:
+        case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: case GL_DEPTH_STENCIL:
+            components = 1;
+            break;
+        case GL_RG: case GL_RG_INTEGER:
+            components = 2;
+            break;
+        case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER:
+            components = 3;
+            break;
+    }
+
+    int pixel_size = components * 4;
+    switch (type) {
+        case GL_UNSIGNED_BYTE: case GL_BYTE:
+            pixel_size = components;
+            break;
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+            pixel_size = components * 2;
+            break;
+        case GL_UNSIGNED_INT_24_8:
+            pixel_size = 4;
+            break;
+        case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+            pixel_size = 8;
+            break;
+    }
+
+    if (alignment < 1) {
+        alignment = 1;
+    }
+
+    unsigned long long row = (width * pixel_size + alignment - 1) / alignment * alignment;
+    return row * height * depth;
+}
+
+// Size of the client memory read by a pointer argument, zero for buffer offsets
+static unsigned long long gl_capture_input_size(GLCapture & capture, const char * name, int index, const unsigned long long * a) {
+    size_t length = strlen(name);
+
+    if (!strcmp(name, "glBufferData") || !strcmp(name, "glBufferStorage")) {
+        return a[1];
+    }
+    if (!strcmp(name, "glBufferSubData")) {
+        return a[2];
+    }
+    if (!strncmp(name, "glDelete", 8) || !strcmp(name, "glDrawBuffers") || !strcmp(name, "glShaderSource")) {
+        return a[index == 1 ? 0 : 1] * 4;
+    }
+    if (!strncmp(name, "glSamplerParameter", 18) || !strncmp(name, "glTexParameter", 14)) {
+        return a[1] == GL_TEXTURE_BORDER_COLOR ? 16 : 4;
+    }
+    if (!strcmp(name, "glGetProgramResourceiv")) {
+        return a[3] * 4;
+    }
+    if (!strcmp(name, "glShaderBinary")) {
+        return index == 1 ? a[0] * 4 : a[4];
+    }
+    if (!strcmp(name, "glSpecializeShader")) {
+        return a[2] * 4;
+    }
+    if (!strncmp(name, "glUniformMatrix", 15)) {
+        int rows = name[15] - '0';
+        int cols = name[16] == 'x' ? name[17] - '0' : rows;
+        return a[1] * rows * cols * (name[length - 2] == 'd' ? 8 : 4);
+    }
+    if (!strncmp(name, "glUniform", 9) && name[length - 1] == 'v') {
+        return a[1] * (name[9] - '0') * (name[length - 2] == 'd' ? 8 : 4);
+    }
+    if (capture.unpack_buffer) {
+        return 0;
+    }
+    if (!strcmp(name, "glTexImage2D")) {
+        return gl_image_size(a[3], a[4], 1, a[6], a[7], capture.unpack_alignment);
+    }
+    if (!strcmp(name, "glTexImage3D")) {
+        return gl_image_size(a[3], a[4], a[5], a[7], a[8], capture.unpack_alignment);
+    }
+    if (!strcmp(name, "glTexSubImage2D")) {
+        return gl_image_size(a[4], a[5], 1, a[6], a[7], capture.unpack_alignment);
+    }
+    if (!strcmp(name, "glTexSubImage3D")) {
+        return gl_image_size(a[5], a[6], a[7], a[8], a[9], capture.unpack_alignment);
+    }
+    return 0;
+}
+
+// Size of the client memory written by a pointer argument, zero for buffer offsets
+static unsigned long long gl_capture_output_size(GLCapture & capture, const char * name, const unsigned long long * a) {
+    if (!strcmp(name, "glReadPixels")) {
+        return capture.pack_buffer ? 0 : gl_image_size(a[2], a[3], 1, a[4], a[5], capture.pack_alignment);
+    }
+    if (!strcmp(name, "glGetTexImage")) {
+        if (capture.pack_buffer) {
+            return 0;
+        }
+        int width = 0, height = 0, depth = 0;
+        const GLMethods & gl = gl_trace->original;
+        gl.GetTexLevelParameteriv((GLenum)a[0], (GLint)a[1], GL_TEXTURE_WIDTH, &width);
+        gl.GetTexLevelParameteriv((GLenum)a[0], (GLint)a[1], GL_TEXTURE_HEIGHT, &height);
+        gl.GetTexLevelParameteriv((GLenum)a[0], (GLint)a[1], GL_TEXTURE_DEPTH, &depth);
+        return gl_image_size(width, height, depth, a[2], a[3], capture.pack_alignment);
+    }
+    if (!strncmp(name, "glGetQueryObject", 16) && capture.query_buffer) {
+        return 0;
+    }
+    return GL_CAPTURE_DEFAULT_OUTPUT;
+}
+
+template <typename T>
+unsigned long long gl_capture_slot(T value) {
+    unsigned long long slot = 0;
+    memcpy(&slot, &value, sizeof(T) < 8 ? sizeof(T) : 8);
+    return slot;
+}
+
+template <typename T>
+void gl_capture_arg(GLCapture & capture, const char * name, int index, T value, const unsigned long long * a, bool after) {
+}
+
+static void gl_capture_arg(GLCapture & capture, const char * name, int index, GLsync value, const unsigned long long * a, bool after) {
+}
+
+static void gl_capture_arg(GLCapture & capture, const char * name, int index, GLDEBUGPROC value, const unsigned long long * a, bool after) {
+}
+
+static void gl_capture_arg(GLCapture & capture, const char * name, int index, const char * value, const unsigned long long * a, bool after) {
+    if (!after && value) {
+        gl_capture_blob(capture, GL_CAPTURE_INPUT, index, value, strlen(value) + 1);
+    }
+}
+
+// The count is the second argument of both glShaderSource and glTransformFeedbackVaryings
+static void gl_capture_arg(GLCapture & capture, const char * name, int index, const char * const * value, const unsigned long long * a, bool after) {
+    if (after || !value) {
+        return;
+    }
+
+    unsigned long long size = 0;
+    for (unsigned long long i = 0; i < a[1]; ++i) {
+        size += strlen(value[i]) + 1;
+    }
+
+    gl_capture_blob_header(capture, GL_CAPTURE_STRINGS, index, size);
+    for (unsigned long long i = 0; i < a[1]; ++i) {
+        gl_capture_write(capture, value[i], strlen(value[i]) + 1);
+    }
+}
+
+template <typename T>
+void gl_capture_arg(GLCapture & capture, const char * name, int index, const T * value, const unsigned long long * a, bool after) {
+    if (after || !value) {
+        return;
+    }
+
+    unsigned long long size = gl_capture_input_size(capture, name, index, a);
+    if (size) {
+        gl_capture_blob(capture, GL_CAPTURE_INPUT, index, value, size);
+    }
+}
+
+template <typename T>
+void gl_capture_arg(GLCapture & capture, const char * name, int index, T * value, const unsigned long long * a, bool after) {
+    if (!after || !value) {
+        return;
+    }
+
+    // Generated names are compared while replaying to detect a diverging replay
+    if (!strncmp(name, "glGen", 5)) {
+        gl_capture_blob(capture, GL_CAPTURE_NAMES, index, value, a[0] * 4);
+        return;
+    }
+
+    unsigned long long size = gl_capture_output_size(capture, name, a);
+    if (size) {
+        gl_capture_blob(capture, GL_CAPTURE_OUTPUT, index, NULL, size);
+    }
+}
+
+template <typename ... Args>
+void gl_capture_args(GLCapture & capture, const char * name, const unsigned long long * a, bool after, Args ... args) {
+    int index = 0;
+    int expand[] = {0, (gl_capture_arg(capture, name, index++, args, a, after), 0) ...};
+    (void)expand;
+}
+
+// Mappings by target and by buffer name share the table, a buffer name never collides with a target enum
+static unsigned long long gl_capture_map_key(const char * name, unsigned long long first) {
+    return strstr(name, "Named") ? first | (1ull << 32) : first;
+}
+
+static bool gl_capture_is_map(const char * name) {
+    return !strcmp(name, "glMapBufferRange") || !strcmp(name, "glMapNamedBufferRange");
+}
+
+static bool gl_capture_is_unmap(const char * name) {
+    return !strcmp(name, "glUnmapBuffer") || !strcmp(name, "glUnmapNamedBuffer");
+}
+
+static GLCaptureMapping * gl_capture_mapping(GLCapture & capture, unsigned long long target) {
+    for (int i = 0; i < GL_CAPTURE_MAX_MAPPINGS; ++i) {
+        if (capture.mappings[i].pointer && capture.mappings[i].target == target) {
+            return &capture.mappings[i];
+        }
+    }
+    return NULL;
+}
+
+// Data written through mapped pointers is saved before it is flushed or unmapped
+static void gl_capture_before(GLCapture & capture, const char * name, const unsigned long long * a) {
+    bool unmap = gl_capture_is_unmap(name);
+    if (!unmap && strcmp(name, "glFlushMappedBufferRange") && strcmp(name, "glFlushMappedNamedBufferRange")) {
+        return;
+    }
+
+    GLCaptureMapping * mapping = gl_capture_mapping(capture, gl_capture_map_key(name, a[0]));
+    if (!mapping) {
+        return;
+    }
+
+    unsigned long long offset = unmap ? 0 : a[1];
+    unsigned long long length = unmap ? mapping->length : a[2];
+    gl_capture_blob_header(capture, GL_CAPTURE_MAPPED, 255, length + 8);
+    gl_capture_write(capture, &offset, 8);
+    gl_capture_write(capture, mapping->pointer + offset, length);
+
+    if (unmap) {
+        mapping->pointer = NULL;
+    }
+}
+
+static void gl_capture_after(GLCapture & capture, const char * name, const unsigned long long * a, unsigned long long ret) {
+    unsigned char end = GL_CAPTURE_END;
+    gl_capture_write(capture, &end, 1);
+    gl_capture_write(capture, &ret, 8);
+
+    if (!strcmp(name, "glPixelStorei")) {
+        if (a[0] == GL_PACK_ALIGNMENT) {
+            capture.pack_alignment = (int)a[1];
+        }
+        if (a[0] == GL_UNPACK_ALIGNMENT) {
+            capture.unpack_alignment = (int)a[1];
+        }
+    } else if (!strcmp(name, "glBindBuffer")) {
+        if (a[0] == GL_PIXEL_PACK_BUFFER) {
+            capture.pack_buffer = (int)a[1];
+        }
+        if (a[0] == GL_PIXEL_UNPACK_BUFFER) {
+            capture.unpack_buffer = (int)a[1];
+        }
+        if (a[0] == GL_QUERY_BUFFER) {
+            capture.query_buffer = (int)a[1];
+        }
+    } else if (gl_capture_is_map(name) && (a[3] & GL_MAP_WRITE_BIT) && ret) {
+        unsigned long long key = gl_capture_map_key(name, a[0]);
+        GLCaptureMapping * mapping = gl_capture_mapping(capture, key);
+        for (int i = 0; !mapping && i < GL_CAPTURE_MAX_MAPPINGS; ++i) {
+            if (!capture.mappings[i].pointer) {
+                mapping = &capture.mappings[i];
+            }
+        }
+        if (mapping) {
+            mapping->target = key;
+            mapping->pointer = (char *)ret;
+            mapping->length = a[2];
+        }
+    }
+}
+
+template <typename R>
+struct GLCaptureCall {
+    template <typename ... Args>
+    static R call(R (APIENTRY * proc)(Args ...), GLCapture & capture, int method, Args ... args) {
+        const char * name = gl_trace->names[method];
+        unsigned long long a[] = {gl_capture_slot(args) ..., 0};
+        unsigned short index = (unsigned short)method;
+        gl_capture_write(capture, &index, 2);
+        gl_capture_write(capture, a, sizeof ... (Args) * 8);
+        gl_capture_args(capture, name, a, false, args ...);
+        gl_capture_before(capture, name, a);
+        R res = proc(args ...);
+        gl_capture_args(capture, name, a, true, args ...);
+        gl_capture_after(capture, name, a, gl_capture_slot(res));
+        return res;
+    }
+};
+
+template <>
+struct GLCaptureCall<void> {
+    template <typename ... Args>
+    static void call(void (APIENTRY * proc)(Args ...), GLCapture & capture, int method, Args ... args) {
+        const char * name = gl_trace->names[method];
+        unsigned long long a[] = {gl_capture_slot(args) ..., 0};
+        unsigned short index = (unsigned short)method;
+        gl_capture_write(capture, &index, 2);
+        gl_capture_write(capture, a, sizeof ... (Args) * 8);
+        gl_capture_args(capture, name, a, false, args ...);
+        gl_capture_before(capture, name, a);
+        proc(args ...);
+        gl_capture_args(capture, name, a, true, args ...);
+        gl_capture_after(capture, name, a, 0);
+    }
+};
+
+struct GLReplayBlob {
+    int kind;
+    int arg;
+    const char * data;
+    unsigned long long size;
+};
+
+struct GLReplay;
+
+struct GLReplayMethod {
+    void * proc;
+    bool (* replay)(void * proc, GLReplay & state);
+};
+
+struct GLReplay {
+    const char * ptr;
+    const char * end;
+    int num_methods;
+    const char ** names;
+    GLReplayMethod * methods;
+    const char * name;
+    const char * error;
+    GLReplayBlob blobs[GL_REPLAY_MAX_BLOBS];
+    int num_blobs;
+    unsigned long long ret;
+    char * scratch;
+    size_t scratch_size;
+    const char ** strings;
+    size_t strings_size;
+    GLsync syncs[GL_REPLAY_MAX_SYNCS][2];
+    int num_syncs;
+    unsigned long long map_targets[GL_CAPTURE_MAX_MAPPINGS];
+    char * map_pointers[GL_CAPTURE_MAX_MAPPINGS];
+};
+
+static bool gl_replay_read(GLReplay & state, void * data, size_t size) {
+    if ((size_t)(state.end - state.ptr) < size) {
+        state.error = "the capture is truncated";
+        return false;
+    }
+    memcpy(data, state.ptr, size);
+    state.ptr += size;
+    return true;
+}
+
+static char * gl_replay_mapping(GLReplay & state, unsigned long long target, char * pointer, bool store) {
+    int free_slot = 0;
+    for (int i = 0; i < GL_CAPTURE_MAX_MAPPINGS; ++i) {
+        if (state.map_pointers[i] && state.map_targets[i] == target) {
+            if (store) {
+                state.map_pointers[i] = pointer;
+            }
+            return state.map_pointers[i];
+        }
+        if (!state.map_pointers[i]) {
+            free_slot = i;
+        }
+    }
+    if (store) {
+        state.map_targets[free_slot] = target;
+        state.map_pointers[free_slot] = pointer;
+    }
+    return pointer;
+}
+
+// Reads the arguments and the blobs of a call and points the arguments at the replayed memory
+static bool gl_replay_record(GLReplay & state, unsigned long long * a, int num_args) {
+    if (!gl_replay_read(state, a, num_args * 8)) {
+        return false;
+    }
+
+    state.num_blobs = 0;
+    size_t scratch = 0;
+
+    while (true) {
+        unsigned char kind = 0;
+        if (!gl_replay_read(state, &kind, 1)) {
+            return false;
+        }
+
+        if (kind == GL_CAPTURE_END) {
+            break;
+        }
+
+        if (state.num_blobs == GL_REPLAY_MAX_BLOBS) {
+            state.error = "the capture is corrupted";
+            return false;
+        }
+
+        GLReplayBlob & blob = state.blobs[state.num_blobs++];
+        unsigned char arg = 0;
+        if (!gl_replay_read(state, &arg, 1) || !gl_replay_read(state, &blob.size, 8)) {
+            return false;
+        }
+
+        blob.kind = kind;
+        blob.arg = arg;
+        blob.data = state.ptr;
+
+        if (kind != GL_CAPTURE_OUTPUT) {
+            if ((size_t)(state.end - state.ptr) < blob.size) {
+                state.error = "the capture is truncated";
+                return false;
+            }
+            state.ptr += blob.size;
+        }
+
+        if (kind == GL_CAPTURE_OUTPUT || kind == GL_CAPTURE_NAMES) {
+            scratch += (blob.size + 15) & ~15;
+        }
+    }
+
+    if (!gl_replay_read(state, &state.ret, 8)) {
+        return false;
+    }
+
+    if (scratch > state.scratch_size) {
+        delete[] state.scratch;
+        state.scratch = new char[scratch];
+        state.scratch_size = scratch;
+    }
+
+    scratch = 0;
+
+    for (int i = 0; i < state.num_blobs; ++i) {
+        GLReplayBlob & blob = state.blobs[i];
+
+        if (blob.kind != GL_CAPTURE_MAPPED && blob.arg >= num_args) {
+            state.error = "the capture is corrupted";
+            return false;
+        }
+
+        switch (blob.kind) {
+            case GL_CAPTURE_INPUT:
+                a[blob.arg] = (unsigned long long)blob.data;
+                break;
+
+            case GL_CAPTURE_OUTPUT:
+            case GL_CAPTURE_NAMES:
+                a[blob.arg] = (unsigned long long)(state.scratch + scratch);
+                scratch += (blob.size + 15) & ~15;
+                break;
+
+            case GL_CAPTURE_STRINGS: {
+                if (a[1] > state.strings_size) {
+                    delete[] state.strings;
+                    state.strings = new const char * [a[1]];
+                    state.strings_size = a[1];
+                }
+                const char * str = blob.data;
+                for (unsigned long long j = 0; j < a[1]; ++j) {
+                    state.strings[j] = str;
+                    str += strlen(str) + 1;
+                }
+                a[blob.arg] = (unsigned long long)state.strings;
+                break;
+            }
+
+            case GL_CAPTURE_MAPPED: {
+                unsigned long long key = gl_capture_map_key(state.name, a[0]);
+                char * pointer = gl_replay_mapping(state, key, NULL, false);
+                unsigned long long offset = 0;
+                memcpy(&offset, blob.data, 8);
+                if (pointer) {
+                    memcpy(pointer + offset, blob.data + 8, blob.size - 8);
+                }
+                if (gl_capture_is_unmap(state.name)) {
+                    gl_replay_mapping(state, key, NULL, true);
+                }
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool gl_replay_verify(GLReplay & state, const unsigned long long * a) {
+    for (int i = 0; i < state.num_blobs; ++i) {
+        GLReplayBlob & blob = state.blobs[i];
+        if (blob.kind == GL_CAPTURE_NAMES && memcmp((void *)a[blob.arg], blob.data, blob.size)) {
+            state.error = "the replay generated different object names";
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+struct GLReplayArg {
+    static T get(GLReplay & state, unsigned long long slot) {
+        T value;
+        memcpy(&value, &slot, sizeof(T) < 8 ? sizeof(T) : 8);
+        return value;
+    }
+};
+
+template <>
+struct GLReplayArg<GLsync> {
+    static GLsync get(GLReplay & state, unsigned long long slot) {
+        for (int i = 0; i < GL_REPLAY_MAX_SYNCS; ++i) {
+            if (state.syncs[i][0] == (GLsync)slot) {
+                return state.syncs[i][1];
+            }
+        }
+        return NULL;
+    }
+};
+
+// Callbacks of the captured process are not valid in the replay
+template <>
+struct GLReplayArg<GLDEBUGPROC> {
+    static GLDEBUGPROC get(GLReplay & state, unsigned long long slot) {
+        return NULL;
+    }
+};
+
+template <typename T>
+void gl_replay_return(GLReplay & state, const unsigned long long * a, T value) {
+}
+
+static void gl_replay_return(GLReplay & state, const unsigned long long * a, GLsync value) {
+    GLsync * sync = state.syncs[state.num_syncs++ % GL_REPLAY_MAX_SYNCS];
+    sync[0] = (GLsync)state.ret;
+    sync[1] = value;
+}
+
+static void gl_replay_return(GLReplay & state, const unsigned long long * a, void * value) {
+    if (gl_capture_is_map(state.name)) {
+        gl_replay_mapping(state, gl_capture_map_key(state.name, a[0]), (char *)value, true);
+    }
+}
+
+template <typename R>
+struct GLReplayCall {
+    template <typename ... Args, size_t ... I>
+    static void call(R (APIENTRY * proc)(Args ...), GLReplay & state, const unsigned long long * a, std::index_sequence<I ...>) {
+        gl_replay_return(state, a, proc(GLReplayArg<Args>::get(state, a[I]) ...));
+    }
+};
+
+template <>
+struct GLReplayCall<void> {
+    template <typename ... Args, size_t ... I>
+    static void call(void (APIENTRY * proc)(Args ...), GLReplay & state, const unsigned long long * a, std::index_sequence<I ...>) {
+        proc(GLReplayArg<Args>::get(state, a[I]) ...);
+    }
+};
+
+template <int Line, typename T>
+struct GLTraced;
+
+template <int Line, typename R, typename ... Args>
+struct GLTraced<Line, R (APIENTRY *)(Args ...)> {
+    static R (APIENTRY * original)(Args ...);
+    static int method;
+
+    static R APIENTRY call(Args ... args) {
+        std::lock_guard<std::mutex> guard(gl_trace_lock);
+        GLTraceScope scope(method);
+        GLCapture * capture = gl_trace ? gl_trace->capture : NULL;
+        if (capture) {
+            return GLCaptureCall<R>::call(original, *capture, method, args ...);
+        }
+        return original(args ...);
+    }
+
+    static bool replay(void * proc, GLReplay & state) {
+        unsigned long long a[sizeof ... (Args) + 1];
+        if (!gl_replay_record(state, a, sizeof ... (Args))) {
+            return false;
+        }
+        GLReplayCall<R>::call((R (APIENTRY *)(Args ...))proc, state, a, std::index_sequence_for<Args ...>());
+        return gl_replay_verify(state, a);
+    }
+};
+
+template <int Line, typename R, typename ... Args>
+R (APIENTRY * GLTraced<Line, R (APIENTRY *)(Args ...)>::original)(Args ...);
+
+template <int Line, typename R, typename ... Args>
+int GLTraced<Line, R (APIENTRY *)(Args ...)>::method;
+
+struct GLMethodTracer {
+    GLTrace * trace;
+
+    template <typename T, int Line>
+    void operator () (T & proc, const char * name, GLMethodId<Line>) {
+        if (!proc || trace->num_methods == GL_TRACE_MAX_METHODS) {
+            return;
+        }
+
+        typedef GLTraced<Line, T> traced;
+        traced::original = proc;
+        traced::method = trace->num_methods;
+        trace->names[trace->num_methods++] = name;
+        proc = traced::call;
+    }
+};
+
+// Replaces every loaded method of gl with a counting trampoline
+GLTrace * trace_gl_methods(GLMethods & gl) {
+    GLTrace * trace = new GLTrace();
+    trace->original = gl;
+    trace->origin = std::chrono::steady_clock::now();
+
+    GLMethodTracer visit;
+    visit.trace = trace;
+    visit_gl_methods(gl, visit);
+    return trace;
+}
+
+struct GLMethodReplayer {
+    GLReplay * state;
+
+    template <typename T, int Line>
+    void operator () (T & proc, const char * name, GLMethodId<Line>) {
+        if (!proc) {
+            return;
+        }
+
+        for (int i = 0; i < state->num_methods; ++i) {
+            if (!strcmp(state->names[i], name)) {
+                state->methods[i].proc = (void *)proc;
+                state->methods[i].replay = GLTraced<Line, T>::replay;
+            }
+        }
+    }
+};
+
+// Executes the calls of a capture, returns the number of calls or -1 with state.error set
+long long replay_gl_capture(GLMethods & gl, GLReplay & state) {
+    char magic[8];
+    unsigned num_methods = 0;
+
+    if (!gl_replay_read(state, magic, 8) || memcmp(magic, gl_capture_magic, 8) || !gl_replay_read(state, &num_methods, 4)) {
+        state.error = "not a capture file";
+        return -1;
+    }
+
+    state.num_methods = num_methods;
+    state.names = new const char * [num_methods];
+    state.methods = new GLReplayMethod[num_methods]();
+
+    for (unsigned i = 0; i < num_methods; ++i) {
+        state.names[i] = state.ptr;
+        const char * end = (const char *)memchr(state.ptr, 0, state.end - state.ptr);
+        if (!end) {
+            state.error = "the capture is truncated";
+            return -1;
+        }
+        state.ptr = end + 1;
+    }
+
+    GLMethodReplayer visit;
+    visit.state = &state;
+    visit_gl_methods(gl, visit);
+
+    long long calls = 0;
+
+    while (state.ptr < state.end) {
+        unsigned short method = 0;
+        if (!gl_replay_read(state, &method, 2)) {
+            return -1;
+        }
+
+        if (method >= num_methods) {
+            state.error = "the capture is corrupted";
+            return -1;
+        }
+
+        state.name = state.names[method];
+        GLReplayMethod & entry = state.methods[method];
+
+        if (!entry.proc) {
+            state.error = "the context does not support a captured method";
+            return -1;
+        }
+
+        if (!entry.replay(entry.proc, state)) {
+            return -1;
+        }
+
+        calls += 1;
+    }
+
+    return calls;
+}
+
+enum GLNullBehavior {
+    GL_NULL_NONE,
+    GL_NULL_GEN_NAMES,
+    GL_NULL_NAME,
+    GL_NULL_CREATE_SHADER,
+    GL_NULL_SHADER_SOURCE,
+    GL_NULL_ATTACH_SHADER,
+    GL_NULL_DELETE_INTERFACE,
+    GL_NULL_GET_ACTIVE_ATTRIB,
+    GL_NULL_GET_ACTIVE_UNIFORM,
+    GL_NULL_ATTRIB_LOCATION,
+    GL_NULL_UNIFORM_LOCATION,
+    GL_NULL_GET_UNIFORM,
+    GL_NULL_GET_INTEGER,
+    GL_NULL_GET_FLOAT,
+    GL_NULL_GET_BOOLEAN,
+    GL_NULL_GET_STRING,
+    GL_NULL_GET_STATUS,
+    GL_NULL_GET_QUERY,
+    GL_NULL_GET_QUERY64,
+    GL_NULL_GET_LAST,
+    GL_NULL_GET_LAST64,
+    GL_NULL_GET_DATA,
+    GL_NULL_LOCATION,
+    GL_NULL_MAP,
+    GL_NULL_FENCE,
+    GL_NULL_WAIT,
+    GL_NULL_FRAMEBUFFER_STATUS,
+    GL_NULL_PIXEL_STORE,
+    GL_NULL_BIND_FRAMEBUFFER,
+};
+
+// A uniform or a vertex shader input declared in the source
+struct GLNullVariable {
+    std::string name;
+    int type;
+    int size;
+    int array_length;
+};
+
+// The declarations of a shader, or of the shaders attached to a program, all of them are reported active
+struct GLNullInterface {
+    int shader_type;
+    std::vector<GLNullVariable> attributes;
+    std::vector<GLNullVariable> uniforms;
+};
+
+// Process wide state of the null backend, just enough to answer the queries moderngl makes
+struct GLNullState {
+    unsigned long long next_name;
+    char * map;
+    size_t map_size;
+    int pack_alignment;
+    int unpack_alignment;
+    int draw_framebuffer;
+    int read_framebuffer;
+    std::map<unsigned long long, GLNullInterface> interfaces;
+    std::vector<char *> retired_maps;
+};
+
+// The stubs may be called from several threads, the calls touching the state take the lock
+static std::mutex gl_null_lock;
+static GLNullState gl_null = {0, NULL, 0, 4, 4, 0, 0};
+
+struct GLNullType {
+    const char * name;
+    int type;
+    int size;
+};
+
+static const GLNullType gl_null_types[] = {
+    {"bool", GL_BOOL, 4}, {"bvec2", GL_BOOL_VEC2, 8}, {"bvec3", GL_BOOL_VEC3, 12}, {"bvec4", GL_BOOL_VEC4, 16},
+    {"int", GL_INT, 4}, {"ivec2", GL_INT_VEC2, 8}, {"ivec3", GL_INT_VEC3, 12}, {"ivec4", GL_INT_VEC4, 16},
+    {"uint", GL_UNSIGNED_INT, 4}, {"uvec2", GL_UNSIGNED_INT_VEC2, 8}, {"uvec3", GL_UNSIGNED_INT_VEC3, 12}, {"uvec4", GL_UNSIGNED_INT_VEC4, 16},
+    {"float", GL_FLOAT, 4}, {"vec2", GL_FLOAT_VEC2, 8}, {"vec3", GL_FLOAT_VEC3, 12}, {"vec4", GL_FLOAT_VEC4, 16},
+    {"double", GL_DOUBLE, 8}, {"dvec2", GL_DOUBLE_VEC2, 16}, {"dvec3", GL_DOUBLE_VEC3, 24}, {"dvec4", GL_DOUBLE_VEC4, 32},
+    {"mat2", GL_FLOAT_MAT2, 16}, {"mat2x2", GL_FLOAT_MAT2, 16}, {"mat2x3", GL_FLOAT_MAT2x3, 24}, {"mat2x4", GL_FLOAT_MAT2x4, 32},
+    {"mat3x2", GL_FLOAT_MAT3x2, 24}, {"mat3", GL_FLOAT_MAT3, 36}, {"mat3x3", GL_FLOAT_MAT3, 36}, {"mat3x4", GL_FLOAT_MAT3x4, 48},
+    {"mat4x2", GL_FLOAT_MAT4x2, 32}, {"mat4x3", GL_FLOAT_MAT4x3, 48}, {"mat4", GL_FLOAT_MAT4, 64}, {"mat4x4", GL_FLOAT_MAT4, 64},
+    {"dmat2", GL_DOUBLE_MAT2, 32}, {"dmat2x2", GL_DOUBLE_MAT2, 32}, {"dmat2x3", GL_DOUBLE_MAT2x3, 48}, {"dmat2x4", GL_DOUBLE_MAT2x4, 64},
+    {"dmat3x2", GL_DOUBLE_MAT3x2, 48}, {"dmat3", GL_DOUBLE_MAT3, 72}, {"dmat3x3", GL_DOUBLE_MAT3, 72}, {"dmat3x4", GL_DOUBLE_MAT3x4, 96},
+    {"dmat4x2", GL_DOUBLE_MAT4x2, 64}, {"dmat4x3", GL_DOUBLE_MAT4x3, 96}, {"dmat4", GL_DOUBLE_MAT4, 128}, {"dmat4x4", GL_DOUBLE_MAT4, 128},
+    {"sampler1D", GL_SAMPLER_1D, 4}, {"sampler1DArray", GL_SAMPLER_1D_ARRAY, 4},
+    {"isampler1D", GL_INT_SAMPLER_1D, 4}, {"isampler1DArray", GL_INT_SAMPLER_1D_ARRAY, 4},
+    {"sampler2D", GL_SAMPLER_2D, 4}, {"isampler2D", GL_INT_SAMPLER_2D, 4}, {"usampler2D", GL_UNSIGNED_INT_SAMPLER_2D, 4},
+    {"sampler2DArray", GL_SAMPLER_2D_ARRAY, 4}, {"isampler2DArray", GL_INT_SAMPLER_2D_ARRAY, 4},
+    {"usampler2DArray", GL_UNSIGNED_INT_SAMPLER_2D_ARRAY, 4},
+    {"sampler3D", GL_SAMPLER_3D, 4}, {"isampler3D", GL_INT_SAMPLER_3D, 4}, {"usampler3D", GL_UNSIGNED_INT_SAMPLER_3D, 4},
+    {"sampler2DShadow", GL_SAMPLER_2D_SHADOW, 4},
+    {"sampler2DMS", GL_SAMPLER_2D_MULTISAMPLE, 4}, {"isampler2DMS", GL_INT_SAMPLER_2D_MULTISAMPLE, 4},
+    {"usampler2DMS", GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE, 4},
+    {"sampler2DMSArray", GL_SAMPLER_2D_MULTISAMPLE_ARRAY, 4}, {"isampler2DMSArray", GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY, 4},
+    {"usampler2DMSArray", GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY, 4},
+    {"samplerCube", GL_SAMPLER_CUBE, 4}, {"isamplerCube", GL_INT_SAMPLER_CUBE, 4}, {"usamplerCube", GL_UNSIGNED_INT_SAMPLER_CUBE, 4},
+    {"image2D", GL_IMAGE_2D, 4},
+};
+
+static const GLNullType * gl_null_type(const std::string & name) {
+    for (size_t i = 0; i < sizeof(gl_null_types) / sizeof(gl_null_types[0]); ++i) {
+        if (name == gl_null_types[i].name) {
+            return &gl_null_types[i];
+        }
+    }
+    return NULL;
+}
+
+static bool gl_null_identifier(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Collects the uniforms and the vertex shader inputs declared outside of the blocks and functions.
+// Uniform blocks and structs are not reported, nothing is optimized out like a real linker would.
+static void gl_null_parse(GLNullInterface & shader, const std::string & source) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < source.size()) {
+        if (source[i] == '#' || !source.compare(i, 2, "//")) {
+            i = source.find('\n', i);
+        } else if (!source.compare(i, 2, "/*")) {
+            i = source.find("*/", i + 2);
+            i = i == std::string::npos ? i : i + 2;
+        } else if (gl_null_identifier(source[i])) {
+            size_t start = i;
+            while (i < source.size() && gl_null_identifier(source[i])) {
+                i += 1;
+            }
+            tokens.push_back(source.substr(start, i - start));
+        } else {
+            if (!isspace((unsigned char)source[i])) {
+                tokens.push_back(std::string(1, source[i]));
+            }
+            i += 1;
+        }
+    }
+
+    int depth = 0;
+    for (size_t t = 0; t < tokens.size(); ++t) {
+        const std::string & token = tokens[t];
+        if (token == "{" || token == "(") {
+            depth += 1;
+            continue;
+        }
+        if (token == "}" || token == ")") {
+            depth -= 1;
+            continue;
+        }
+
+        bool input = (token == "in" || token == "attribute") && shader.shader_type == GL_VERTEX_SHADER;
+        if (depth || (token != "uniform" && !input)) {
+            continue;
+        }
+
+        size_t k = t + 1;
+        while (k < tokens.size() && (tokens[k] == "lowp" || tokens[k] == "mediump" || tokens[k] == "highp")) {
+            k += 1;
+        }
+
+        const GLNullType * type = k < tokens.size() ? gl_null_type(tokens[k]) : NULL;
+        if (!type) {
+            continue;
+        }
+
+        std::vector<GLNullVariable> & variables = input ? shader.attributes : shader.uniforms;
+        for (k += 1; k < tokens.size() && gl_null_identifier(tokens[k][0]); k += 1) {
+            GLNullVariable variable = {tokens[k], type->type, type->size, 1};
+            if (k + 3 < tokens.size() && tokens[k + 1] == "[" && tokens[k + 3] == "]") {
+                variable.array_length = atoi(tokens[k + 2].c_str());
+                k += 3;
+            }
+            variables.push_back(variable);
+            if (k + 1 >= tokens.size() || tokens[k + 1] != ",") {
+                break;
+            }
+            k += 1;
+        }
+        t = k;
+    }
+}
+
+static const GLNullVariable * gl_null_variable(const std::vector<GLNullVariable> & variables, unsigned long long index) {
+    return index < variables.size() ? &variables[(size_t)index] : NULL;
+}
+
+// The elements of an array take consecutive locations
+static int gl_null_location(const std::vector<GLNullVariable> & variables, const char * name) {
+    // Array members may be looked up by their first element
+    size_t length = strcspn(name, "[");
+    int location = 0;
+    for (size_t i = 0; i < variables.size(); ++i) {
+        if (!variables[i].name.compare(0, std::string::npos, name, length)) {
+            return location;
+        }
+        location += variables[i].array_length;
+    }
+    return -1;
+}
+
+static const GLNullVariable * gl_null_at_location(const std::vector<GLNullVariable> & variables, unsigned long long location) {
+    for (size_t i = 0; i < variables.size(); ++i) {
+        if (location < (unsigned long long)variables[i].array_length) {
+            return &variables[i];
+        }
+        location -= variables[i].array_length;
+    }
+    return NULL;
+}
+
+static int gl_null_behavior(const char * name, bool last_pointer) {
+    size_t length = strlen(name);
+
+    if (!strncmp(name, "glGen", 5) || (!strncmp(name, "glCreate", 8) && last_pointer)) {
+        return GL_NULL_GEN_NAMES;
+    }
+    if (!strcmp(name, "glCreateProgram")) {
+        return GL_NULL_NAME;
+    }
+    if (!strcmp(name, "glCreateShader")) {
+        return GL_NULL_CREATE_SHADER;
+    }
+    if (!strcmp(name, "glShaderSource")) {
+        return GL_NULL_SHADER_SOURCE;
+    }
+    if (!strcmp(name, "glAttachShader")) {
+        return GL_NULL_ATTACH_SHADER;
+    }
+    if (!strcmp(name, "glDeleteShader") || !strcmp(name, "glDeleteProgram")) {
+        return GL_NULL_DELETE_INTERFACE;
+    }
+    if (!strcmp(name, "glGetActiveAttrib")) {
+        return GL_NULL_GET_ACTIVE_ATTRIB;
+    }
+    if (!strcmp(name, "glGetActiveUniform")) {
+        return GL_NULL_GET_ACTIVE_UNIFORM;
+    }
+    if (!strcmp(name, "glGetAttribLocation")) {
+        return GL_NULL_ATTRIB_LOCATION;
+    }
+    if (!strcmp(name, "glGetUniformLocation")) {
+        return GL_NULL_UNIFORM_LOCATION;
+    }
+    if (!strcmp(name, "glGetUniformfv") || !strcmp(name, "glGetUniformiv") || !strcmp(name, "glGetUniformuiv") || !strcmp(name, "glGetUniformdv")) {
+        return GL_NULL_GET_UNIFORM;
+    }
+    if (!strcmp(name, "glGetIntegerv")) {
+        return GL_NULL_GET_INTEGER;
+    }
+    if (!strcmp(name, "glGetFloatv")) {
+        return GL_NULL_GET_FLOAT;
+    }
+    if (!strcmp(name, "glGetBooleanv")) {
+        return GL_NULL_GET_BOOLEAN;
+    }
+    if (!strcmp(name, "glGetString") || !strcmp(name, "glGetStringi")) {
+        return GL_NULL_GET_STRING;
+    }
+    if (!strcmp(name, "glGetShaderiv") || !strcmp(name, "glGetProgramiv")) {
+        return GL_NULL_GET_STATUS;
+    }
+    if (!strncmp(name, "glGetQueryObject", 16)) {
+        return strstr(name, "64") ? GL_NULL_GET_QUERY64 : GL_NULL_GET_QUERY;
+    }
+    if (!strcmp(name, "glGetUniformBlockIndex")) {
+        return GL_NULL_LOCATION;
+    }
+    if (!strcmp(name, "glMapBufferRange") || !strcmp(name, "glMapBuffer")) {
+        return GL_NULL_MAP;
+    }
+    if (!strcmp(name, "glFenceSync")) {
+        return GL_NULL_FENCE;
+    }
+    if (!strcmp(name, "glClientWaitSync")) {
+        return GL_NULL_WAIT;
+    }
+    if (!strcmp(name, "glCheckFramebufferStatus")) {
+        return GL_NULL_FRAMEBUFFER_STATUS;
+    }
+    if (!strcmp(name, "glPixelStorei")) {
+        return GL_NULL_PIXEL_STORE;
+    }
+    if (!strcmp(name, "glBindFramebuffer")) {
+        return GL_NULL_BIND_FRAMEBUFFER;
+    }
+    if (!strcmp(name, "glGetBufferSubData") || !strcmp(name, "glGetNamedBufferSubData")) {
+        return GL_NULL_GET_DATA;
+    }
+    // Only the state queries end with v, the data getters such as glGetTexImage or glGetShaderInfoLog
+    // write caller sized memory through the last pointer and are left untouched
+    if (!strncmp(name, "glGet", 5) && last_pointer && name[length - 1] == 'v') {
+        bool wide = strstr(name, "64") || strstr(name, "Pointerv") || !strcmp(name + length - 2, "dv");
+        return wide ? GL_NULL_GET_LAST64 : GL_NULL_GET_LAST;
+    }
+    return GL_NULL_NONE;
+}
+
+static int gl_null_integer(unsigned long long pname) {
+    switch (pname) {
+        case GL_MAJOR_VERSION: return 4;
+        case GL_MINOR_VERSION: return 6;
+        case GL_MAX_SAMPLES: return 8;
+        case GL_MAX_INTEGER_SAMPLES: return 8;
+        case GL_MAX_COLOR_ATTACHMENTS: return 8;
+        case GL_MAX_DRAW_BUFFERS: return 8;
+        case GL_MAX_TEXTURE_IMAGE_UNITS: return 32;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: return 192;
+        case GL_MAX_TEXTURE_SIZE: return 16384;
+        case GL_MAX_3D_TEXTURE_SIZE: return 2048;
+        case GL_MAX_ARRAY_TEXTURE_LAYERS: return 2048;
+        case GL_MAX_VERTEX_ATTRIBS: return 16;
+        case GL_MAX_UNIFORM_BUFFER_BINDINGS: return 84;
+        case GL_MAX_LABEL_LENGTH: return 256;
+        case GL_MAX_DEBUG_MESSAGE_LENGTH: return 4096;
+        case GL_MAX_DEBUG_GROUP_STACK_DEPTH: return 64;
+        case GL_PACK_ALIGNMENT: return gl_null.pack_alignment;
+        case GL_UNPACK_ALIGNMENT: return gl_null.unpack_alignment;
+        case GL_DRAW_FRAMEBUFFER_BINDING: return gl_null.draw_framebuffer;
+        case GL_READ_FRAMEBUFFER_BINDING: return gl_null.read_framebuffer;
+        case GL_DRAW_BUFFER: return GL_BACK;
+        case GL_READ_BUFFER: return GL_BACK;
+        case GL_PATCH_VERTICES: return 3;
+        case GL_SPARSE_BUFFER_PAGE_SIZE_ARB: return 65536;
+    }
+    return 0;
+}
+
+static const char * gl_null_string(unsigned long long name) {
+    switch (name) {
+        case GL_VENDOR: return "moderngl";
+        case GL_RENDERER: return "null";
+        case GL_VERSION: return "4.6.0 null";
+        case GL_SHADING_LANGUAGE_VERSION: return "4.60 null";
+    }
+    return "";
+}
+
+static unsigned long long gl_null_call(int behavior, const unsigned long long * a, int num_args) {
+    if (behavior == GL_NULL_NONE) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> guard(gl_null_lock);
+
+    switch (behavior) {
+        case GL_NULL_GEN_NAMES: {
+            GLuint * names = (GLuint *)a[num_args - 1];
+            for (unsigned long long i = 0; i < a[num_args - 2]; ++i) {
+                names[i] = (GLuint)++gl_null.next_name;
+            }
+            return 0;
+        }
+
+        case GL_NULL_NAME:
+        case GL_NULL_FENCE:
+            return ++gl_null.next_name;
+
+        case GL_NULL_CREATE_SHADER: {
+            unsigned long long name = ++gl_null.next_name;
+            gl_null.interfaces[name].shader_type = (int)a[0];
+            return name;
+        }
+
+        case GL_NULL_SHADER_SOURCE: {
+            const GLchar * const * strings = (const GLchar * const *)a[2];
+            const GLint * lengths = (const GLint *)a[3];
+            std::string source;
+            for (unsigned long long i = 0; i < a[1]; ++i) {
+                source.append(strings[i], lengths && lengths[i] >= 0 ? (size_t)lengths[i] : strlen(strings[i]));
+            }
+            GLNullInterface & shader = gl_null.interfaces[a[0]];
+            shader.attributes.clear();
+            shader.uniforms.clear();
+            gl_null_parse(shader, source);
+            return 0;
+        }
+
+        case GL_NULL_ATTACH_SHADER: {
+            const GLNullInterface & shader = gl_null.interfaces[a[1]];
+            GLNullInterface & program = gl_null.interfaces[a[0]];
+            for (const GLNullVariable & variable : shader.attributes) {
+                if (gl_null_location(program.attributes, variable.name.c_str()) < 0) {
+                    program.attributes.push_back(variable);
+                }
+            }
+            for (const GLNullVariable & variable : shader.uniforms) {
+                if (gl_null_location(program.uniforms, variable.name.c_str()) < 0) {
+                    program.uniforms.push_back(variable);
+                }
+            }
+            return 0;
+        }
+
+        case GL_NULL_DELETE_INTERFACE:
+            gl_null.interfaces.erase(a[0]);
+            return 0;
+
+        case GL_NULL_GET_ACTIVE_ATTRIB:
+        case GL_NULL_GET_ACTIVE_UNIFORM: {
+            const GLNullInterface & program = gl_null.interfaces[a[0]];
+            bool uniform = behavior == GL_NULL_GET_ACTIVE_UNIFORM;
+            const GLNullVariable * variable = gl_null_variable(uniform ? program.uniforms : program.attributes, a[1]);
+            GLsizei buf_size = (GLsizei)a[2];
+            GLchar * name = (GLchar *)a[6];
+            GLsizei length = 0;
+            if (variable && buf_size > 0) {
+                length = (GLsizei)variable->name.copy(name, (size_t)buf_size - 1);
+                name[length] = 0;
+            } else if (buf_size > 0) {
+                name[0] = 0;
+            }
+            if (a[3]) {
+                *(GLsizei *)a[3] = length;
+            }
+            *(GLint *)a[4] = variable ? variable->array_length : 0;
+            *(GLenum *)a[5] = variable ? variable->type : 0;
+            return 0;
+        }
+
+        case GL_NULL_ATTRIB_LOCATION:
+            return (unsigned)gl_null_location(gl_null.interfaces[a[0]].attributes, (const char *)a[1]);
+
+        case GL_NULL_UNIFORM_LOCATION:
+            return (unsigned)gl_null_location(gl_null.interfaces[a[0]].uniforms, (const char *)a[1]);
+
+        case GL_NULL_GET_UNIFORM: {
+            // The values are not stored, a whole element reads back as zero
+            const GLNullVariable * variable = gl_null_at_location(gl_null.interfaces[a[0]].uniforms, a[1]);
+            if (variable) {
+                memset((void *)a[2], 0, (size_t)variable->size);
+            }
+            return 0;
+        }
+
+        case GL_NULL_GET_INTEGER: {
+            GLint * data = (GLint *)a[1];
+            if (a[0] == GL_VIEWPORT || a[0] == GL_SCISSOR_BOX) {
+                memset(data, 0, 16);
+            } else if (a[0] == GL_MAX_VIEWPORT_DIMS) {
+                data[0] = data[1] = 16384;
+            } else {
+                data[0] = gl_null_integer(a[0]);
+            }
+            return 0;
+        }
+
+        case GL_NULL_GET_FLOAT: {
+            GLfloat * data = (GLfloat *)a[1];
+            if (a[0] == GL_COLOR_CLEAR_VALUE || a[0] == GL_BLEND_COLOR) {
+                memset(data, 0, 16);
+            } else if (a[0] == GL_DEPTH_RANGE) {
+                data[0] = 0.0f;
+                data[1] = 1.0f;
+            } else if (a[0] == GL_POINT_SIZE || a[0] == GL_LINE_WIDTH) {
+                data[0] = 1.0f;
+            } else if (a[0] == GL_MAX_TEXTURE_MAX_ANISOTROPY) {
+                data[0] = 16.0f;
+            } else {
+                data[0] = 0.0f;
+            }
+            return 0;
+        }
+
+        case GL_NULL_GET_BOOLEAN: {
+            GLboolean * data = (GLboolean *)a[1];
+            if (a[0] == GL_COLOR_WRITEMASK) {
+                memset(data, GL_TRUE, 4);
+            } else {
+                data[0] = a[0] == GL_DEPTH_WRITEMASK;
+            }
+            return 0;
+        }
+
+        case GL_NULL_GET_STRING:
+            return (unsigned long long)gl_null_string(a[0]);
+
+        case GL_NULL_GET_STATUS:
+            if (a[1] == GL_ACTIVE_ATTRIBUTES) {
+                *(GLint *)a[2] = (GLint)gl_null.interfaces[a[0]].attributes.size();
+            } else if (a[1] == GL_ACTIVE_UNIFORMS) {
+                *(GLint *)a[2] = (GLint)gl_null.interfaces[a[0]].uniforms.size();
+            } else {
+                *(GLint *)a[2] = a[1] == GL_COMPILE_STATUS || a[1] == GL_LINK_STATUS;
+            }
+            return 0;
+
+        case GL_NULL_GET_QUERY:
+            *(GLuint *)a[2] = a[1] == GL_QUERY_RESULT_AVAILABLE;
+            return 0;
+
+        case GL_NULL_GET_QUERY64:
+            *(GLuint64 *)a[2] = a[1] == GL_QUERY_RESULT_AVAILABLE;
+            return 0;
+
+        case GL_NULL_GET_LAST:
+            if (a[num_args - 1]) {
+                *(GLint *)a[num_args - 1] = 0;
+            }
+            return 0;
+
+        case GL_NULL_GET_LAST64:
+            if (a[num_args - 1]) {
+                *(GLint64 *)a[num_args - 1] = 0;
+            }
+            return 0;
+
+        case GL_NULL_GET_DATA:
+            memset((void *)a[num_args - 1], 0, (size_t)a[num_args - 2]);
+            return 0;
+
+        case GL_NULL_LOCATION:
+            return (unsigned)-1;
+
+        case GL_NULL_MAP: {
+            // Every mapping shares the same scratch memory, the data is not stored.
+            // The smaller scratch memory is kept, mappings on other threads may still point into it
+            size_t size = num_args == 4 ? (size_t)a[2] : 1 << 20;
+            if (size > gl_null.map_size) {
+                if (gl_null.map) {
+                    gl_null.retired_maps.push_back(gl_null.map);
+                }
+                gl_null.map_size = size > gl_null.map_size * 2 ? size : gl_null.map_size * 2;
+                gl_null.map = new char[gl_null.map_size]();
+            }
+            return (unsigned long long)gl_null.map;
+        }
+
+        case GL_NULL_WAIT:
+            return GL_ALREADY_SIGNALED;
+
+        case GL_NULL_FRAMEBUFFER_STATUS:
+            return GL_FRAMEBUFFER_COMPLETE;
+
+        case GL_NULL_PIXEL_STORE:
+            if (a[0] == GL_PACK_ALIGNMENT) {
+                gl_null.pack_alignment = (int)a[1];
+            }
+            if (a[0] == GL_UNPACK_ALIGNMENT) {
+                gl_null.unpack_alignment = (int)a[1];
+            }
+            return 0;
+
+        case GL_NULL_BIND_FRAMEBUFFER:
+            if (a[0] == GL_FRAMEBUFFER || a[0] == GL_DRAW_FRAMEBUFFER) {
+                gl_null.draw_framebuffer = (int)a[1];
+            }
+            if (a[0] == GL_FRAMEBUFFER || a[0] == GL_READ_FRAMEBUFFER) {
+                gl_null.read_framebuffer = (int)a[1];
+            }
+            return 0;
+    }
+    return 0;
+}
+
+template <typename R>
+struct GLNullCall {
+    static R call(int behavior, const unsigned long long * a, int num_args) {
+        unsigned long long ret = gl_null_call(behavior, a, num_args);
+        R res;
+        memcpy(&res, &ret, sizeof(R) < 8 ? sizeof(R) : 8);
+        return res;
+    }
+};
+
+template <>
+struct GLNullCall<void> {
+    static void call(int behavior, const unsigned long long * a, int num_args) {
+        gl_null_call(behavior, a, num_args);
+    }
+};
+
+template <int Line, typename T>
+struct GLNull;
+
+template <int Line, typename R, typename ... Args>
+struct GLNull<Line, R (APIENTRY *)(Args ...)> {
+    static int behavior;
+
+    static bool last_is_pointer() {
+        bool pointers[] = {false, std::is_pointer<Args>::value ...};
+        return pointers[sizeof ... (Args)];
+    }
+
+    static R APIENTRY call(Args ... args) {
+        unsigned long long a[] = {gl_capture_slot(args) ..., 0};
+        return GLNullCall<R>::call(behavior, a, sizeof ... (Args));
+    }
+};
+
+template <int Line, typename R, typename ... Args>
+int GLNull<Line, R (APIENTRY *)(Args ...)>::behavior;
+
+struct GLNullFinder {
+    const char * name;
+    void * proc;
+
+    template <typename T, int Line>
+    void operator () (T & proc, const char * name, GLMethodId<Line>) {
+        if (strcmp(this->name, name)) {
+            return;
+        }
+
+        typedef GLNull<Line, T> stub;
+        stub::behavior = gl_null_behavior(name, stub::last_is_pointer());
+        this->proc = (void *)stub::call;
+    }
+};
+
+// Returns a stub entry point of the null backend, NULL for unknown methods
+void * null_gl_function(const char * name) {
+    GLMethods gl = {};
+    GLNullFinder visit;
+    visit.name = name;
+    visit.proc = NULL;
+    visit_gl_methods(gl, visit);
+    return visit.proc;
+}
@@ -1,28 +1,85 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
+#include <mutex>
+
 #include "gl_methods.hpp"
 
-#define MGLError_Set(...) PyErr_Format(moderngl_error, __VA_ARGS__)
+#define MGLError_Set(...) PyErr_Format(state->error, __VA_ARGS__)
 
 #define MGL_MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define MGL_MIN(a, b) (((a) < (b)) ? (a) : (b))
 
-static PyObject * helper;
-static PyObject * moderngl_error;
-static PyTypeObject * MGLBuffer_type;
-static PyTypeObject * MGLContext_type;
-static PyTypeObject * MGLFramebuffer_type;
-static PyTypeObject * MGLProgram_type;
-static PyTypeObject * MGLQuery_type;
-static PyTypeObject * MGLRenderbuffer_type;
-static PyTypeObject * MGLScope_type;
-static PyTypeObject * MGLTexture_type;
-static PyTypeObject * MGLTextureArray_type;
-static PyTypeObject * MGLTextureCube_type;
-static PyTypeObject * MGLTexture3D_type;
-static PyTypeObject * MGLVertexArray_type;
-static PyTypeObject * MGLSampler_type;
+// Uploads of at least this size release the GIL, other threads keep running while the driver copies the data
+#define MGL_UNLOCKED_UPLOAD_SIZE (64 * 1024)
+
+// Free-threaded builds guard the state touched from other threads with a mutex, the GIL does it otherwise.
+// The lock is never held while Python code may run, PyMutex is not reentrant
+#ifdef Py_GIL_DISABLED
+typedef PyMutex MGLMutex;
+#define MGLMutex_Lock(mutex) PyMutex_Lock(&(mutex))
+#define MGLMutex_Unlock(mutex) PyMutex_Unlock(&(mutex))
+#else
+struct MGLMutex {};
+#define MGLMutex_Lock(mutex)
+#define MGLMutex_Unlock(mutex)
+#endif
+
+// The module is loaded once per interpreter, the helper module and the types live in the module state
+struct MGLModuleState {
+    PyObject * helper;
+    PyObject * error;
+    PyObject * mglo_str;
+    PyTypeObject * buffer_type;
+    PyTypeObject * buffer_view_type;
+    PyTypeObject * context_type;
+    PyTypeObject * framebuffer_type;
+    PyTypeObject * program_type;
+    PyTypeObject * query_type;
+    PyTypeObject * occlusion_culler_type;
+    PyTypeObject * renderbuffer_type;
+    PyTypeObject * scope_type;
+    PyTypeObject * texture_type;
+    PyTypeObject * texture_array_type;
+    PyTypeObject * texture_cube_type;
+    PyTypeObject * texture3d_type;
+    PyTypeObject * vertex_array_type;
+    PyTypeObject * sampler_type;
+};
+
+// The types are created from the module, every object reaches the state of its interpreter through its type.
+// The error and the type macros expect the state in a local named state
+#if PY_VERSION_HEX >= 0x03090000
+
+static MGLModuleState * module_state(void * obj) {
+    return (MGLModuleState *)PyType_GetModuleState(Py_TYPE((PyObject *)obj));
+}
+
+#else
+
+static MGLModuleState * module_state_single;
+
+static MGLModuleState * module_state(void * obj) {
+    return module_state_single;
+}
+
+#endif
+
+#define MGLBuffer_type (state->buffer_type)
+#define MGLBufferView_type (state->buffer_view_type)
+#define MGLContext_type (state->context_type)
+#define MGLFramebuffer_type (state->framebuffer_type)
+#define MGLProgram_type (state->program_type)
+#define MGLQuery_type (state->query_type)
+#define MGLOcclusionCuller_type (state->occlusion_culler_type)
+#define MGLRenderbuffer_type (state->renderbuffer_type)
+#define MGLScope_type (state->scope_type)
+#define MGLTexture_type (state->texture_type)
+#define MGLTextureArray_type (state->texture_array_type)
+#define MGLTextureCube_type (state->texture_cube_type)
+#define MGLTexture3D_type (state->texture3d_type)
+#define MGLVertexArray_type (state->vertex_array_type)
+#define MGLSampler_type (state->sampler_type)
 
 enum MGLEnableFlag {
     MGL_NOTHING = 0,
@@ -85,6 +142,150 @@ struct MGLBuffer {
     bool dynamic;
     bool released;
     bool external;
+    bool mapped; // exported through the buffer protocol, GL refuses to map it again
+};
+
+#define MGL_VIEW_MAX_DIMS 8
+
+// A typed range of a buffer, mapped while it is exported through the buffer protocol
+struct MGLBufferView {
+    PyObject_HEAD
+    MGLBuffer * buffer;
+    char * map;
+    Py_ssize_t offset;
+    Py_ssize_t size;
+    int access;
+    int exports;
+    int ndim;
+    char format[16];
+    Py_ssize_t itemsize;
+    Py_ssize_t shape[MGL_VIEW_MAX_DIMS];
+    Py_ssize_t strides[MGL_VIEW_MAX_DIMS];
+};
+
+#define MGL_STAGING_SLOTS 3
+
+// Slots start at a multiple of this, pixel unpacking from a slot needs offsets aligned to the texel type
+#define MGL_STAGING_ALIGNMENT 256
+
+struct MGLStagingRing {
+    int buffer_obj;
+    Py_ssize_t slot_size;
+    char * map;
+    GLsync fences[MGL_STAGING_SLOTS];
+    int next_slot;
+};
+
+// Built on first use by Buffer.scatter and Buffer.gather, copies strided chunks one word per invocation
+struct MGLChunkCopyProgram {
+    int program_obj;
+    int offsets_location;
+    int shape_location;
+};
+
+enum MGLMemoryKind {
+    MGL_MEMORY_BUFFER,
+    MGL_MEMORY_TEXTURE,
+    MGL_MEMORY_RENDERBUFFER,
+    MGL_MEMORY_KINDS,
+};
+
+struct MGLMemoryStats {
+    PyObject * objects; // {(label type, glo): size}
+    long long count[MGL_MEMORY_KINDS];
+    long long total[MGL_MEMORY_KINDS];
+    long long peak[MGL_MEMORY_KINDS];
+    long long peak_total;
+};
+
+// Objects deleted in the order of the kinds, containers before their attachments
+enum MGLReleaseKind {
+    MGL_RELEASE_VERTEX_ARRAY,
+    MGL_RELEASE_FRAMEBUFFER,
+    MGL_RELEASE_SAMPLER,
+    MGL_RELEASE_BUFFER,
+    MGL_RELEASE_TEXTURE,
+    MGL_RELEASE_RENDERBUFFER,
+    MGL_RELEASE_KINDS,
+};
+
+struct MGLReleaseQueue {
+    PyObject * objects; // released one by one
+    GLuint * names[MGL_RELEASE_KINDS];
+    int count[MGL_RELEASE_KINDS];
+    int capacity[MGL_RELEASE_KINDS];
+};
+
+enum MGLLimitKind {
+    MGL_LIMIT_INT,
+    MGL_LIMIT_INT64,
+    MGL_LIMIT_FLOAT,
+    MGL_LIMIT_INT2,
+    MGL_LIMIT_INT3,
+    MGL_LIMIT_FLOAT2,
+};
+
+// Implementation limits queried once when the context is created, 0 when the context version does not define them
+struct MGLLimits {
+    int max_texture_size;
+    int max_3d_texture_size;
+    int max_cube_map_texture_size;
+    int max_array_texture_layers;
+    int max_rectangle_texture_size;
+    int max_texture_buffer_size;
+    int max_renderbuffer_size;
+    float max_texture_lod_bias;
+    float max_texture_max_anisotropy;
+    int max_samples;
+    int max_integer_samples;
+    int max_color_texture_samples;
+    int max_depth_texture_samples;
+    int max_color_attachments;
+    int max_draw_buffers;
+    int max_dual_source_draw_buffers;
+    int max_viewport_dims[2];
+    float point_size_range[2];
+    float aliased_line_width_range[2];
+    int max_vertex_attribs;
+    int max_elements_vertices;
+    int max_elements_indices;
+    int max_texture_image_units;
+    int max_vertex_texture_image_units;
+    int max_combined_texture_image_units;
+    int max_vertex_uniform_components;
+    int max_fragment_uniform_components;
+    int max_varying_components;
+    int max_geometry_output_vertices;
+    int max_clip_distances;
+    int max_uniform_buffer_bindings;
+    int max_uniform_block_size;
+    int uniform_buffer_offset_alignment;
+    long long max_server_wait_timeout;
+    int max_label_length;
+    int max_debug_message_length;
+    int max_debug_group_stack_depth;
+    int max_patch_vertices;
+    int max_tess_gen_level;
+    int max_transform_feedback_buffers;
+    int max_viewports;
+    int min_map_buffer_alignment;
+    int max_atomic_counter_buffer_bindings;
+    int max_image_units;
+    int max_shader_storage_buffer_bindings;
+    long long max_shader_storage_block_size;
+    int shader_storage_buffer_offset_alignment;
+    int max_compute_work_group_count[3];
+    int max_compute_work_group_size[3];
+    int max_compute_work_group_invocations;
+    int max_compute_shared_memory_size;
+    int max_vertex_attrib_bindings;
+    int max_vertex_attrib_relative_offset;
+    long long max_element_index;
+    int max_framebuffer_width;
+    int max_framebuffer_height;
+    int max_framebuffer_layers;
+    int max_framebuffer_samples;
+    int max_uniform_locations;
 };
 
 struct MGLContext {
@@ -95,15 +296,8 @@ struct MGLContext {
     MGLFramebuffer * bound_framebuffer;
     PyObject * includes;
     int version_code;
-    int max_samples;
-    int max_integer_samples;
-    int max_color_attachments;
-    int max_texture_units;
-    int max_label_length;
-    int max_debug_message_length;
-    int max_debug_group_stack_depth;
+    MGLLimits limits;
     int default_texture_unit;
-    float max_anisotropy;
     int enable_flags;
     int front_face;
     int cull_face;
@@ -117,7 +311,13 @@ struct MGLContext {
     int provoking_vertex;
     float polygon_offset_factor;
     float polygon_offset_units;
+    MGLStagingRing staging;
+    MGLChunkCopyProgram chunk_copy;
+    MGLMemoryStats memory;
+    MGLReleaseQueue release_queue;
+    GLTrace * trace;
     GLMethods gl;
+    MGLMutex lock;
     bool released;
 };
 
@@ -212,6 +412,71 @@ static int parse_cube(PyObject * arg, Cube * cube) {
     return 1;
 }
 
+// Argument unpacking for the METH_FASTCALL methods on the hot paths.
+// The positional and keyword arguments are gathered in the order of the keywords, kwnames is NULL without METH_KEYWORDS.
+// Missing arguments are left NULL and take the default value, matching the signature of the Python wrapper.
+
+static int fastcall_args(const char * name, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames, const char * const * keywords, Py_ssize_t min_args, Py_ssize_t max_args, PyObject ** values) {
+    if (nargs > max_args) {
+        PyErr_Format(PyExc_TypeError, "%s() takes from %zd to %zd positional arguments but %zd were given", name, min_args, max_args, nargs);
+        return 0;
+    }
+
+    for (Py_ssize_t i = 0; i < max_args; ++i) {
+        values[i] = i < nargs ? args[i] : NULL;
+    }
+
+    Py_ssize_t num_keywords = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t k = 0; k < num_keywords; ++k) {
+        PyObject * key = PyTuple_GET_ITEM(kwnames, k);
+        Py_ssize_t i = 0;
+        while (i < max_args && PyUnicode_CompareWithASCIIString(key, keywords[i])) {
+            i += 1;
+        }
+        if (i == max_args) {
+            PyErr_Format(PyExc_TypeError, "%s() got an unexpected keyword argument '%U'", name, key);
+            return 0;
+        }
+        if (values[i]) {
+            PyErr_Format(PyExc_TypeError, "%s() got multiple values for argument '%s'", name, keywords[i]);
+            return 0;
+        }
+        values[i] = args[nargs + k];
+    }
+
+    for (Py_ssize_t i = 0; i < min_args; ++i) {
+        if (!values[i]) {
+            PyErr_Format(PyExc_TypeError, "%s() missing required argument '%s'", name, keywords[i]);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int fastcall_ssize(PyObject * arg, Py_ssize_t default_value, Py_ssize_t * value) {
+    if (!arg) {
+        *value = default_value;
+        return 1;
+    }
+    *value = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+    return *value != -1 || !PyErr_Occurred();
+}
+
+static int fastcall_int(PyObject * arg, int default_value, int * value) {
+    if (!arg) {
+        *value = default_value;
+        return 1;
+    }
+    // Same conversion as the "I" format, negative values wrap around
+    unsigned long res = PyLong_AsUnsignedLongMask(arg);
+    if (res == (unsigned long)-1 && PyErr_Occurred()) {
+        return 0;
+    }
+    *value = (int)res;
+    return 1;
+}
+
 struct MGLFramebuffer {
     PyObject_HEAD
     MGLContext * context;
@@ -229,6 +494,14 @@ struct MGLFramebuffer {
     int height;
     int samples;
     bool depth_mask;
+
+    // Lazily created target for Framebuffer.resolve, the attached textures are referenced.
+    // The arrays have an entry per color attachment the context supports
+    int resolve_framebuffer_obj;
+    MGLTexture ** resolve_textures;
+    MGLTexture * resolve_depth_texture;
+    unsigned * resolve_draw_buffers;
+
     bool released;
 };
 
@@ -251,6 +524,36 @@ enum MGLQueryKeys {
     PRIMITIVES_GENERATED,
 };
 
+#define MGL_PIPELINE_STATISTICS 11
+
+static const int pipeline_statistics_targets[MGL_PIPELINE_STATISTICS] = {
+    GL_VERTICES_SUBMITTED_ARB,
+    GL_PRIMITIVES_SUBMITTED_ARB,
+    GL_VERTEX_SHADER_INVOCATIONS_ARB,
+    GL_TESS_CONTROL_SHADER_PATCHES_ARB,
+    GL_TESS_EVALUATION_SHADER_INVOCATIONS_ARB,
+    GL_GEOMETRY_SHADER_INVOCATIONS,
+    GL_GEOMETRY_SHADER_PRIMITIVES_EMITTED_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB,
+    GL_COMPUTE_SHADER_INVOCATIONS_ARB,
+    GL_CLIPPING_INPUT_PRIMITIVES_ARB,
+    GL_CLIPPING_OUTPUT_PRIMITIVES_ARB,
+};
+
+static const char * pipeline_statistics_names[MGL_PIPELINE_STATISTICS] = {
+    "vertices_submitted",
+    "primitives_submitted",
+    "vertex_shader_invocations",
+    "tess_control_shader_patches",
+    "tess_evaluation_shader_invocations",
+    "geometry_shader_invocations",
+    "geometry_shader_primitives_emitted",
+    "fragment_shader_invocations",
+    "compute_shader_invocations",
+    "clipping_input_primitives",
+    "clipping_output_primitives",
+};
+
 enum MGLQueryState {
     QUERY_INACTIVE,
     QUERY_ACTIVE,
@@ -261,11 +564,27 @@ struct MGLQuery {
     PyObject_HEAD
     MGLContext * context;
     int query_obj[4];
+    int statistics_obj[MGL_PIPELINE_STATISTICS];
     MGLQueryState state;
     bool ended;
     bool released;
 };
 
+struct MGLOcclusionCuller {
+    PyObject_HEAD
+    MGLContext * context;
+    int max_objects;
+    GLuint * queries;
+    unsigned char * pending;
+    unsigned char * visible;
+    int program_obj;
+    int mvp_location;
+    int vertex_array_obj;
+    int query_target;
+    bool base_instance;
+    bool released;
+};
+
 struct MGLRenderbuffer {
     PyObject_HEAD
     MGLContext * context;
@@ -393,6 +712,7 @@ struct MGLVertexArray {
     MGLContext * context;
     MGLProgram * program;
     MGLBuffer * index_buffer;
+    Py_ssize_t index_offset;
     int index_element_size;
     int index_element_type;
     int vertex_array_obj;
@@ -817,7 +1137,211 @@ static MGLDataType * from_dtype(const char * dtype) {
     return NULL;
 }
 
+static bool has_extension(MGLContext * ctx, const char * name) {
+    PyObject * ext_name = PyUnicode_FromString(name);
+    int supported = PySet_Contains(ctx->extensions, ext_name);
+    Py_DECREF(ext_name);
+    if (supported < 0) {
+        PyErr_Clear();
+    }
+    return supported == 1;
+}
+
+static bool staging_ring_reserve(MGLContext * ctx, Py_ssize_t slot_size) {
+    // Persistent mapping requires GL 4.4 or ARB_buffer_storage
+    if (ctx->version_code < 440 && !has_extension(ctx, "GL_ARB_buffer_storage")) {
+        return false;
+    }
+
+    // Writes through the persistent map happen between the GL calls, a capture could not record them
+    if (ctx->trace && ctx->trace->capture) {
+        return false;
+    }
+
+    slot_size = (slot_size + MGL_STAGING_ALIGNMENT - 1) / MGL_STAGING_ALIGNMENT * MGL_STAGING_ALIGNMENT;
+
+    MGLStagingRing & ring = ctx->staging;
+    if (ring.buffer_obj && ring.slot_size >= slot_size) {
+        return true;
+    }
+
+    const GLMethods & gl = ctx->gl;
+
+    if (ring.buffer_obj) {
+        for (int i = 0; i < MGL_STAGING_SLOTS; ++i) {
+            if (ring.fences[i]) {
+                gl.ClientWaitSync(ring.fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                gl.DeleteSync(ring.fences[i]);
+                ring.fences[i] = 0;
+            }
+        }
+        gl.BindBuffer(GL_COPY_READ_BUFFER, ring.buffer_obj);
+        gl.UnmapBuffer(GL_COPY_READ_BUFFER);
+        gl.DeleteBuffers(1, (GLuint *)&ring.buffer_obj);
+        ring.buffer_obj = 0;
+        ring.map = 0;
+    }
+
+    int flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    gl.GenBuffers(1, (GLuint *)&ring.buffer_obj);
+    gl.BindBuffer(GL_COPY_READ_BUFFER, ring.buffer_obj);
+    gl.BufferStorage(GL_COPY_READ_BUFFER, slot_size * MGL_STAGING_SLOTS, 0, flags);
+    ring.map = (char *)gl.MapBufferRange(GL_COPY_READ_BUFFER, 0, slot_size * MGL_STAGING_SLOTS, flags);
+
+    if (!ring.map) {
+        gl.DeleteBuffers(1, (GLuint *)&ring.buffer_obj);
+        ring.buffer_obj = 0;
+        return false;
+    }
+
+    ring.slot_size = slot_size;
+    ring.next_slot = 0;
+    return true;
+}
+
+static char * staging_ring_acquire(MGLContext * ctx, int * slot) {
+    MGLStagingRing & ring = ctx->staging;
+    const GLMethods & gl = ctx->gl;
+
+    *slot = ring.next_slot;
+    ring.next_slot = (ring.next_slot + 1) % MGL_STAGING_SLOTS;
+
+    // Wait until the GPU consumed the previous contents of the slot
+    if (ring.fences[*slot]) {
+        gl.ClientWaitSync(ring.fences[*slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        gl.DeleteSync(ring.fences[*slot]);
+        ring.fences[*slot] = 0;
+    }
+
+    return ring.map + *slot * ring.slot_size;
+}
+
+static void staging_ring_release(MGLContext * ctx, int slot) {
+    ctx->staging.fences[slot] = ctx->gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static FILE * open_file_range(MGLModuleState * state, PyObject * path, Py_ssize_t file_offset, Py_ssize_t * size) {
+    FILE * file = fopen(PyBytes_AS_STRING(path), "rb");
+
+    if (!file) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        return 0;
+    }
+
+    #ifdef _WIN32
+    _fseeki64(file, 0, SEEK_END);
+    long long file_size = _ftelli64(file);
+    #else
+    fseeko(file, 0, SEEK_END);
+    long long file_size = ftello(file);
+    #endif
+
+    if (file_offset < 0 || file_offset > file_size) {
+        MGLError_Set("out of range file_offset = %d", file_offset);
+        fclose(file);
+        return 0;
+    }
+
+    if (*size < 0) {
+        *size = (Py_ssize_t)(file_size - file_offset);
+    }
+
+    if (file_offset + *size > file_size) {
+        MGLError_Set("the file is too small");
+        fclose(file);
+        return 0;
+    }
+
+    #ifdef _WIN32
+    _fseeki64(file, file_offset, SEEK_SET);
+    #else
+    fseeko(file, file_offset, SEEK_SET);
+    #endif
+
+    return file;
+}
+
+static bool read_file_chunk(MGLModuleState * state, FILE * file, char * ptr, Py_ssize_t size) {
+    size_t read = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    read = fread(ptr, 1, size, file);
+    Py_END_ALLOW_THREADS
+
+    if ((Py_ssize_t)read != size) {
+        MGLError_Set("cannot read the file");
+        return false;
+    }
+
+    return true;
+}
+
+// Bytes allocated by the buffers, textures and renderbuffers of a context.
+// External and sparse objects are not tracked, their storage is not owned or not committed.
+
+static const char * memory_kind_names[MGL_MEMORY_KINDS] = {"buffer", "texture", "renderbuffer"};
+static const int memory_label_types[MGL_MEMORY_KINDS] = {GL_BUFFER, GL_TEXTURE, GL_RENDERBUFFER};
+
+static long long texture_memory(int width, int height, int depth, int layers, int pixel_size, int samples, int levels) {
+    long long texels = 0;
+    for (int level = 0; level < levels; ++level) {
+        texels += (long long)MGL_MAX(width >> level, 1) * MGL_MAX(height >> level, 1) * MGL_MAX(depth >> level, 1);
+    }
+    return texels * layers * pixel_size * MGL_MAX(samples, 1);
+}
+
+static int mipmap_levels(int width, int height, int depth, int max_level) {
+    int size = MGL_MAX(MGL_MAX(width, height), depth);
+    int levels = 1;
+    while ((size >> levels) && levels <= max_level) {
+        levels += 1;
+    }
+    return levels;
+}
+
+static void memory_track(MGLContext * ctx, int kind, int glo, long long size) {
+    MGLMemoryStats & stats = ctx->memory;
+
+    // Nothing is tracked once the context is released
+    if (!stats.objects) {
+        return;
+    }
+
+    PyObject * key = Py_BuildValue("(ii)", memory_label_types[kind], glo);
+
+    MGLMutex_Lock(ctx->lock);
+    PyObject * old = PyDict_GetItem(stats.objects, key);
+
+    if (old) {
+        stats.total[kind] -= PyLong_AsLongLong(old);
+        stats.count[kind] -= 1;
+    }
+
+    if (size > 0) {
+        PyObject * value = PyLong_FromLongLong(size);
+        PyDict_SetItem(stats.objects, key, value);
+        Py_DECREF(value);
+        stats.total[kind] += size;
+        stats.count[kind] += 1;
+    } else if (old) {
+        PyDict_DelItem(stats.objects, key);
+    }
+
+    long long total = 0;
+    for (int i = 0; i < MGL_MEMORY_KINDS; ++i) {
+        stats.peak[i] = MGL_MAX(stats.peak[i], stats.total[i]);
+        total += stats.total[i];
+    }
+    stats.peak_total = MGL_MAX(stats.peak_total, total);
+
+    MGLMutex_Unlock(ctx->lock);
+
+    Py_DECREF(key);
+}
+
 static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     Py_ssize_t reserve;
     int dynamic;
@@ -867,6 +1391,7 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
 
     MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
     buffer->released = false;
+    buffer->mapped = false;
     buffer->external = false;
 
     buffer->size = buffer_view.len;
@@ -884,11 +1409,19 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
     }
 
     gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
-    gl.BufferData(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    if (buffer_view.buf && buffer->size >= MGL_UNLOCKED_UPLOAD_SIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        gl.BufferData(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+        Py_END_ALLOW_THREADS
+    } else {
+        gl.BufferData(GL_ARRAY_BUFFER, buffer->size, buffer_view.buf, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    }
 
     Py_INCREF(self);
     buffer->context = self;
 
+    memory_track(self, MGL_MEMORY_BUFFER, buffer->buffer_obj, buffer->size);
+
     if (data != Py_None) {
         PyBuffer_Release(&buffer_view);
     }
@@ -896,7 +1429,69 @@ static PyObject * MGLContext_buffer(MGLContext * self, PyObject * args) {
     return Py_BuildValue("(Oni)", buffer, buffer->size, buffer->buffer_obj);
 }
 
+static PyObject * MGLContext_sparse_buffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    Py_ssize_t size;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "n",
+        &size
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (!gl.BufferPageCommitmentARB) {
+        MGLError_Set("sparse buffers are not supported");
+        return 0;
+    }
+
+    if (size <= 0) {
+        MGLError_Set("the buffer cannot be empty");
+        return 0;
+    }
+
+    int page_size = 0;
+    gl.GetIntegerv(GL_SPARSE_BUFFER_PAGE_SIZE_ARB, &page_size);
+
+    if (page_size <= 0) {
+        MGLError_Set("sparse buffers are not supported");
+        return 0;
+    }
+
+    MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
+    buffer->released = false;
+    buffer->mapped = false;
+    buffer->external = false;
+
+    // The storage is a whole number of pages, none of them committed
+    buffer->size = (size + page_size - 1) / page_size * page_size;
+    buffer->dynamic = true;
+
+    buffer->buffer_obj = 0;
+    gl.GenBuffers(1, (GLuint *)&buffer->buffer_obj);
+
+    if (!buffer->buffer_obj) {
+        MGLError_Set("cannot create buffer");
+        Py_DECREF(buffer);
+        return 0;
+    }
+
+    gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
+    gl.BufferStorage(GL_ARRAY_BUFFER, buffer->size, 0, GL_SPARSE_STORAGE_BIT_ARB | GL_DYNAMIC_STORAGE_BIT);
+
+    Py_INCREF(self);
+    buffer->context = self;
+
+    return Py_BuildValue("(Onii)", buffer, buffer->size, buffer->buffer_obj, page_size);
+}
+
 static PyObject * MGLContext_external_buffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int glo;
     int size;
 
@@ -907,6 +1502,7 @@ static PyObject * MGLContext_external_buffer(MGLContext * self, PyObject * args)
 
     MGLBuffer * buffer = PyObject_New(MGLBuffer, MGLBuffer_type);
     buffer->released = false;
+    buffer->mapped = false;
     buffer->external = false;
 
     buffer->size = size;
@@ -919,21 +1515,23 @@ static PyObject * MGLContext_external_buffer(MGLContext * self, PyObject * args)
     return Py_BuildValue("(Oni)", buffer, buffer->size, buffer->buffer_obj);
 }
 
-static PyObject * MGLBuffer_write(MGLBuffer * self, PyObject * args) {
-    PyObject * data;
+static PyObject * MGLBuffer_write(MGLBuffer * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    MGLModuleState * state = module_state(self);
+    static const char * const keywords[] = {"data", "offset"};
+    PyObject * values[2];
     Py_ssize_t offset;
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "On",
-        &data,
-        &offset
+    int args_ok = (
+        fastcall_args("write", args, nargs, kwnames, keywords, 1, 2, values) &&
+        fastcall_ssize(values[1], 0, &offset)
     );
 
     if (!args_ok) {
         return 0;
     }
 
+    PyObject * data = values[0];
+
     Py_buffer buffer_view;
 
     int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_SIMPLE);
@@ -948,45 +1546,188 @@ static PyObject * MGLBuffer_write(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        PyBuffer_Release(&buffer_view);
+        return 0;
+    }
+
     const GLMethods & gl = self->context->gl;
     gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, buffer_view.len, buffer_view.buf);
+    if (buffer_view.len >= MGL_UNLOCKED_UPLOAD_SIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, buffer_view.len, buffer_view.buf);
+        Py_END_ALLOW_THREADS
+    } else {
+        gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset, buffer_view.len, buffer_view.buf);
+    }
     PyBuffer_Release(&buffer_view);
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLBuffer_read(MGLBuffer * self, PyObject * args) {
-    Py_ssize_t size;
+static PyObject * MGLBuffer_write_from_file(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    PyObject * path;
     Py_ssize_t offset;
+    Py_ssize_t size;
+    Py_ssize_t file_offset;
+    Py_ssize_t chunk;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "nn",
+        "O&nnnn",
+        PyUnicode_FSConverter,
+        &path,
+        &offset,
         &size,
-        &offset
+        &file_offset,
+        &chunk
     );
 
     if (!args_ok) {
         return 0;
     }
 
-    if (size < 0) {
-        size = self->size - offset;
+    if (chunk <= 0) {
+        MGLError_Set("the chunk size must be positive");
+        Py_DECREF(path);
+        return 0;
+    }
+
+    FILE * file = open_file_range(state, path, file_offset, &size);
+    Py_DECREF(path);
+
+    if (!file) {
+        return 0;
     }
 
     if (offset < 0 || offset + size > self->size) {
         MGLError_Set("out of range offset = %d or size = %d", offset, size);
+        fclose(file);
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    MGLContext * ctx = self->context;
+    const GLMethods & gl = ctx->gl;
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_READ_BIT);
+    chunk = MGL_MIN(chunk, size);
 
-    if (!map) {
-        MGLError_Set("cannot map the buffer");
-        return 0;
+    if (chunk && staging_ring_reserve(ctx, chunk)) {
+        // The file is read straight into the mapped staging memory while
+        // the GPU copies the previously filled slots
+        for (Py_ssize_t pos = 0; pos < size; pos += chunk) {
+            Py_ssize_t chunk_size = MGL_MIN(chunk, size - pos);
+
+            int slot = 0;
+            char * ptr = staging_ring_acquire(ctx, &slot);
+
+            if (!read_file_chunk(state, file, ptr, chunk_size)) {
+                fclose(file);
+                return 0;
+            }
+
+            gl.BindBuffer(GL_COPY_READ_BUFFER, ctx->staging.buffer_obj);
+            gl.BindBuffer(GL_COPY_WRITE_BUFFER, self->buffer_obj);
+            gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, slot * ctx->staging.slot_size, offset + pos, chunk_size);
+            staging_ring_release(ctx, slot);
+        }
+    } else if (chunk) {
+        char * ptr = (char *)PyMem_Malloc(chunk);
+
+        gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+        for (Py_ssize_t pos = 0; pos < size; pos += chunk) {
+            Py_ssize_t chunk_size = MGL_MIN(chunk, size - pos);
+
+            if (!read_file_chunk(state, file, ptr, chunk_size)) {
+                PyMem_Free(ptr);
+                fclose(file);
+                return 0;
+            }
+
+            gl.BufferSubData(GL_ARRAY_BUFFER, (GLintptr)(offset + pos), chunk_size, ptr);
+        }
+
+        PyMem_Free(ptr);
+    }
+
+    fclose(file);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_commit(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    Py_ssize_t offset;
+    Py_ssize_t size;
+    int commit;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "nnp",
+        &offset,
+        &size,
+        &commit
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (size < 0) {
+        size = self->size - offset;
+    }
+
+    if (offset < 0 || offset + size > self->size) {
+        MGLError_Set("out of range offset = %d or size = %d", offset, size);
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    gl.BindBuffer(GL_COPY_WRITE_BUFFER, self->buffer_obj);
+    gl.BufferPageCommitmentARB(GL_COPY_WRITE_BUFFER, offset, size, commit);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_read(MGLBuffer * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    MGLModuleState * state = module_state(self);
+    static const char * const keywords[] = {"size", "offset"};
+    PyObject * values[2];
+    Py_ssize_t size;
+    Py_ssize_t offset;
+
+    int args_ok = (
+        fastcall_args("read", args, nargs, kwnames, keywords, 0, 2, values) &&
+        fastcall_ssize(values[0], -1, &size) &&
+        fastcall_ssize(values[1], 0, &offset)
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (size < 0) {
+        size = self->size - offset;
+    }
+
+    if (offset < 0 || offset + size > self->size) {
+        MGLError_Set("out of range offset = %d or size = %d", offset, size);
+        return 0;
+    }
+
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_READ_BIT);
+
+    if (!map) {
+        MGLError_Set("cannot map the buffer");
+        return 0;
     }
 
     PyObject * data = PyBytes_FromStringAndSize((const char *)map, size);
@@ -997,6 +1738,7 @@ static PyObject * MGLBuffer_read(MGLBuffer * self, PyObject * args) {
 }
 
 static PyObject * MGLBuffer_read_into(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     Py_ssize_t size;
     Py_ssize_t offset;
@@ -1024,6 +1766,11 @@ static PyObject * MGLBuffer_read_into(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        return 0;
+    }
+
     Py_buffer buffer_view;
 
     int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_WRITABLE);
@@ -1052,7 +1799,79 @@ static PyObject * MGLBuffer_read_into(MGLBuffer * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
+// Strided chunk copies for the common chunk widths. A memcpy of a constant size is lowered to a few unaligned
+// vector loads and stores, unrolling keeps several independent chunks in flight instead of one call per chunk
+template <int N>
+static void copy_chunks_fixed(char * dst, Py_ssize_t dst_step, const char * src, Py_ssize_t src_step, Py_ssize_t count) {
+    Py_ssize_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        memcpy(dst, src, N);
+        memcpy(dst + dst_step, src + src_step, N);
+        memcpy(dst + dst_step * 2, src + src_step * 2, N);
+        memcpy(dst + dst_step * 3, src + src_step * 3, N);
+        dst += dst_step * 4;
+        src += src_step * 4;
+    }
+    for (; i < count; ++i) {
+        memcpy(dst, src, N);
+        dst += dst_step;
+        src += src_step;
+    }
+}
+
+static void copy_chunks(char * dst, Py_ssize_t dst_step, const char * src, Py_ssize_t src_step, Py_ssize_t chunk_size, Py_ssize_t count) {
+    if (dst_step == chunk_size && src_step == chunk_size) {
+        memcpy(dst, src, chunk_size * count);
+        return;
+    }
+    switch (chunk_size) {
+        case 4: copy_chunks_fixed<4>(dst, dst_step, src, src_step, count); return;
+        case 8: copy_chunks_fixed<8>(dst, dst_step, src, src_step, count); return;
+        case 12: copy_chunks_fixed<12>(dst, dst_step, src, src_step, count); return;
+        case 16: copy_chunks_fixed<16>(dst, dst_step, src, src_step, count); return;
+        case 32: copy_chunks_fixed<32>(dst, dst_step, src, src_step, count); return;
+        case 64: copy_chunks_fixed<64>(dst, dst_step, src, src_step, count); return;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        memcpy(dst, src, chunk_size);
+        dst += dst_step;
+        src += src_step;
+    }
+}
+
+static void copy_chunks_unlocked(char * dst, Py_ssize_t dst_step, const char * src, Py_ssize_t src_step, Py_ssize_t chunk_size, Py_ssize_t count) {
+    if (chunk_size * count >= MGL_UNLOCKED_UPLOAD_SIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        copy_chunks(dst, dst_step, src, src_step, chunk_size, count);
+        Py_END_ALLOW_THREADS
+    } else {
+        copy_chunks(dst, dst_step, src, src_step, chunk_size, count);
+    }
+}
+
+// Maps only the bytes touched by count chunks starting at start, step may be negative.
+// Returns the address of the first chunk, the caller unmaps GL_ARRAY_BUFFER
+static char * map_chunks(MGLBuffer * self, Py_ssize_t chunk_size, Py_ssize_t start, Py_ssize_t step, Py_ssize_t count, GLbitfield access) {
+    const GLMethods & gl = self->context->gl;
+    Py_ssize_t abs_step = step > 0 ? step : -step;
+    Py_ssize_t first = step > 0 ? start : start + (count - 1) * step;
+    Py_ssize_t span = abs_step * (count - 1) + chunk_size;
+
+    // The gaps between chunks must survive a write, the range is only invalidated when the chunks cover it
+    if ((access & GL_MAP_WRITE_BIT) && (chunk_size == abs_step || count == 1)) {
+        access |= GL_MAP_INVALIDATE_RANGE_BIT;
+    }
+
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    char * map = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, first, span, access);
+    if (!map) {
+        return 0;
+    }
+    return map + (start - first);
+}
+
 static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     Py_ssize_t start;
     Py_ssize_t step;
@@ -1081,8 +1900,15 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    if (count <= 0) {
+        if (count < 0 || buffer_view.len) {
+            MGLError_Set("data (%d bytes) cannot be divided to %d equal chunks", buffer_view.len, count);
+            PyBuffer_Release(&buffer_view);
+            return 0;
+        }
+        PyBuffer_Release(&buffer_view);
+        Py_RETURN_NONE;
+    }
 
     Py_ssize_t chunk_size = buffer_view.len / count;
 
@@ -1102,8 +1928,14 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    char * write_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_WRITE_BIT);
-    char * read_ptr = (char *)buffer_view.buf;
+    if (!chunk_size) {
+        PyBuffer_Release(&buffer_view);
+        Py_RETURN_NONE;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    char * write_ptr = map_chunks(self, chunk_size, start, step, count, GL_MAP_WRITE_BIT);
 
     if (!write_ptr) {
         MGLError_Set("cannot map the buffer");
@@ -1111,12 +1943,7 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
         return 0;
     }
 
-    write_ptr += start;
-    for (Py_ssize_t i = 0; i < count; ++i) {
-        memcpy(write_ptr, read_ptr, chunk_size);
-        read_ptr += chunk_size;
-        write_ptr += step;
-    }
+    copy_chunks_unlocked(write_ptr, step, (const char *)buffer_view.buf, chunk_size, chunk_size, count);
 
     gl.UnmapBuffer(GL_ARRAY_BUFFER);
     PyBuffer_Release(&buffer_view);
@@ -1124,6 +1951,7 @@ static PyObject * MGLBuffer_write_chunks(MGLBuffer * self, PyObject * args) {
 }
 
 static PyObject * MGLBuffer_read_chunks(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     Py_ssize_t chunk_size;
     Py_ssize_t start;
     Py_ssize_t step;
@@ -1148,16 +1976,18 @@ static PyObject * MGLBuffer_read_chunks(MGLBuffer * self, PyObject * args) {
         start = self->size + start;
     }
 
-    if (start < 0 || chunk_size < 0 || chunk_size > abs_step || start + chunk_size > self->size || start + count * step - step < 0 || start + count * step - step + chunk_size > self->size) {
+    if (start < 0 || chunk_size < 0 || count < 0 || chunk_size > abs_step || start + chunk_size > self->size || start + count * step - step < 0 || start + count * step - step + chunk_size > self->size) {
         MGLError_Set("size error");
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    if (!chunk_size || !count) {
+        return PyBytes_FromStringAndSize(0, 0);
+    }
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    const GLMethods & gl = self->context->gl;
 
-    char * read_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_READ_BIT);
+    char * read_ptr = map_chunks(self, chunk_size, start, step, count, GL_MAP_READ_BIT);
 
     if (!read_ptr) {
         MGLError_Set("cannot map the buffer");
@@ -1165,20 +1995,19 @@ static PyObject * MGLBuffer_read_chunks(MGLBuffer * self, PyObject * args) {
     }
 
     PyObject * data = PyBytes_FromStringAndSize(0, chunk_size * count);
-    char * write_ptr = PyBytes_AS_STRING(data);
-
-    read_ptr += start;
-    for (Py_ssize_t i = 0; i < count; ++i) {
-        memcpy(write_ptr, read_ptr, chunk_size);
-        write_ptr += chunk_size;
-        read_ptr += step;
+    if (!data) {
+        gl.UnmapBuffer(GL_ARRAY_BUFFER);
+        return 0;
     }
 
+    copy_chunks_unlocked(PyBytes_AS_STRING(data), chunk_size, read_ptr, step, chunk_size, count);
+
     gl.UnmapBuffer(GL_ARRAY_BUFFER);
     return data;
 }
 
 static PyObject * MGLBuffer_read_chunks_into(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     Py_ssize_t chunk_size;
     Py_ssize_t start;
@@ -1201,6 +2030,17 @@ static PyObject * MGLBuffer_read_chunks_into(MGLBuffer * self, PyObject * args)
         return 0;
     }
 
+    Py_ssize_t abs_step = step > 0 ? step : -step;
+
+    if (start < 0) {
+        start = self->size + start;
+    }
+
+    if (start < 0 || chunk_size < 0 || count < 0 || chunk_size > abs_step || start + chunk_size > self->size || start + count * step - step < 0 || start + count * step - step + chunk_size > self->size) {
+        MGLError_Set("size error");
+        return 0;
+    }
+
     Py_buffer buffer_view;
 
     int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_WRITABLE);
@@ -1209,122 +2049,343 @@ static PyObject * MGLBuffer_read_chunks_into(MGLBuffer * self, PyObject * args)
         return 0;
     }
 
-    const GLMethods & gl = self->context->gl;
+    if (write_offset < 0 || write_offset + chunk_size * count > buffer_view.len) {
+        MGLError_Set("buffer overflow");
+        PyBuffer_Release(&buffer_view);
+        return 0;
+    }
 
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    if (!chunk_size || !count) {
+        PyBuffer_Release(&buffer_view);
+        Py_RETURN_NONE;
+    }
+
+    const GLMethods & gl = self->context->gl;
 
-    char * read_ptr = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, GL_MAP_READ_BIT);
-    char * write_ptr = (char *)buffer_view.buf + write_offset;
+    char * read_ptr = map_chunks(self, chunk_size, start, step, count, GL_MAP_READ_BIT);
 
     if (!read_ptr) {
         MGLError_Set("cannot map the buffer");
+        PyBuffer_Release(&buffer_view);
         return 0;
     }
 
-    read_ptr += start;
-    for (Py_ssize_t i = 0; i < count; ++i) {
-        memcpy(write_ptr, read_ptr, chunk_size);
-        write_ptr += chunk_size;
-        read_ptr += step;
-    }
+    copy_chunks_unlocked((char *)buffer_view.buf + write_offset, chunk_size, read_ptr, step, chunk_size, count);
 
     gl.UnmapBuffer(GL_ARRAY_BUFFER);
     PyBuffer_Release(&buffer_view);
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLBuffer_clear(MGLBuffer * self, PyObject * args) {
-    Py_ssize_t size;
-    Py_ssize_t offset;
-    PyObject * chunk;
+// Copies below this many chunks issue one glCopyBufferSubData per chunk instead of a dispatch
+#define MGL_CHUNK_COPY_MIN_DISPATCH 64
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "nnO",
-        &size,
-        &offset,
-        &chunk
-    );
+// The packed and the strided side are both addressed in words: (src start, src step, dst start, dst step)
+static const char * chunk_copy_compute_shader = R"(
+    #version 430 core
 
-    if (!args_ok) {
-        return 0;
+    layout (local_size_x = 64) in;
+
+    layout (std430, binding = 0) readonly buffer Source {
+        uint src[];
+    };
+
+    layout (std430, binding = 1) writeonly buffer Destination {
+        uint dst[];
+    };
+
+    uniform ivec4 offsets;
+    uniform ivec2 shape;
+
+    void main() {
+        int index = int((gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x) * 64u + gl_LocalInvocationID.x);
+        int chunk = index / shape.x;
+        int word = index - chunk * shape.x;
+        if (chunk < shape.y) {
+            dst[offsets.z + chunk * offsets.w + word] = src[offsets.x + chunk * offsets.y + word];
+        }
     }
+)";
 
-    if (size < 0) {
-        size = self->size - offset;
+static bool chunk_copy_program(MGLContext * ctx) {
+    MGLChunkCopyProgram & program = ctx->chunk_copy;
+    if (program.program_obj) {
+        return true;
     }
 
-    Py_buffer buffer_view;
+    const GLMethods & gl = ctx->gl;
 
-    if (chunk != Py_None) {
-        int get_buffer = PyObject_GetBuffer(chunk, &buffer_view, PyBUF_SIMPLE);
-        if (get_buffer < 0) {
-            // Propagate the default error
-            return 0;
-        }
+    int shader_obj = gl.CreateShader(GL_COMPUTE_SHADER);
+    gl.ShaderSource(shader_obj, 1, &chunk_copy_compute_shader, NULL);
+    gl.CompileShader(shader_obj);
 
-        if (size % buffer_view.len != 0) {
-            MGLError_Set("the chunk does not fit the size");
-            PyBuffer_Release(&buffer_view);
-            return 0;
-        }
-    } else {
-        buffer_view.len = 0;
-        buffer_view.buf = 0;
+    int program_obj = gl.CreateProgram();
+    gl.AttachShader(program_obj, shader_obj);
+    gl.LinkProgram(program_obj);
+    gl.DetachShader(program_obj, shader_obj);
+    gl.DeleteShader(shader_obj);
+
+    int linked = GL_FALSE;
+    gl.GetProgramiv(program_obj, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+        gl.DeleteProgram(program_obj);
+        return false;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    // The copy borrows the last two storage buffer bindings and restores them afterwards
+    int last_binding = ctx->limits.max_shader_storage_buffer_bindings - 1;
+    gl.ShaderStorageBlockBinding(program_obj, gl.GetProgramResourceIndex(program_obj, GL_SHADER_STORAGE_BLOCK, "Source"), last_binding - 1);
+    gl.ShaderStorageBlockBinding(program_obj, gl.GetProgramResourceIndex(program_obj, GL_SHADER_STORAGE_BLOCK, "Destination"), last_binding);
 
-    char * map = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT);
+    program.program_obj = program_obj;
+    program.offsets_location = gl.GetUniformLocation(program_obj, "offsets");
+    program.shape_location = gl.GetUniformLocation(program_obj, "shape");
+    return true;
+}
 
-    if (!map) {
-        MGLError_Set("cannot map the buffer");
-        return 0;
+// Copies count chunks from src at src_start + i * src_step to dst at dst_start + i * dst_step without mapping either buffer
+static void copy_buffer_chunks(MGLContext * ctx, MGLBuffer * dst, Py_ssize_t dst_start, Py_ssize_t dst_step, MGLBuffer * src, Py_ssize_t src_start, Py_ssize_t src_step, Py_ssize_t chunk_size, Py_ssize_t count) {
+    const GLMethods & gl = ctx->gl;
+
+    gl.BindBuffer(GL_COPY_READ_BUFFER, src->buffer_obj);
+    gl.BindBuffer(GL_COPY_WRITE_BUFFER, dst->buffer_obj);
+
+    if (src_step == chunk_size && dst_step == chunk_size) {
+        gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, src_start, dst_start, chunk_size * count);
+        return;
     }
 
-    if (buffer_view.len) {
-        char * src = (char *)buffer_view.buf;
-        Py_ssize_t divisor = buffer_view.len;
+    bool aligned = !((chunk_size | src_start | src_step | dst_start | dst_step) & 3);
+    Py_ssize_t words = chunk_size / 4 * count;
+    Py_ssize_t groups = (words + 63) / 64;
+    Py_ssize_t max_groups = ctx->limits.max_compute_work_group_count[0];
+    bool dispatch = ctx->version_code >= 430 && aligned && count >= MGL_CHUNK_COPY_MIN_DISPATCH && max_groups > 0;
 
-        for (Py_ssize_t i = 0; i < size; ++i) {
-            map[i] = src[i % divisor];
+    if (dispatch && (groups + max_groups - 1) / max_groups > ctx->limits.max_compute_work_group_count[1]) {
+        dispatch = false;
+    }
+
+    if (!dispatch || !chunk_copy_program(ctx)) {
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, src_start + i * src_step, dst_start + i * dst_step, chunk_size);
         }
-    } else {
-        memset(map + offset, 0, size);
+        return;
     }
 
-    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    int bindings[2] = {ctx->limits.max_shader_storage_buffer_bindings - 2, ctx->limits.max_shader_storage_buffer_bindings - 1};
+    int previous_buffer[2];
+    GLint64 previous_start[2];
+    GLint64 previous_size[2];
 
-    if (chunk != Py_None) {
-        PyBuffer_Release(&buffer_view);
+    for (int i = 0; i < 2; ++i) {
+        gl.GetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, bindings[i], &previous_buffer[i]);
+        gl.GetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, bindings[i], &previous_start[i]);
+        gl.GetInteger64i_v(GL_SHADER_STORAGE_BUFFER_SIZE, bindings[i], &previous_size[i]);
     }
 
-    Py_RETURN_NONE;
+    // The current program is not restored, every draw and dispatch binds its own program first.
+    // A released program may be only flagged for deletion, binding it again would fail
+    const MGLChunkCopyProgram & program = ctx->chunk_copy;
+    gl.UseProgram(program.program_obj);
+    gl.BindBufferBase(GL_SHADER_STORAGE_BUFFER, bindings[0], src->buffer_obj);
+    gl.BindBufferBase(GL_SHADER_STORAGE_BUFFER, bindings[1], dst->buffer_obj);
+    gl.Uniform4i(program.offsets_location, (int)(src_start / 4), (int)(src_step / 4), (int)(dst_start / 4), (int)(dst_step / 4));
+    gl.Uniform2i(program.shape_location, (int)(chunk_size / 4), (int)count);
+
+    // Writes to the buffers before the copy are visible to the shader, the results to every later use
+    gl.MemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    Py_ssize_t groups_x = MGL_MIN(groups, max_groups);
+    gl.DispatchCompute((GLuint)groups_x, (GLuint)((groups + groups_x - 1) / groups_x), 1);
+    gl.MemoryBarrier(GL_ALL_BARRIER_BITS);
+
+    for (int i = 0; i < 2; ++i) {
+        if (previous_size[i]) {
+            gl.BindBufferRange(GL_SHADER_STORAGE_BUFFER, bindings[i], previous_buffer[i], (GLintptr)previous_start[i], (GLsizeiptr)previous_size[i]);
+        } else {
+            gl.BindBufferBase(GL_SHADER_STORAGE_BUFFER, bindings[i], previous_buffer[i]);
+        }
+    }
 }
 
-static PyObject * MGLBuffer_orphan(MGLBuffer * self, PyObject * args) {
-    Py_ssize_t size;
+// Shared by scatter and gather, the strided side is self and the packed side is other
+static PyObject * buffer_copy_chunks(MGLBuffer * self, PyObject * args, bool scatter) {
+    MGLModuleState * state = module_state(self);
+    MGLBuffer * other;
+    Py_ssize_t start;
+    Py_ssize_t step;
+    Py_ssize_t count;
+    Py_ssize_t chunk_size;
+    Py_ssize_t offset;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "n",
-        &size
+        "O!nnnnn",
+        MGLBuffer_type,
+        &other,
+        &start,
+        &step,
+        &count,
+        &chunk_size,
+        &offset
     );
 
     if (!args_ok) {
         return 0;
     }
 
-    if (size > 0) {
-        self->size = size;
+    Py_ssize_t abs_step = step > 0 ? step : -step;
+
+    if (start < 0) {
+        start = self->size + start;
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
-    gl.BufferData(GL_ARRAY_BUFFER, self->size, 0, self->dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-    Py_RETURN_NONE;
-}
+    if (start < 0 || chunk_size < 0 || count < 0 || chunk_size > abs_step || start + chunk_size > self->size || start + count * step - step < 0 || start + count * step - step + chunk_size > self->size) {
+        MGLError_Set("size error");
+        return 0;
+    }
+
+    if (offset < 0 || offset + chunk_size * count > other->size) {
+        MGLError_Set("buffer overflow");
+        return 0;
+    }
+
+    if (!chunk_size || !count) {
+        Py_RETURN_NONE;
+    }
+
+    if (other == self) {
+        Py_ssize_t first = step > 0 ? start : start + (count - 1) * step;
+        Py_ssize_t last = first + abs_step * (count - 1) + chunk_size;
+        if (offset < last && first < offset + chunk_size * count) {
+            MGLError_Set("the packed and the strided ranges overlap");
+            return 0;
+        }
+    }
+
+    if (scatter) {
+        copy_buffer_chunks(self->context, self, start, step, other, offset, chunk_size, chunk_size, count);
+    } else {
+        copy_buffer_chunks(self->context, other, offset, chunk_size, self, start, step, chunk_size, count);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_scatter(MGLBuffer * self, PyObject * args) {
+    return buffer_copy_chunks(self, args, true);
+}
+
+static PyObject * MGLBuffer_gather(MGLBuffer * self, PyObject * args) {
+    return buffer_copy_chunks(self, args, false);
+}
+
+static PyObject * MGLBuffer_clear(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    Py_ssize_t size;
+    Py_ssize_t offset;
+    PyObject * chunk;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "nnO",
+        &size,
+        &offset,
+        &chunk
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (size < 0) {
+        size = self->size - offset;
+    }
+
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        return 0;
+    }
+
+    Py_buffer buffer_view;
+
+    if (chunk != Py_None) {
+        int get_buffer = PyObject_GetBuffer(chunk, &buffer_view, PyBUF_SIMPLE);
+        if (get_buffer < 0) {
+            // Propagate the default error
+            return 0;
+        }
+
+        if (size % buffer_view.len != 0) {
+            MGLError_Set("the chunk does not fit the size");
+            PyBuffer_Release(&buffer_view);
+            return 0;
+        }
+    } else {
+        buffer_view.len = 0;
+        buffer_view.buf = 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+
+    char * map = (char *)gl.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT);
+
+    if (!map) {
+        MGLError_Set("cannot map the buffer");
+        return 0;
+    }
+
+    if (buffer_view.len) {
+        char * src = (char *)buffer_view.buf;
+        Py_ssize_t divisor = buffer_view.len;
+
+        for (Py_ssize_t i = 0; i < size; ++i) {
+            map[i] = src[i % divisor];
+        }
+    } else {
+        memset(map + offset, 0, size);
+    }
+
+    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+
+    if (chunk != Py_None) {
+        PyBuffer_Release(&buffer_view);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLBuffer_orphan(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    Py_ssize_t size;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "n",
+        &size
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    // The exported views point into the current storage
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        return 0;
+    }
+
+    if (size > 0) {
+        self->size = size;
+    }
+
+    const GLMethods & gl = self->context->gl;
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
+    gl.BufferData(GL_ARRAY_BUFFER, self->size, 0, self->dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    memory_track(self->context, MGL_MEMORY_BUFFER, self->buffer_obj, self->size);
+    Py_RETURN_NONE;
+}
 
 static PyObject * MGLBuffer_bind_to_uniform_block(MGLBuffer * self, PyObject * args) {
     int binding;
@@ -1379,13 +2440,22 @@ static PyObject * MGLBuffer_bind_to_storage_buffer(MGLBuffer * self, PyObject *
 }
 
 static PyObject * MGLBuffer_release(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     if (self->released || self->external) {
         Py_RETURN_NONE;
     }
+
+    // Deleting the buffer would leave the exported views pointing into a freed mapping
+    if (self->mapped) {
+        MGLError_Set("the buffer is mapped by a view");
+        return 0;
+    }
+
     self->released = true;
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteBuffers(1, (GLuint *)&self->buffer_obj);
+    memory_track(self->context, MGL_MEMORY_BUFFER, self->buffer_obj, 0);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -1399,6 +2469,12 @@ static PyObject * MGLBuffer_size(MGLBuffer * self, PyObject * args) {
 static int MGLBuffer_tp_as_buffer_get_view(MGLBuffer * self, Py_buffer * view, int flags) {
     int access = (flags == PyBUF_SIMPLE) ? GL_MAP_READ_BIT : (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
 
+    if (self->mapped) {
+        PyErr_Format(PyExc_BufferError, "the buffer is already mapped");
+        view->obj = 0;
+        return -1;
+    }
+
     const GLMethods & gl = self->context->gl;
     gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
     void * map = gl.MapBufferRange(GL_ARRAY_BUFFER, 0, self->size, access);
@@ -1409,6 +2485,7 @@ static int MGLBuffer_tp_as_buffer_get_view(MGLBuffer * self, Py_buffer * view, i
         return -1;
     }
 
+    self->mapped = true;
     view->buf = map;
     view->len = self->size;
     view->itemsize = 1;
@@ -1425,8 +2502,181 @@ static int MGLBuffer_tp_as_buffer_get_view(MGLBuffer * self, Py_buffer * view, i
 }
 
 static void MGLBuffer_tp_as_buffer_release_view(MGLBuffer * self, Py_buffer * view) {
+    // The buffer may have been unbound while the view was alive
     const GLMethods & gl = self->context->gl;
+    gl.BindBuffer(GL_ARRAY_BUFFER, self->buffer_obj);
     gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    self->mapped = false;
+}
+
+static PyObject * MGLBuffer_view(MGLBuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    const char * format;
+    Py_ssize_t itemsize;
+    PyObject * shape;
+    Py_ssize_t offset;
+    const char * access_str;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "snO!ns",
+        &format,
+        &itemsize,
+        &PyTuple_Type,
+        &shape,
+        &offset,
+        &access_str
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    int access = 0;
+    if (!strcmp(access_str, "r")) {
+        access = GL_MAP_READ_BIT;
+    } else if (!strcmp(access_str, "w")) {
+        access = GL_MAP_WRITE_BIT;
+    } else if (!strcmp(access_str, "rw")) {
+        access = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
+    } else {
+        MGLError_Set("invalid access: %s", access_str);
+        return 0;
+    }
+
+    int ndim = (int)PyTuple_GET_SIZE(shape);
+    if (ndim < 1 || ndim > MGL_VIEW_MAX_DIMS) {
+        MGLError_Set("the view must have 1 to %d dimensions", MGL_VIEW_MAX_DIMS);
+        return 0;
+    }
+
+    if (strlen(format) >= sizeof(((MGLBufferView *)0)->format) || itemsize < 1) {
+        MGLError_Set("invalid format: %s", format);
+        return 0;
+    }
+
+    MGLBufferView * view = PyObject_New(MGLBufferView, MGLBufferView_type);
+    view->map = NULL;
+    view->offset = offset;
+    view->access = access;
+    view->exports = 0;
+    view->ndim = ndim;
+    view->itemsize = itemsize;
+    strcpy(view->format, format);
+
+    // The strides are C contiguous
+    Py_ssize_t size = itemsize;
+    for (int i = ndim - 1; i >= 0; --i) {
+        view->shape[i] = PyNumber_AsSsize_t(PyTuple_GET_ITEM(shape, i), PyExc_OverflowError);
+        view->strides[i] = size;
+        // The byte size must not wrap around, it is checked against the buffer below
+        if (view->shape[i] <= 0 || view->shape[i] > PY_SSIZE_T_MAX / size) {
+            size = -1;
+            break;
+        }
+        size *= view->shape[i];
+    }
+
+    view->size = size;
+    view->buffer = self;
+    Py_INCREF(self);
+
+    if (PyErr_Occurred()) {
+        Py_DECREF(view);
+        return 0;
+    }
+
+    if (size < 1 || offset < 0 || offset + size > self->size) {
+        MGLError_Set("the view of %zd bytes at offset %zd does not fit in the buffer of %zd bytes", size, offset, self->size);
+        Py_DECREF(view);
+        return 0;
+    }
+
+    return (PyObject *)view;
+}
+
+static int MGLBufferView_tp_as_buffer_get_view(MGLBufferView * self, Py_buffer * view, int flags) {
+    if ((flags & PyBUF_WRITABLE) && !(self->access & GL_MAP_WRITE_BIT)) {
+        PyErr_Format(PyExc_BufferError, "the view is read only");
+        view->obj = 0;
+        return -1;
+    }
+
+    MGLBuffer * buffer = self->buffer;
+
+    if (buffer->released || buffer->context->released) {
+        PyErr_Format(PyExc_BufferError, "the buffer is released");
+        view->obj = 0;
+        return -1;
+    }
+
+    if (!self->exports && buffer->mapped) {
+        PyErr_Format(PyExc_BufferError, "the buffer is already mapped by another view");
+        view->obj = 0;
+        return -1;
+    }
+
+    if (!self->exports) {
+        // Mapped through its own binding, the buffer bound by other objects does not matter
+        const GLMethods & gl = buffer->context->gl;
+        if (gl.MapNamedBufferRange) {
+            self->map = (char *)gl.MapNamedBufferRange(buffer->buffer_obj, self->offset, self->size, self->access);
+        } else {
+            gl.BindBuffer(GL_COPY_WRITE_BUFFER, buffer->buffer_obj);
+            self->map = (char *)gl.MapBufferRange(GL_COPY_WRITE_BUFFER, self->offset, self->size, self->access);
+        }
+
+        if (!self->map) {
+            PyErr_Format(PyExc_BufferError, "cannot map the buffer");
+            view->obj = 0;
+            return -1;
+        }
+
+        buffer->mapped = true;
+    }
+
+    self->exports += 1;
+
+    view->buf = self->map;
+    view->len = self->size;
+    view->readonly = (self->access & GL_MAP_WRITE_BIT) ? 0 : 1;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+    view->ndim = self->ndim;
+    view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ? self->shape : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    Py_INCREF(self);
+    view->obj = (PyObject *)self;
+    return 0;
+}
+
+static void MGLBufferView_tp_as_buffer_release_view(MGLBufferView * self, Py_buffer * view) {
+    self->exports -= 1;
+
+    MGLBuffer * buffer = self->buffer;
+    if (self->exports || buffer->released || buffer->context->released) {
+        return;
+    }
+
+    const GLMethods & gl = buffer->context->gl;
+    if (gl.UnmapNamedBuffer) {
+        gl.UnmapNamedBuffer(buffer->buffer_obj);
+    } else {
+        gl.BindBuffer(GL_COPY_WRITE_BUFFER, buffer->buffer_obj);
+        gl.UnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    self->map = NULL;
+    buffer->mapped = false;
+}
+
+static void default_dealloc(PyObject * self);
+
+static void MGLBufferView_dealloc(MGLBufferView * self) {
+    Py_DECREF(self->buffer);
+    default_dealloc((PyObject *)self);
 }
 
 struct AttachmentParameters {
@@ -1438,7 +2688,7 @@ struct AttachmentParameters {
     int glo;
 };
 
-static int attachment_parameters(PyObject * attachment, AttachmentParameters * parameters, int must_be_depth) {
+static int attachment_parameters(MGLModuleState * state, PyObject * attachment, AttachmentParameters * parameters, int must_be_depth) {
     int width = 0, height = 0, samples = 0, renderbuffer = 0, glo = 0, depth = 0;
 
     if (Py_TYPE(attachment) == MGLTexture_type) {
@@ -1479,6 +2729,7 @@ static int attachment_parameters(PyObject * attachment, AttachmentParameters * p
 }
 
 static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * color_attachments_arg;
     PyObject * depth_attachment_arg;
 
@@ -1502,6 +2753,11 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
     MGLFramebuffer * framebuffer = PyObject_New(MGLFramebuffer, MGLFramebuffer_type);
     framebuffer->released = false;
 
+    framebuffer->resolve_framebuffer_obj = 0;
+    framebuffer->resolve_textures = NULL;
+    framebuffer->resolve_depth_texture = NULL;
+    framebuffer->resolve_draw_buffers = NULL;
+
     framebuffer->framebuffer_obj = 0;
     gl.GenFramebuffers(1, (GLuint *)&framebuffer->framebuffer_obj);
 
@@ -1517,7 +2773,7 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
 
     for (int i = 0; i < color_attachments_count; ++i) {
         PyObject * attachment = PyTuple_GetItem(color_attachments_arg, i);
-        if (!attachment_parameters(attachment, &params, false)) {
+        if (!attachment_parameters(state, attachment, &params, false)) {
             MGLError_Set("invalid color attachment");
             return NULL;
         }
@@ -1530,7 +2786,7 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
     }
 
     if (depth_attachment_arg != Py_None) {
-        if (!attachment_parameters(depth_attachment_arg, &params, true)) {
+        if (!attachment_parameters(state, depth_attachment_arg, &params, true)) {
             MGLError_Set("invalid depth attachment");
             return NULL;
         }
@@ -1616,6 +2872,7 @@ static PyObject * MGLContext_framebuffer(MGLContext * self, PyObject * args) {
 }
 
 static PyObject * MGLContext_empty_framebuffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
     int layers = 0;
@@ -1630,6 +2887,11 @@ static PyObject * MGLContext_empty_framebuffer(MGLContext * self, PyObject * arg
     MGLFramebuffer * framebuffer = PyObject_New(MGLFramebuffer, MGLFramebuffer_type);
     framebuffer->released = false;
 
+    framebuffer->resolve_framebuffer_obj = 0;
+    framebuffer->resolve_textures = NULL;
+    framebuffer->resolve_depth_texture = NULL;
+    framebuffer->resolve_draw_buffers = NULL;
+
     framebuffer->framebuffer_obj = 0;
     gl.GenFramebuffers(1, (GLuint *)&framebuffer->framebuffer_obj);
 
@@ -1718,12 +2980,26 @@ static PyObject * MGLContext_empty_framebuffer(MGLContext * self, PyObject * arg
     return Py_BuildValue("(O(ii)ii)", framebuffer, framebuffer->width, framebuffer->height, framebuffer->samples, framebuffer->framebuffer_obj);
 }
 
+static int resolve_attachments(MGLFramebuffer * self) {
+    return MGL_MAX(self->context->limits.max_color_attachments, self->draw_buffers_len);
+}
+
 static PyObject * MGLFramebuffer_release(MGLFramebuffer * self, PyObject * args) {
     if (self->released) {
         Py_RETURN_NONE;
     }
     self->released = true;
 
+    if (self->resolve_framebuffer_obj) {
+        self->context->gl.DeleteFramebuffers(1, (GLuint *)&self->resolve_framebuffer_obj);
+        for (int i = 0; i < resolve_attachments(self); ++i) {
+            Py_XDECREF(self->resolve_textures[i]);
+        }
+        Py_XDECREF(self->resolve_depth_texture);
+        delete[] self->resolve_textures;
+        delete[] self->resolve_draw_buffers;
+    }
+
     if (self->framebuffer_obj) {
         self->context->gl.DeleteFramebuffers(1, (GLuint *)&self->framebuffer_obj);
         Py_DECREF(self->context);
@@ -1734,6 +3010,7 @@ static PyObject * MGLFramebuffer_release(MGLFramebuffer * self, PyObject * args)
 }
 
 static PyObject * MGLFramebuffer_clear(MGLFramebuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     float r, g, b, a, depth;
     PyObject * viewport_arg;
 
@@ -1802,6 +3079,25 @@ static PyObject * MGLFramebuffer_clear(MGLFramebuffer * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
+// The bound framebuffer is swapped under the lock, the readers holding on to it take a new reference.
+// The old one is released outside the lock, its deallocation may run Python code
+static MGLFramebuffer * get_bound_framebuffer(MGLContext * ctx) {
+    MGLMutex_Lock(ctx->lock);
+    MGLFramebuffer * framebuffer = ctx->bound_framebuffer;
+    Py_INCREF(framebuffer);
+    MGLMutex_Unlock(ctx->lock);
+    return framebuffer;
+}
+
+static void set_bound_framebuffer(MGLContext * ctx, MGLFramebuffer * framebuffer) {
+    Py_INCREF(framebuffer);
+    MGLMutex_Lock(ctx->lock);
+    MGLFramebuffer * old = ctx->bound_framebuffer;
+    ctx->bound_framebuffer = framebuffer;
+    MGLMutex_Unlock(ctx->lock);
+    Py_DECREF(old);
+}
+
 static PyObject * MGLFramebuffer_use(MGLFramebuffer * self, PyObject * args) {
     const GLMethods & gl = self->context->gl;
 
@@ -1836,14 +3132,13 @@ static PyObject * MGLFramebuffer_use(MGLFramebuffer * self, PyObject * args) {
 
     gl.DepthMask(self->depth_mask);
 
-    Py_INCREF(self);
-    Py_DECREF(self->context->bound_framebuffer);
-    self->context->bound_framebuffer = self;
+    set_bound_framebuffer(self->context, self);
 
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     PyObject * viewport_arg;
     int components;
@@ -1853,10 +3148,11 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
 
     const char * dtype;
     Py_ssize_t write_offset;
+    int resolved = false;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "OOIIIpsn",
+        "OOIIIpsn|p",
         &data,
         &viewport_arg,
         &components,
@@ -1864,7 +3160,8 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
         &alignment,
         &clamp,
         &dtype,
-        &write_offset
+        &write_offset,
+        &resolved
     );
 
     if (!args_ok) {
@@ -1898,6 +3195,14 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
         read_depth = true;
     }
 
+    // Read from the resolve target populated by Framebuffer.resolve
+    int framebuffer_obj = resolved ? self->resolve_framebuffer_obj : self->framebuffer_obj;
+
+    if (resolved && !framebuffer_obj) {
+        MGLError_Set("the framebuffer was never resolved");
+        return 0;
+    }
+
     unsigned long long expected_size = (unsigned long long)viewport_rect.width * components * data_type->size;
     expected_size = (expected_size + alignment - 1) / alignment * alignment;
     expected_size = expected_size * viewport_rect.height;
@@ -1918,7 +3223,7 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
         }
 
         gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->buffer_obj);
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+        gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
         gl.ReadBuffer(read_depth ? GL_NONE : (GL_COLOR_ATTACHMENT0 + attachment));
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -1952,7 +3257,7 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
             gl.ClampColor(GL_CLAMP_READ_COLOR, GL_FIXED_ONLY);
         }
 
-        gl.BindFramebuffer(GL_FRAMEBUFFER, self->framebuffer_obj);
+        gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
         gl.ReadBuffer(read_depth ? GL_NONE : (GL_COLOR_ATTACHMENT0 + attachment));
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
@@ -1965,37 +3270,142 @@ static PyObject * MGLFramebuffer_read_into(MGLFramebuffer * self, PyObject * arg
     return PyLong_FromLong(expected_size);
 }
 
-static PyObject * MGLFramebuffer_get_viewport(MGLFramebuffer * self, void * closure) {
-    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
-}
+static PyObject * MGLFramebuffer_resolve(MGLFramebuffer * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    MGLTexture * texture;
+    int attachment;
 
-static int MGLFramebuffer_set_viewport(MGLFramebuffer * self, PyObject * value, void * closure) {
-    Rect viewport_rect = {};
-    if (!parse_rect(value, &viewport_rect)) {
-        MGLError_Set("wrong values in the viewport");
-        return -1;
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!i",
+        MGLTexture_type,
+        &texture,
+        &attachment
+    );
+
+    if (!args_ok) {
+        return 0;
     }
-    self->viewport = viewport_rect;
 
-    if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
-        const GLMethods & gl = self->context->gl;
+    bool resolve_depth = attachment == -1;
 
-        gl.Viewport(
-            self->viewport.x,
-            self->viewport.y,
-            self->viewport.width,
-            self->viewport.height
-        );
+    if (attachment < -1 || attachment >= self->draw_buffers_len) {
+        MGLError_Set("invalid attachment %d", attachment);
+        return 0;
     }
 
-    return 0;
-}
+    if (texture->samples) {
+        MGLError_Set("the resolve target must not be multisampled");
+        return 0;
+    }
 
-static PyObject * MGLFramebuffer_get_scissor(MGLFramebuffer * self, void * closure) {
+    if (texture->depth != resolve_depth) {
+        MGLError_Set(resolve_depth ? "the resolve target must be a depth texture" : "the resolve target must be a color texture");
+        return 0;
+    }
+
+    if (texture->width != self->width || texture->height != self->height) {
+        MGLError_Set("the resolve target size does not match the framebuffer");
+        return 0;
+    }
+
+    if (texture->released) {
+        MGLError_Set("the resolve target is released");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    if (!self->resolve_framebuffer_obj) {
+        gl.GenFramebuffers(1, (GLuint *)&self->resolve_framebuffer_obj);
+
+        if (!self->resolve_framebuffer_obj) {
+            MGLError_Set("cannot create framebuffer");
+            return 0;
+        }
+
+        self->resolve_textures = new MGLTexture * [resolve_attachments(self)]();
+        self->resolve_draw_buffers = new unsigned[resolve_attachments(self)];
+    }
+
+    gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, self->resolve_framebuffer_obj);
+
+    // Only re-attach when the cached target changed.
+    // The textures are compared by object, a released texture may hand its name to a new one
+    MGLTexture ** attached = resolve_depth ? &self->resolve_depth_texture : &self->resolve_textures[attachment];
+    if (*attached != texture) {
+        int attachment_point = resolve_depth ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0 + attachment;
+        gl.FramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment_point, GL_TEXTURE_2D, texture->texture_obj, 0);
+        Py_INCREF(texture);
+        Py_XDECREF(*attached);
+        *attached = texture;
+    }
+
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, self->framebuffer_obj);
+
+    if (resolve_depth) {
+        gl.BlitFramebuffer(
+            0, 0, self->width, self->height,
+            0, 0, self->width, self->height,
+            GL_DEPTH_BUFFER_BIT,
+            GL_NEAREST
+        );
+    } else {
+        // Blit the requested attachment only
+        unsigned * draw_buffers = self->resolve_draw_buffers;
+        for (int i = 0; i < attachment; ++i) {
+            draw_buffers[i] = GL_NONE;
+        }
+        draw_buffers[attachment] = GL_COLOR_ATTACHMENT0 + attachment;
+
+        gl.ReadBuffer(self->framebuffer_obj ? GL_COLOR_ATTACHMENT0 + attachment : self->draw_buffers[0]);
+        gl.DrawBuffers(attachment + 1, draw_buffers);
+        gl.BlitFramebuffer(
+            0, 0, self->width, self->height,
+            0, 0, self->width, self->height,
+            GL_COLOR_BUFFER_BIT,
+            GL_NEAREST
+        );
+    }
+
+    gl.BindFramebuffer(GL_FRAMEBUFFER, self->context->bound_framebuffer->framebuffer_obj);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLFramebuffer_get_viewport(MGLFramebuffer * self, void * closure) {
+    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
+}
+
+static int MGLFramebuffer_set_viewport(MGLFramebuffer * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
+    Rect viewport_rect = {};
+    if (!parse_rect(value, &viewport_rect)) {
+        MGLError_Set("wrong values in the viewport");
+        return -1;
+    }
+    self->viewport = viewport_rect;
+
+    if (self->framebuffer_obj == self->context->bound_framebuffer->framebuffer_obj) {
+        const GLMethods & gl = self->context->gl;
+
+        gl.Viewport(
+            self->viewport.x,
+            self->viewport.y,
+            self->viewport.width,
+            self->viewport.height
+        );
+    }
+
+    return 0;
+}
+
+static PyObject * MGLFramebuffer_get_scissor(MGLFramebuffer * self, void * closure) {
     return Py_BuildValue("(iiii)", self->scissor.x, self->scissor.y, self->scissor.width, self->scissor.height);
 }
 
 static int MGLFramebuffer_set_scissor(MGLFramebuffer * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (value == Py_None) {
         self->scissor = rect(0, 0, self->width, self->height);
         self->scissor_enabled = false;
@@ -2071,6 +3481,7 @@ static int parse_mask(PyObject * arg, char * value) {
 }
 
 static int MGLFramebuffer_set_color_mask(MGLFramebuffer * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (self->draw_buffers_len == 1) {
         if (!parse_mask(value, &self->color_mask[0])) {
             MGLError_Set("invalid color mask");
@@ -2110,6 +3521,7 @@ static PyObject * MGLFramebuffer_get_depth_mask(MGLFramebuffer * self, void * cl
 }
 
 static int MGLFramebuffer_set_depth_mask(MGLFramebuffer * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (value == Py_True) {
         self->depth_mask = true;
     } else if (value == Py_False) {
@@ -2128,6 +3540,7 @@ static int MGLFramebuffer_set_depth_mask(MGLFramebuffer * self, PyObject * value
 }
 
 static PyObject * MGLFramebuffer_get_bits(MGLFramebuffer * self, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (self->framebuffer_obj) {
         MGLError_Set("only the default_framebuffer have bits");
         return 0;
@@ -2178,6 +3591,7 @@ static PyObject * MGLFramebuffer_get_bits(MGLFramebuffer * self, void * closure)
 }
 
 static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * shaders[8];
     PyObject * varyings_arg;
     PyObject * fragment_outputs;
@@ -2250,7 +3664,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         }
 
         if (PyUnicode_Check(shaders[i])) {
-            shaders[i] = PyObject_CallMethod(helper, "resolve_includes", "(ON)", self, shaders[i]);
+            shaders[i] = PyObject_CallMethod(state->helper, "resolve_includes", "(ON)", self, shaders[i]);
             if (!shaders[i]) {
                 return NULL;
             }
@@ -2537,7 +3951,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         clean_glsl_name(name, name_len);
 
         PyObject * item = PyObject_CallMethod(
-            helper, "make_attribute", "(siiOi)",
+            state->helper, "make_attribute", "(siiOi)",
             name, type, program->program_obj, location, array_length
         );
 
@@ -2557,7 +3971,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
 
         gl.GetTransformFeedbackVarying(program->program_obj, i, 256, &name_len, &array_length, (GLenum *)&type, name);
 
-        PyObject * item = PyObject_CallMethod(helper, "make_varying", "(siii)", name, i, array_length, dimension);
+        PyObject * item = PyObject_CallMethod(state->helper, "make_varying", "(siii)", name, i, array_length, dimension);
         PyDict_SetItemString(members_dict, name, item);
         Py_DECREF(item);
     }
@@ -2578,7 +3992,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         }
 
         PyObject * item = PyObject_CallMethod(
-            helper, "make_uniform", "(siiiiO)",
+            state->helper, "make_uniform", "(siiiiO)",
             name, type, program->program_obj, location, array_length, self
         );
 
@@ -2598,7 +4012,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         clean_glsl_name(name, name_len);
 
         PyObject * item = PyObject_CallMethod(
-            helper, "make_uniform_block", "(siiiO)",
+            state->helper, "make_uniform_block", "(siiiO)",
             name, program->program_obj, index, size, self
         );
 
@@ -2614,7 +4028,7 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
         clean_glsl_name(name, name_len);
 
         PyObject * item = PyObject_CallMethod(
-            helper, "make_storage_block", "(siiO)",
+            state->helper, "make_storage_block", "(siiO)",
             name, program_obj, i, self
         );
 
@@ -2632,12 +4046,21 @@ static PyObject * MGLContext_program(MGLContext * self, PyObject * args) {
     return Py_BuildValue("(ONNNi)", program, members_and_attributes, PyTuple_New(0), geom_info, program->program_obj);
 }
 
-static PyObject * MGLProgram_run(MGLProgram * self, PyObject * args) {
-    unsigned x;
-    unsigned y;
-    unsigned z;
+static PyObject * MGLProgram_run(MGLProgram * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"group_x", "group_y", "group_z"};
+    PyObject * values[3];
+    int x;
+    int y;
+    int z;
 
-    if (!PyArg_ParseTuple( args, "III", &x, &y, &z)) {
+    int args_ok = (
+        fastcall_args("run", args, nargs, kwnames, keywords, 0, 3, values) &&
+        fastcall_int(values[0], 1, &x) &&
+        fastcall_int(values[1], 1, &y) &&
+        fastcall_int(values[2], 1, &z)
+    );
+
+    if (!args_ok) {
         return 0;
     }
 
@@ -2649,6 +4072,7 @@ static PyObject * MGLProgram_run(MGLProgram * self, PyObject * args) {
 }
 
 static PyObject * MGLProgram_run_indirect(MGLProgram * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLBuffer * buffer;
     Py_ssize_t offset = 0;
 
@@ -2680,6 +4104,7 @@ static PyObject * MGLProgram_draw_mesh_tasks(MGLProgram * self, PyObject * args)
 }
 
 static PyObject * MGLProgram_draw_mesh_tasks_indirect(MGLProgram * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLBuffer * buffer;
     Py_ssize_t offset = 0;
     Py_ssize_t drawcount = 1;
@@ -2698,6 +4123,7 @@ static PyObject * MGLProgram_draw_mesh_tasks_indirect(MGLProgram * self, PyObjec
 }
 
 static PyObject * MGLProgram_draw_mesh_tasks_indirect_count(MGLProgram * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLBuffer * buffer;
     Py_ssize_t offset = 0;
     Py_ssize_t drawcount_offset = 0;
@@ -2730,26 +4156,34 @@ static PyObject * MGLProgram_release(MGLProgram * self, PyObject * args) {
 }
 
 static PyObject * MGLContext_query(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int samples_passed;
     int any_samples_passed;
     int time_elapsed;
     int primitives_generated;
+    int statistics;
 
     int args_ok = PyArg_ParseTuple(
         args,
-        "pppp",
+        "ppppp",
         &samples_passed,
         &any_samples_passed,
         &time_elapsed,
-        &primitives_generated
+        &primitives_generated,
+        &statistics
     );
 
     if (!args_ok) {
         return 0;
     }
 
+    if (statistics && self->version_code < 460 && !has_extension(self, "GL_ARB_pipeline_statistics_query")) {
+        MGLError_Set("pipeline statistics queries are not supported");
+        return 0;
+    }
+
     // If none of them is set, all will be set.
-    if (!(samples_passed + any_samples_passed + time_elapsed + primitives_generated)) {
+    if (!(samples_passed + any_samples_passed + time_elapsed + primitives_generated + statistics)) {
         samples_passed = 1;
         any_samples_passed = 1;
         time_elapsed = 1;
@@ -2761,6 +4195,7 @@ static PyObject * MGLContext_query(MGLContext * self, PyObject * args) {
     query->query_obj[ANY_SAMPLES_PASSED] = 0;
     query->query_obj[TIME_ELAPSED] = 0;
     query->query_obj[PRIMITIVES_GENERATED] = 0;
+    memset(query->statistics_obj, 0, sizeof(query->statistics_obj));
     query->released = false;
 
     Py_INCREF(self);
@@ -2783,11 +4218,15 @@ static PyObject * MGLContext_query(MGLContext * self, PyObject * args) {
     if (primitives_generated) {
         gl.GenQueries(1, (GLuint *)&query->query_obj[PRIMITIVES_GENERATED]);
     }
+    if (statistics) {
+        gl.GenQueries(MGL_PIPELINE_STATISTICS, (GLuint *)query->statistics_obj);
+    }
 
     return (PyObject *)query;
 }
 
 static PyObject * MGLQuery_begin(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     if (self->state != QUERY_INACTIVE) {
         MGLError_Set(self->state == QUERY_ACTIVE ? "this query is already running" : "this query is in conditional render mode");
         return NULL;
@@ -2811,11 +4250,18 @@ static PyObject * MGLQuery_begin(MGLQuery * self, PyObject * args) {
         gl.BeginQuery(GL_PRIMITIVES_GENERATED, self->query_obj[PRIMITIVES_GENERATED]);
     }
 
+    if (self->statistics_obj[0]) {
+        for (int i = 0; i < MGL_PIPELINE_STATISTICS; ++i) {
+            gl.BeginQuery(pipeline_statistics_targets[i], self->statistics_obj[i]);
+        }
+    }
+
     self->state = QUERY_ACTIVE;
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLQuery_end(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     if (self->state != QUERY_ACTIVE) {
         MGLError_Set(self->state == QUERY_INACTIVE ? "this query was not started" : "this query is in conditional render mode");
         return NULL;
@@ -2839,12 +4285,19 @@ static PyObject * MGLQuery_end(MGLQuery * self, PyObject * args) {
         gl.EndQuery(GL_PRIMITIVES_GENERATED);
     }
 
+    if (self->statistics_obj[0]) {
+        for (int i = 0; i < MGL_PIPELINE_STATISTICS; ++i) {
+            gl.EndQuery(pipeline_statistics_targets[i]);
+        }
+    }
+
     self->state = QUERY_INACTIVE;
     self->ended = true;
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLQuery_begin_render(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     if (self->state != QUERY_INACTIVE) {
         MGLError_Set(self->state == QUERY_ACTIVE ? "this query was not stopped" : "this query is already in conditional render mode");
         return NULL;
@@ -2861,83 +4314,671 @@ static PyObject * MGLQuery_begin_render(MGLQuery * self, PyObject * args) {
         return NULL;
     }
 
-    self->state = QUERY_CONDITIONAL_RENDER;
-    Py_RETURN_NONE;
-}
+    self->state = QUERY_CONDITIONAL_RENDER;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLQuery_end_render(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    if (self->state != QUERY_CONDITIONAL_RENDER) {
+        MGLError_Set("this query is not in conditional render mode");
+        return NULL;
+    }
+
+    const GLMethods & gl = self->context->gl;
+    gl.EndConditionalRender();
+    self->state = QUERY_INACTIVE;
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLQuery_get_samples(MGLQuery * self, void * closure) {
+    MGLModuleState * state = module_state(self);
+    if (!self->query_obj[SAMPLES_PASSED]) {
+        MGLError_Set("query created without the samples_passed flag");
+        return NULL;
+    }
+
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return NULL;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    unsigned samples = 0;
+    if (self->ended) {
+        gl.GetQueryObjectuiv(self->query_obj[SAMPLES_PASSED], GL_QUERY_RESULT, &samples);
+    }
+
+    return PyLong_FromUnsignedLong(samples);
+}
+
+static PyObject * MGLQuery_get_primitives(MGLQuery * self, void * closure) {
+    MGLModuleState * state = module_state(self);
+    if (!self->query_obj[PRIMITIVES_GENERATED]) {
+        MGLError_Set("query created without the primitives_generated flag");
+        return NULL;
+    }
+
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return NULL;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    unsigned primitives = 0;
+    if (self->ended) {
+        gl.GetQueryObjectuiv(self->query_obj[PRIMITIVES_GENERATED], GL_QUERY_RESULT, &primitives);
+    }
+
+    return PyLong_FromUnsignedLong(primitives);
+}
+
+static PyObject * MGLQuery_get_elapsed(MGLQuery * self, void * closure) {
+    MGLModuleState * state = module_state(self);
+    if (!self->query_obj[TIME_ELAPSED]) {
+        MGLError_Set("query created without the time_elapsed flag");
+        return NULL;
+    }
+
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return NULL;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    unsigned elapsed = 0;
+    if (self->ended) {
+        gl.GetQueryObjectuiv(self->query_obj[TIME_ELAPSED], GL_QUERY_RESULT, &elapsed);
+    }
+
+    return PyLong_FromUnsignedLong(elapsed);
+}
+
+static PyObject * query_statistics(MGLQuery * self) {
+    const GLMethods & gl = self->context->gl;
+
+    PyObject * res = PyDict_New();
+    for (int i = 0; i < MGL_PIPELINE_STATISTICS; ++i) {
+        GLuint64 value = 0;
+        if (self->ended) {
+            gl.GetQueryObjectui64v(self->statistics_obj[i], GL_QUERY_RESULT, &value);
+        }
+        PyObject * value_py = PyLong_FromUnsignedLongLong(value);
+        PyDict_SetItemString(res, pipeline_statistics_names[i], value_py);
+        Py_DECREF(value_py);
+    }
+
+    return res;
+}
+
+static PyObject * MGLQuery_get_statistics(MGLQuery * self, void * closure) {
+    MGLModuleState * state = module_state(self);
+    if (!self->statistics_obj[0]) {
+        MGLError_Set("query created without the statistics flag");
+        return NULL;
+    }
+
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return NULL;
+    }
+
+    return query_statistics(self);
+}
+
+static PyObject * MGLQuery_get_available(MGLQuery * self, void * closure) {
+    if (self->state == QUERY_ACTIVE || !self->ended) {
+        Py_RETURN_FALSE;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            unsigned available = 0;
+            gl.GetQueryObjectuiv(self->query_obj[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                Py_RETURN_FALSE;
+            }
+        }
+    }
+
+    if (self->statistics_obj[0]) {
+        unsigned available = 0;
+        gl.GetQueryObjectuiv(self->statistics_obj[MGL_PIPELINE_STATISTICS - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            Py_RETURN_FALSE;
+        }
+    }
+
+    Py_RETURN_TRUE;
+}
+
+static PyObject * MGLQuery_try_get(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return NULL;
+    }
+
+    PyObject * available = MGLQuery_get_available(self, NULL);
+    Py_DECREF(available);
+
+    if (available != Py_True) {
+        Py_RETURN_NONE;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    static const char * keys[] = {"samples", "any_samples", "elapsed", "primitives"};
+
+    PyObject * res = PyDict_New();
+    for (int i = 0; i < 4; ++i) {
+        if (self->query_obj[i]) {
+            GLuint64 value = 0;
+            gl.GetQueryObjectui64v(self->query_obj[i], GL_QUERY_RESULT, &value);
+            PyObject * value_py = PyLong_FromUnsignedLongLong(value);
+            PyDict_SetItemString(res, keys[i], value_py);
+            Py_DECREF(value_py);
+        }
+    }
+
+    if (self->statistics_obj[0]) {
+        PyObject * statistics = query_statistics(self);
+        PyDict_SetItemString(res, "statistics", statistics);
+        Py_DECREF(statistics);
+    }
+
+    return res;
+}
+
+static PyObject * MGLQuery_write_to(MGLQuery * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    MGLBuffer * buffer;
+    Py_ssize_t offset;
+    int key;
+    int wide;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!nIp",
+        MGLBuffer_type,
+        &buffer,
+        &offset,
+        &key,
+        &wide
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (key > PRIMITIVES_GENERATED || !self->query_obj[key]) {
+        MGLError_Set("query created without the requested flag");
+        return 0;
+    }
+
+    if (self->state == QUERY_ACTIVE) {
+        MGLError_Set("this query was not stopped");
+        return 0;
+    }
+
+    // A query object without a result is an invalid operation
+    if (!self->ended) {
+        MGLError_Set("this query was never run");
+        return 0;
+    }
+
+    if (self->context->version_code < 440 && !has_extension(self->context, "GL_ARB_query_buffer_object")) {
+        MGLError_Set("query buffer objects are not supported");
+        return 0;
+    }
+
+    Py_ssize_t size = wide ? 8 : 4;
+
+    if (offset < 0 || offset % size || offset + size > buffer->size) {
+        MGLError_Set("invalid offset = %d", offset);
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    // The result is written by the GPU, the CPU does not wait for it
+    gl.BindBuffer(GL_QUERY_BUFFER, buffer->buffer_obj);
+    if (wide) {
+        gl.GetQueryObjectui64v(self->query_obj[key], GL_QUERY_RESULT, (GLuint64 *)offset);
+    } else {
+        gl.GetQueryObjectuiv(self->query_obj[key], GL_QUERY_RESULT, (GLuint *)offset);
+    }
+    gl.BindBuffer(GL_QUERY_BUFFER, 0);
+
+    Py_RETURN_NONE;
+}
+
+// Expands an AABB to a 14 vertex triangle strip cube using gl_VertexID
+static const char * occlusion_culler_vertex_shader = R"(
+    #version 330 core
+
+    uniform mat4 mvp;
+
+    layout (location = 0) in vec3 in_min;
+    layout (location = 1) in vec3 in_max;
+
+    void main() {
+        int bit = 1 << gl_VertexID;
+        vec3 corner = vec3((0x287a & bit) != 0, (0x02af & bit) != 0, (0x31e3 & bit) != 0);
+        gl_Position = mvp * vec4(mix(in_min, in_max, corner), 1.0);
+    }
+)";
+
+static const char * occlusion_culler_fragment_shader = R"(
+    #version 330 core
+
+    void main() {
+    }
+)";
+
+static PyObject * MGLContext_occlusion_culler(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int max_objects;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &max_objects
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (max_objects < 1) {
+        MGLError_Set("max_objects must be positive");
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    int shaders[2] = {(int)gl.CreateShader(GL_VERTEX_SHADER), (int)gl.CreateShader(GL_FRAGMENT_SHADER)};
+    const char * sources[2] = {occlusion_culler_vertex_shader, occlusion_culler_fragment_shader};
+
+    int program_obj = gl.CreateProgram();
+    for (int i = 0; i < 2; ++i) {
+        gl.ShaderSource(shaders[i], 1, &sources[i], NULL);
+        gl.CompileShader(shaders[i]);
+        gl.AttachShader(program_obj, shaders[i]);
+    }
+
+    gl.LinkProgram(program_obj);
+
+    for (int i = 0; i < 2; ++i) {
+        gl.DetachShader(program_obj, shaders[i]);
+        gl.DeleteShader(shaders[i]);
+    }
+
+    int linked = GL_FALSE;
+    gl.GetProgramiv(program_obj, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+        gl.DeleteProgram(program_obj);
+        MGLError_Set("cannot create the occlusion culler program");
+        return 0;
+    }
+
+    MGLOcclusionCuller * culler = PyObject_New(MGLOcclusionCuller, MGLOcclusionCuller_type);
+    culler->released = false;
+    culler->max_objects = max_objects;
+    culler->program_obj = program_obj;
+    culler->mvp_location = gl.GetUniformLocation(program_obj, "mvp");
+
+    // Conservative queries need GL 4.3 or ARB_ES3_compatibility, exact ones are core since 3.3
+    bool conservative = self->version_code >= 430 || has_extension(self, "GL_ARB_ES3_compatibility");
+    culler->query_target = conservative ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+    culler->base_instance = self->version_code >= 420 || has_extension(self, "GL_ARB_base_instance");
+
+    culler->vertex_array_obj = 0;
+    gl.GenVertexArrays(1, (GLuint *)&culler->vertex_array_obj);
+    gl.BindVertexArray(culler->vertex_array_obj);
+    gl.EnableVertexAttribArray(0);
+    gl.EnableVertexAttribArray(1);
+
+    // Every vertex of the proxy cube reads the same bounding box
+    gl.VertexAttribDivisor(0, 1);
+    gl.VertexAttribDivisor(1, 1);
+
+    culler->queries = new GLuint[max_objects];
+    gl.GenQueries(max_objects, culler->queries);
+
+    // Objects are visible until a query proves otherwise
+    culler->pending = new unsigned char[max_objects]();
+    culler->visible = new unsigned char[(max_objects + 7) / 8];
+    memset(culler->visible, 0, (max_objects + 7) / 8);
+    for (int i = 0; i < max_objects; ++i) {
+        culler->visible[i / 8] |= 1 << (i % 8);
+    }
+
+    Py_INCREF(self);
+    culler->context = self;
+
+    Py_INCREF(culler);
+    return (PyObject *)culler;
+}
+
+static void occlusion_culler_collect(MGLOcclusionCuller * self) {
+    const GLMethods & gl = self->context->gl;
+
+    for (int i = 0; i < self->max_objects; ++i) {
+        if (!self->pending[i]) {
+            continue;
+        }
+
+        unsigned available = 0;
+        gl.GetQueryObjectuiv(self->queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available) {
+            unsigned passed = 0;
+            gl.GetQueryObjectuiv(self->queries[i], GL_QUERY_RESULT, &passed);
+
+            if (passed) {
+                self->visible[i / 8] |= 1 << (i % 8);
+            } else {
+                self->visible[i / 8] &= ~(1 << (i % 8));
+            }
+
+            self->pending[i] = 0;
+        }
+    }
+}
+
+static PyObject * MGLOcclusionCuller_test(MGLOcclusionCuller * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    MGLBuffer * buffer;
+    int count;
+    Py_buffer mvp;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!Iy*",
+        MGLBuffer_type,
+        &buffer,
+        &count,
+        &mvp
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (mvp.len != 64) {
+        MGLError_Set("the mvp must be 16 floats not %d bytes", mvp.len);
+        PyBuffer_Release(&mvp);
+        return 0;
+    }
+
+    if (count > self->max_objects || (Py_ssize_t)count * 24 > buffer->size) {
+        MGLError_Set("too many objects %d", count);
+        PyBuffer_Release(&mvp);
+        return 0;
+    }
+
+    MGLContext * ctx = self->context;
+    const GLMethods & gl = ctx->gl;
+
+    // Results from the previous frames are read first so the queries can be reused
+    occlusion_culler_collect(self);
+
+    gl.UseProgram(self->program_obj);
+    gl.UniformMatrix4fv(self->mvp_location, 1, false, (float *)mvp.buf);
+    PyBuffer_Release(&mvp);
+
+    gl.BindVertexArray(self->vertex_array_obj);
+    gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
+
+    gl.ColorMask(false, false, false, false);
+    gl.DepthMask(false);
+
+    if (~ctx->enable_flags & MGL_DEPTH_TEST) {
+        gl.Enable(GL_DEPTH_TEST);
+    }
+
+    if (ctx->enable_flags & MGL_CULL_FACE) {
+        gl.Disable(GL_CULL_FACE);
+    }
+
+    int issued = 0;
+
+    // Every object needs its own query, so each proxy is a separate draw.
+    // With base instances the bounding box is picked by the instance, the attributes are set up once
+    if (self->base_instance) {
+        gl.VertexAttribPointer(0, 3, GL_FLOAT, false, 24, (void *)0);
+        gl.VertexAttribPointer(1, 3, GL_FLOAT, false, 24, (void *)12);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        // Objects still waiting for a result keep their last visibility
+        if (self->pending[i]) {
+            continue;
+        }
+
+        gl.BeginQuery(self->query_target, self->queries[i]);
+        if (self->base_instance) {
+            gl.DrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 14, 1, i);
+        } else {
+            char * ptr = (char *)((Py_ssize_t)i * 24);
+            gl.VertexAttribPointer(0, 3, GL_FLOAT, false, 24, ptr);
+            gl.VertexAttribPointer(1, 3, GL_FLOAT, false, 24, ptr + 12);
+            gl.DrawArrays(GL_TRIANGLE_STRIP, 0, 14);
+        }
+        gl.EndQuery(self->query_target);
+
+        self->pending[i] = 1;
+        issued += 1;
+    }
+
+    if (~ctx->enable_flags & MGL_DEPTH_TEST) {
+        gl.Disable(GL_DEPTH_TEST);
+    }
+
+    if (ctx->enable_flags & MGL_CULL_FACE) {
+        gl.Enable(GL_CULL_FACE);
+    }
+
+    MGLFramebuffer * framebuffer = get_bound_framebuffer(ctx);
+
+    if (framebuffer->draw_buffers_len == 1) {
+        gl.ColorMask(framebuffer->color_mask[0] & 1, framebuffer->color_mask[0] & 2, framebuffer->color_mask[0] & 4, framebuffer->color_mask[0] & 8);
+    } else {
+        for (int i = 0; i < framebuffer->draw_buffers_len; ++i) {
+            gl.ColorMaski(i, framebuffer->color_mask[i] & 1, framebuffer->color_mask[i] & 2, framebuffer->color_mask[i] & 4, framebuffer->color_mask[i] & 8);
+        }
+    }
+
+    gl.DepthMask(framebuffer->depth_mask);
+    Py_DECREF(framebuffer);
+
+    return PyLong_FromLong(issued);
+}
+
+static PyObject * MGLOcclusionCuller_collect(MGLOcclusionCuller * self, PyObject * args) {
+    occlusion_culler_collect(self);
+    return PyBytes_FromStringAndSize((char *)self->visible, (self->max_objects + 7) / 8);
+}
+
+static PyObject * MGLOcclusionCuller_is_visible(MGLOcclusionCuller * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int index;
+
+    if (!PyArg_ParseTuple(args, "i", &index)) {
+        return 0;
+    }
+
+    if (index < 0 || index >= self->max_objects) {
+        MGLError_Set("invalid index %d", index);
+        return 0;
+    }
+
+    return PyBool_FromLong(self->visible[index / 8] & (1 << (index % 8)));
+}
+
+static PyObject * MGLOcclusionCuller_begin_render(MGLOcclusionCuller * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int index;
+
+    if (!PyArg_ParseTuple(args, "i", &index)) {
+        return 0;
+    }
+
+    if (index < 0 || index >= self->max_objects) {
+        MGLError_Set("invalid index %d", index);
+        return 0;
+    }
+
+    // Objects never tested are always rendered
+    const GLMethods & gl = self->context->gl;
+    if (self->pending[index] || !(self->visible[index / 8] & (1 << (index % 8)))) {
+        gl.BeginConditionalRender(self->queries[index], GL_QUERY_NO_WAIT);
+        Py_RETURN_TRUE;
+    }
+
+    Py_RETURN_FALSE;
+}
+
+static PyObject * MGLOcclusionCuller_end_render(MGLOcclusionCuller * self, PyObject * args) {
+    self->context->gl.EndConditionalRender();
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLOcclusionCuller_release(MGLOcclusionCuller * self, PyObject * args) {
+    if (self->released) {
+        Py_RETURN_NONE;
+    }
+    self->released = true;
+
+    const GLMethods & gl = self->context->gl;
+    gl.DeleteQueries(self->max_objects, self->queries);
+    gl.DeleteVertexArrays(1, (GLuint *)&self->vertex_array_obj);
+    gl.DeleteProgram(self->program_obj);
+
+    delete[] self->queries;
+    delete[] self->pending;
+    delete[] self->visible;
+
+    Py_DECREF(self->context);
+    Py_DECREF(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_timestamp_queries(MGLContext * self, PyObject * args) {
+    int count;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &count
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    GLuint * queries = new GLuint[count];
+    gl.GenQueries(count, queries);
+
+    PyObject * res = PyTuple_New(count);
+    for (int i = 0; i < count; ++i) {
+        PyTuple_SET_ITEM(res, i, PyLong_FromUnsignedLong(queries[i]));
+    }
+
+    delete[] queries;
+    return res;
+}
+
+static PyObject * MGLContext_delete_queries(MGLContext * self, PyObject * args) {
+    PyObject * queries;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!",
+        &PyTuple_Type,
+        &queries
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
 
-static PyObject * MGLQuery_end_render(MGLQuery * self, PyObject * args) {
-    if (self->state != QUERY_CONDITIONAL_RENDER) {
-        MGLError_Set("this query is not in conditional render mode");
-        return NULL;
+    int count = (int)PyTuple_GET_SIZE(queries);
+    for (int i = 0; i < count; ++i) {
+        GLuint query_obj = PyLong_AsUnsignedLong(PyTuple_GET_ITEM(queries, i));
+        gl.DeleteQueries(1, &query_obj);
     }
 
-    const GLMethods & gl = self->context->gl;
-    gl.EndConditionalRender();
-    self->state = QUERY_INACTIVE;
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLQuery_get_samples(MGLQuery * self, void * closure) {
-    if (!self->query_obj[SAMPLES_PASSED]) {
-        MGLError_Set("query created without the samples_passed flag");
-        return NULL;
-    }
-
-    if (self->state == QUERY_ACTIVE) {
-        MGLError_Set("this query was not stopped");
-        return NULL;
-    }
+static PyObject * MGLContext_query_counter(MGLContext * self, PyObject * args) {
+    unsigned query_obj;
 
-    const GLMethods & gl = self->context->gl;
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &query_obj
+    );
 
-    unsigned samples = 0;
-    if (self->ended) {
-        gl.GetQueryObjectuiv(self->query_obj[SAMPLES_PASSED], GL_QUERY_RESULT, &samples);
+    if (!args_ok) {
+        return 0;
     }
 
-    return PyLong_FromUnsignedLong(samples);
+    self->gl.QueryCounter(query_obj, GL_TIMESTAMP);
+    Py_RETURN_NONE;
 }
 
-static PyObject * MGLQuery_get_primitives(MGLQuery * self, void * closure) {
-    if (!self->query_obj[PRIMITIVES_GENERATED]) {
-        MGLError_Set("query created without the primitives_generated flag");
-        return NULL;
-    }
-
-    if (self->state == QUERY_ACTIVE) {
-        MGLError_Set("this query was not stopped");
-        return NULL;
-    }
+static PyObject * MGLContext_query_timestamps(MGLContext * self, PyObject * args) {
+    PyObject * queries;
 
-    const GLMethods & gl = self->context->gl;
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O!",
+        &PyTuple_Type,
+        &queries
+    );
 
-    unsigned primitives = 0;
-    if (self->ended) {
-        gl.GetQueryObjectuiv(self->query_obj[PRIMITIVES_GENERATED], GL_QUERY_RESULT, &primitives);
+    if (!args_ok) {
+        return 0;
     }
 
-    return PyLong_FromUnsignedLong(primitives);
-}
+    const GLMethods & gl = self->gl;
 
-static PyObject * MGLQuery_get_elapsed(MGLQuery * self, void * closure) {
-    if (!self->query_obj[TIME_ELAPSED]) {
-        MGLError_Set("query created without the time_elapsed flag");
-        return NULL;
-    }
+    int count = (int)PyTuple_GET_SIZE(queries);
 
-    if (self->state == QUERY_ACTIVE) {
-        MGLError_Set("this query was not stopped");
-        return NULL;
+    if (!count) {
+        return PyTuple_New(0);
     }
 
-    const GLMethods & gl = self->context->gl;
+    // Timestamps complete in submission order, checking the last one is enough
+    unsigned available = 0;
+    GLuint last = PyLong_AsUnsignedLong(PyTuple_GET_ITEM(queries, count - 1));
+    gl.GetQueryObjectuiv(last, GL_QUERY_RESULT_AVAILABLE, &available);
 
-    unsigned elapsed = 0;
-    if (self->ended) {
-        gl.GetQueryObjectuiv(self->query_obj[TIME_ELAPSED], GL_QUERY_RESULT, &elapsed);
+    if (!available) {
+        Py_RETURN_NONE;
     }
 
-    return PyLong_FromUnsignedLong(elapsed);
+    PyObject * res = PyTuple_New(count);
+    for (int i = 0; i < count; ++i) {
+        GLuint64 timestamp = 0;
+        gl.GetQueryObjectui64v(PyLong_AsUnsignedLong(PyTuple_GET_ITEM(queries, i)), GL_QUERY_RESULT, &timestamp);
+        PyTuple_SET_ITEM(res, i, PyLong_FromUnsignedLongLong(timestamp));
+    }
+
+    return res;
 }
 
 // TODO: Add label support for MGLQuery (it contains multiple OpenGL query objects)
@@ -2950,12 +4991,14 @@ static PyObject * MGLRenderbuffer_release(MGLRenderbuffer * self, PyObject * arg
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteRenderbuffers(1, (GLuint *)&self->renderbuffer_obj);
+    memory_track(self->context, MGL_MEMORY_RENDERBUFFER, self->renderbuffer_obj, 0);
 
     Py_DECREF(self);
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLContext_sampler(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int args_ok = PyArg_ParseTuple(
         args,
         ""
@@ -3013,10 +5056,12 @@ static PyObject * MGLContext_memory_barrier(MGLContext * self, PyObject * args)
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLSampler_use(MGLSampler * self, PyObject * args) {
+static PyObject * MGLSampler_use(MGLSampler * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"location"};
+    PyObject * values[1];
     int index;
 
-    if (!PyArg_ParseTuple(args, "I", &index)) {
+    if (!fastcall_args("use", args, nargs, kwnames, keywords, 0, 1, values) || !fastcall_int(values[0], 0, &index)) {
         return 0;
     }
 
@@ -3063,6 +5108,7 @@ static PyObject * MGLSampler_get_repeat_x(MGLSampler * self, void * closure) {
 }
 
 static int MGLSampler_set_repeat_x(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const GLMethods & gl = self->context->gl;
 
     if (value == Py_True) {
@@ -3084,6 +5130,7 @@ static PyObject * MGLSampler_get_repeat_y(MGLSampler * self, void * closure) {
 }
 
 static int MGLSampler_set_repeat_y(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const GLMethods & gl = self->context->gl;
 
     if (value == Py_True) {
@@ -3105,6 +5152,7 @@ static PyObject * MGLSampler_get_repeat_z(MGLSampler * self, void * closure) {
 }
 
 static int MGLSampler_set_repeat_z(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const GLMethods & gl = self->context->gl;
 
     if (value == Py_True) {
@@ -3145,6 +5193,7 @@ static int parse_filter(PyObject * arg, int * min_filter_value, int * mag_filter
 }
 
 static int MGLSampler_set_filter(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_filter(value, &self->min_filter, &self->mag_filter)) {
         MGLError_Set("invalid filter");
         return -1;
@@ -3161,6 +5210,7 @@ static PyObject * MGLSampler_get_compare_func(MGLSampler * self, void * closure)
 }
 
 static int MGLSampler_set_compare_func(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * func = PyUnicode_AsUTF8(value);
     if (!func) {
         MGLError_Set("invalid compare function");
@@ -3185,8 +5235,8 @@ static PyObject * MGLSampler_get_anisotropy(MGLSampler * self, void * closure) {
 }
 
 static int MGLSampler_set_anisotropy(MGLSampler * self, PyObject * value, void * closure) {
-    if (self->context->max_anisotropy == 0) return 0;
-    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->max_anisotropy);
+    if (self->context->limits.max_texture_max_anisotropy == 0) return 0;
+    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->limits.max_texture_max_anisotropy);
 
     const GLMethods & gl = self->context->gl;
     gl.SamplerParameterf(self->sampler_obj, GL_TEXTURE_MAX_ANISOTROPY, self->anisotropy);
@@ -3222,6 +5272,7 @@ static int parse_color(PyObject * arg, float * value) {
 }
 
 static int MGLSampler_set_border_color(MGLSampler * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_color(value, self->border_color)) {
         MGLError_Set("invalid border color");
         return -1;
@@ -3262,7 +5313,7 @@ static int MGLSampler_set_max_lod(MGLSampler * self, PyObject * value, void * cl
     return 0;
 }
 
-static int parse_texture_binding(PyObject * arg, TextureBinding * value) {
+static int parse_texture_binding(MGLModuleState * state, PyObject * arg, TextureBinding * value) {
     arg = PySequence_Tuple(arg);
     if (!arg || PyTuple_Size(arg) != 2) {
         PyErr_Clear();
@@ -3308,7 +5359,7 @@ static int parse_texture_binding(PyObject * arg, TextureBinding * value) {
     return 1;
 }
 
-static int parse_buffer_binding(PyObject * arg, BufferBinding * value) {
+static int parse_buffer_binding(MGLModuleState * state, PyObject * arg, BufferBinding * value) {
     arg = PySequence_Tuple(arg);
     if (!arg || PyTuple_Size(arg) != 2) {
         PyErr_Clear();
@@ -3339,7 +5390,7 @@ static int parse_buffer_binding(PyObject * arg, BufferBinding * value) {
     return 1;
 }
 
-static int parse_sampler_binding(PyObject * arg, SamplerBinding * value) {
+static int parse_sampler_binding(MGLModuleState * state, PyObject * arg, SamplerBinding * value) {
     arg = PySequence_Tuple(arg);
     if (!arg || PyTuple_Size(arg) != 2) {
         PyErr_Clear();
@@ -3372,6 +5423,7 @@ static int parse_sampler_binding(PyObject * arg, SamplerBinding * value) {
 }
 
 static PyObject * MGLContext_scope(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLFramebuffer * framebuffer;
     PyObject * enable_flags;
     PyObject * textures_arg;
@@ -3443,8 +5495,7 @@ static PyObject * MGLContext_scope(MGLContext * self, PyObject * args) {
     Py_INCREF(framebuffer);
     scope->framebuffer = framebuffer;
 
-    Py_INCREF(self->bound_framebuffer);
-    scope->old_framebuffer = self->bound_framebuffer;
+    scope->old_framebuffer = get_bound_framebuffer(self);
 
     scope->num_textures = (int)PyTuple_Size(textures_arg);
     scope->num_uniform_buffers = (int)PyTuple_Size(uniform_buffers_arg);
@@ -3457,28 +5508,28 @@ static PyObject * MGLContext_scope(MGLContext * self, PyObject * args) {
     scope->samplers = (SamplerBinding *)PyMem_Malloc(scope->num_samplers * sizeof(SamplerBinding));
 
     for (int i = 0; i < scope->num_textures; ++i) {
-        if (!parse_texture_binding(PyTuple_GetItem(textures_arg, i), &scope->textures[i])) {
+        if (!parse_texture_binding(state, PyTuple_GetItem(textures_arg, i), &scope->textures[i])) {
             MGLError_Set("invalid textures");
             return NULL;
         }
     }
 
     for (int i = 0; i < scope->num_uniform_buffers; ++i) {
-        if (!parse_buffer_binding(PyTuple_GetItem(uniform_buffers_arg, i), &scope->uniform_buffers[i])) {
+        if (!parse_buffer_binding(state, PyTuple_GetItem(uniform_buffers_arg, i), &scope->uniform_buffers[i])) {
             MGLError_Set("invalid uniform buffers");
             return NULL;
         }
     }
 
     for (int i = 0; i < scope->num_storage_buffers; ++i) {
-        if (!parse_buffer_binding(PyTuple_GetItem(storage_buffers_arg, i), &scope->storage_buffers[i])) {
+        if (!parse_buffer_binding(state, PyTuple_GetItem(storage_buffers_arg, i), &scope->storage_buffers[i])) {
             MGLError_Set("invalid storage buffers");
             return NULL;
         }
     }
 
     for (int i = 0; i < scope->num_samplers; ++i) {
-        if (!parse_sampler_binding(PyTuple_GetItem(samplers_arg, i), &scope->samplers[i])) {
+        if (!parse_sampler_binding(state, PyTuple_GetItem(samplers_arg, i), &scope->samplers[i])) {
             MGLError_Set("invalid samplers");
             return NULL;
         }
@@ -3497,8 +5548,10 @@ static PyObject * MGLScope_begin(MGLScope * self, PyObject * args) {
     const GLMethods & gl = self->context->gl;
     const int & flags = self->enable_flags;
 
+    MGLMutex_Lock(self->context->lock);
     self->old_enable_flags = self->context->enable_flags;
     self->context->enable_flags = self->enable_flags;
+    MGLMutex_Unlock(self->context->lock);
 
     Py_XDECREF(MGLFramebuffer_use(self->framebuffer, NULL));
 
@@ -3560,7 +5613,9 @@ static PyObject * MGLScope_end(MGLScope * self, PyObject * args) {
     const GLMethods & gl = self->context->gl;
     const int & flags = self->old_enable_flags;
 
+    MGLMutex_Lock(self->context->lock);
     self->context->enable_flags = self->old_enable_flags;
+    MGLMutex_Unlock(self->context->lock);
 
     Py_XDECREF(MGLFramebuffer_use(self->old_framebuffer, NULL));
 
@@ -3612,6 +5667,7 @@ static PyObject * MGLScope_release(MGLScope * self, PyObject * args) {
 }
 
 static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
 
@@ -3649,7 +5705,7 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    if ((samples & (samples - 1)) || samples > self->max_samples) {
+    if ((samples & (samples - 1)) || samples > self->limits.max_samples) {
         MGLError_Set("the number of samples is invalid");
         return 0;
     }
@@ -3711,6 +5767,8 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
         Py_INCREF(self);
         renderbuffer->context = self;
 
+        memory_track(self, MGL_MEMORY_RENDERBUFFER, renderbuffer->renderbuffer_obj, texture_memory(width, height, 1, 1, components * data_type->size, samples, 1));
+
         return Py_BuildValue("(Oi)", renderbuffer, renderbuffer->renderbuffer_obj);
     }
 
@@ -3768,7 +5826,13 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
     } else {
         gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
         gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-        gl.TexImage2D(texture_target, 0, internal_format, width, height, 0, base_format, pixel_type, buffer_view.buf);
+        if (buffer_view.buf && buffer_view.len >= MGL_UNLOCKED_UPLOAD_SIZE) {
+            Py_BEGIN_ALLOW_THREADS
+            gl.TexImage2D(texture_target, 0, internal_format, width, height, 0, base_format, pixel_type, buffer_view.buf);
+            Py_END_ALLOW_THREADS
+        } else {
+            gl.TexImage2D(texture_target, 0, internal_format, width, height, 0, base_format, pixel_type, buffer_view.buf);
+        }
         if (data_type->float_type) {
             gl.TexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             gl.TexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -3802,10 +5866,128 @@ static PyObject * MGLContext_texture(MGLContext * self, PyObject * args) {
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, 1, 1, texture->components * texture->data_type->size, texture->samples, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
+static bool sparse_page_size(const GLMethods & gl, int target, int internal_format, int * page_size) {
+    int num_page_sizes = 0;
+    gl.GetInternalformativ(target, internal_format, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &num_page_sizes);
+
+    if (num_page_sizes <= 0) {
+        return false;
+    }
+
+    // The first (default) page size is used
+    gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &page_size[0]);
+    gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &page_size[1]);
+    gl.GetInternalformativ(target, internal_format, GL_VIRTUAL_PAGE_SIZE_Z_ARB, 1, &page_size[2]);
+    return true;
+}
+
+static PyObject * MGLContext_sparse_texture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int width;
+    int height;
+    int components;
+    const char * dtype;
+    int levels;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "(II)Isi",
+        &width,
+        &height,
+        &components,
+        &dtype,
+        &levels
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (components < 1 || components > 4) {
+        MGLError_Set("the components must be 1, 2, 3 or 4");
+        return 0;
+    }
+
+    if (levels < 1) {
+        MGLError_Set("the texture must have at least one level");
+        return 0;
+    }
+
+    MGLDataType * data_type = from_dtype(dtype);
+
+    if (!data_type) {
+        MGLError_Set("invalid dtype");
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (!gl.TexPageCommitmentARB) {
+        MGLError_Set("sparse textures are not supported");
+        return 0;
+    }
+
+    int internal_format = data_type->internal_format[components];
+    int page_size[3] = {};
+
+    if (!sparse_page_size(gl, GL_TEXTURE_2D, internal_format, page_size)) {
+        MGLError_Set("the format does not support sparse textures");
+        return 0;
+    }
+
+    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
+
+    MGLTexture * texture = PyObject_New(MGLTexture, MGLTexture_type);
+    texture->released = false;
+    texture->external = false;
+
+    texture->texture_obj = 0;
+    gl.GenTextures(1, (GLuint *)&texture->texture_obj);
+
+    if (!texture->texture_obj) {
+        MGLError_Set("cannot create texture");
+        Py_DECREF(texture);
+        return 0;
+    }
+
+    gl.BindTexture(GL_TEXTURE_2D, texture->texture_obj);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+    gl.TexStorage2D(GL_TEXTURE_2D, levels, internal_format, width, height);
+
+    int filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+    texture->width = width;
+    texture->height = height;
+    texture->components = components;
+    texture->samples = 0;
+    texture->data_type = data_type;
+
+    texture->max_level = levels - 1;
+    texture->compare_func = 0;
+    texture->anisotropy = 0.0;
+    texture->depth = false;
+
+    texture->min_filter = filter;
+    texture->mag_filter = filter;
+
+    texture->repeat_x = true;
+    texture->repeat_y = true;
+
+    Py_INCREF(self);
+    texture->context = self;
+
+    return Py_BuildValue("(Oi(iii))", texture, texture->texture_obj, page_size[0], page_size[1], page_size[2]);
+}
+
 static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
 
@@ -3830,7 +6012,7 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
         return 0;
     }
 
-    if ((samples & (samples - 1)) || samples > self->max_samples) {
+    if ((samples & (samples - 1)) || samples > self->limits.max_samples) {
         MGLError_Set("the number of samples is invalid");
         return 0;
     }
@@ -3878,6 +6060,8 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
         Py_INCREF(self);
         renderbuffer->context = self;
 
+        memory_track(self, MGL_MEMORY_RENDERBUFFER, renderbuffer->renderbuffer_obj, texture_memory(width, height, 1, 1, 4, samples, 1));
+
         return Py_BuildValue("(Oi)", renderbuffer, renderbuffer->renderbuffer_obj);
     }
 
@@ -3963,10 +6147,13 @@ static PyObject * MGLContext_depth_texture(MGLContext * self, PyObject * args) {
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, 1, 1, texture->components * texture->data_type->size, texture->samples, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
 static PyObject * MGLContext_external_texture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int glo;
     int width;
     int height;
@@ -4025,6 +6212,7 @@ static PyObject * MGLContext_external_texture(MGLContext * self, PyObject * args
 }
 
 static PyObject * MGLTexture_read(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int level;
     int alignment;
 
@@ -4104,6 +6292,7 @@ static PyObject * MGLTexture_read(MGLTexture * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture_read_into(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     int level;
     int alignment;
@@ -4198,6 +6387,7 @@ static PyObject * MGLTexture_read_into(MGLTexture * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     PyObject * viewport_arg;
     int level;
@@ -4209,7 +6399,112 @@ static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
         &data,
         &viewport_arg,
         &level,
-        &alignment
+        &alignment
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8) {
+        MGLError_Set("the alignment must be 1, 2, 4 or 8");
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    if (self->samples) {
+        MGLError_Set("multisample textures cannot be written directly");
+        return 0;
+    }
+
+    Py_buffer buffer_view;
+
+    int default_width = self->width / (1 << level);
+    int default_height = self->height / (1 << level);
+
+    Rect viewport_rect = rect(0, 0, default_width > 1 ? default_width : 1, default_height > 1 ? default_height : 1);
+    if (viewport_arg != Py_None) {
+        if (!parse_rect(viewport_arg, &viewport_rect)) {
+            MGLError_Set("wrong values in the viewport");
+            return NULL;
+        }
+    }
+
+    unsigned long long expected_size = (unsigned long long)viewport_rect.width * self->components * self->data_type->size;
+    expected_size = (expected_size + alignment - 1) / alignment * alignment;
+    expected_size = expected_size * viewport_rect.height;
+
+    int pixel_type = self->data_type->gl_type;
+    int format = self->depth ? GL_DEPTH_COMPONENT : self->data_type->base_format[self->components];
+
+    if (Py_TYPE(data) == MGLBuffer_type) {
+
+        MGLBuffer * buffer = (MGLBuffer *)data;
+
+        const GLMethods & gl = self->context->gl;
+
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
+        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
+        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
+        gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, 0);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    } else {
+
+        int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_SIMPLE);
+        if (get_buffer < 0) {
+            // Propagate the default error
+            return 0;
+        }
+
+        if (buffer_view.len != expected_size) {
+            MGLError_Set("data size mismatch %d != %d", buffer_view.len, expected_size);
+            if (data != Py_None) {
+                PyBuffer_Release(&buffer_view);
+            }
+            return 0;
+        }
+
+        const GLMethods & gl = self->context->gl;
+
+        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
+        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+        gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
+        gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, buffer_view.buf);
+
+        PyBuffer_Release(&buffer_view);
+
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLTexture_write_from_file(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    PyObject * path;
+    PyObject * viewport_arg;
+    int level;
+    int alignment;
+    Py_ssize_t file_offset;
+    Py_ssize_t chunk;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O&OIInn",
+        PyUnicode_FSConverter,
+        &path,
+        &viewport_arg,
+        &level,
+        &alignment,
+        &file_offset,
+        &chunk
     );
 
     if (!args_ok) {
@@ -4218,21 +6513,22 @@ static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
 
     if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8) {
         MGLError_Set("the alignment must be 1, 2, 4 or 8");
+        Py_DECREF(path);
         return 0;
     }
 
     if (level > self->max_level) {
         MGLError_Set("invalid level");
+        Py_DECREF(path);
         return 0;
     }
 
     if (self->samples) {
         MGLError_Set("multisample textures cannot be written directly");
+        Py_DECREF(path);
         return 0;
     }
 
-    Py_buffer buffer_view;
-
     int default_width = self->width / (1 << level);
     int default_height = self->height / (1 << level);
 
@@ -4240,63 +6536,121 @@ static PyObject * MGLTexture_write(MGLTexture * self, PyObject * args) {
     if (viewport_arg != Py_None) {
         if (!parse_rect(viewport_arg, &viewport_rect)) {
             MGLError_Set("wrong values in the viewport");
+            Py_DECREF(path);
             return NULL;
         }
     }
 
-    unsigned long long expected_size = (unsigned long long)viewport_rect.width * self->components * self->data_type->size;
-    expected_size = (expected_size + alignment - 1) / alignment * alignment;
-    expected_size = expected_size * viewport_rect.height;
+    Py_ssize_t row_size = (Py_ssize_t)viewport_rect.width * self->components * self->data_type->size;
+    row_size = (row_size + alignment - 1) / alignment * alignment;
+
+    Py_ssize_t size = row_size * viewport_rect.height;
+
+    FILE * file = open_file_range(state, path, file_offset, &size);
+    Py_DECREF(path);
+
+    if (!file) {
+        return 0;
+    }
+
+    // Upload bands of whole rows, at least one row at a time
+    int band_rows = (int)MGL_MAX(MGL_MIN(chunk / row_size, (Py_ssize_t)viewport_rect.height), 1);
+    Py_ssize_t band_size = band_rows * row_size;
 
     int pixel_type = self->data_type->gl_type;
     int format = self->depth ? GL_DEPTH_COMPONENT : self->data_type->base_format[self->components];
 
-    if (Py_TYPE(data) == MGLBuffer_type) {
+    MGLContext * ctx = self->context;
+    const GLMethods & gl = ctx->gl;
 
-        MGLBuffer * buffer = (MGLBuffer *)data;
+    gl.ActiveTexture(GL_TEXTURE0 + ctx->default_texture_unit);
+    gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+    gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 
-        const GLMethods & gl = self->context->gl;
+    bool staging = staging_ring_reserve(ctx, band_size);
+    char * ptr = staging ? 0 : (char *)PyMem_Malloc(band_size);
 
-        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer_obj);
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
-        gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
-        gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-        gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, 0);
-        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    for (int row = 0; row < viewport_rect.height; row += band_rows) {
+        int rows = MGL_MIN(band_rows, viewport_rect.height - row);
 
-    } else {
+        int slot = 0;
+        char * dst = staging ? staging_ring_acquire(ctx, &slot) : ptr;
 
-        int get_buffer = PyObject_GetBuffer(data, &buffer_view, PyBUF_SIMPLE);
-        if (get_buffer < 0) {
-            // Propagate the default error
+        if (!read_file_chunk(state, file, dst, rows * row_size)) {
+            if (!staging) {
+                PyMem_Free(ptr);
+            }
+            fclose(file);
             return 0;
         }
 
-        if (buffer_view.len != expected_size) {
-            MGLError_Set("data size mismatch %d != %d", buffer_view.len, expected_size);
-            if (data != Py_None) {
-                PyBuffer_Release(&buffer_view);
-            }
-            return 0;
+        if (staging) {
+            gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, ctx->staging.buffer_obj);
+            gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y + row, viewport_rect.width, rows, format, pixel_type, (void *)(slot * ctx->staging.slot_size));
+            gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            staging_ring_release(ctx, slot);
+        } else {
+            gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y + row, viewport_rect.width, rows, format, pixel_type, dst);
         }
+    }
 
-        const GLMethods & gl = self->context->gl;
+    if (!staging) {
+        PyMem_Free(ptr);
+    }
 
-        gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
-        gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
-        gl.PixelStorei(GL_PACK_ALIGNMENT, alignment);
-        gl.PixelStorei(GL_UNPACK_ALIGNMENT, alignment);
-        gl.TexSubImage2D(GL_TEXTURE_2D, level, viewport_rect.x, viewport_rect.y, viewport_rect.width, viewport_rect.height, format, pixel_type, buffer_view.buf);
+    fclose(file);
+    Py_RETURN_NONE;
+}
 
-        PyBuffer_Release(&buffer_view);
+static PyObject * MGLTexture_commit(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int level;
+    int x;
+    int y;
+    int width;
+    int height;
+    int commit;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I(iiii)p",
+        &level,
+        &x,
+        &y,
+        &width,
+        &height,
+        &commit
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
 
+    int level_width = MGL_MAX(self->width >> level, 1);
+    int level_height = MGL_MAX(self->height >> level, 1);
+
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x + width > level_width || y + height > level_height) {
+        MGLError_Set("the region is out of range");
+        return 0;
     }
 
+    const GLMethods & gl = self->context->gl;
+
+    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
+    gl.BindTexture(GL_TEXTURE_2D, self->texture_obj);
+    gl.TexPageCommitmentARB(GL_TEXTURE_2D, level, x, y, 0, width, height, 1, commit);
+
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLTexture_meth_bind(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int unit;
     int read;
     int write;
@@ -4332,16 +6686,12 @@ static PyObject * MGLTexture_meth_bind(MGLTexture * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLTexture_use(MGLTexture * self, PyObject * args) {
+static PyObject * MGLTexture_use(MGLTexture * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"location"};
+    PyObject * values[1];
     int index;
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "I",
-        &index
-    );
-
-    if (!args_ok) {
+    if (!fastcall_args("use", args, nargs, kwnames, keywords, 0, 1, values) || !fastcall_int(values[0], 0, &index)) {
         return 0;
     }
 
@@ -4355,6 +6705,7 @@ static PyObject * MGLTexture_use(MGLTexture * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture_build_mipmaps(MGLTexture * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int base = 0;
     int max = 1000;
 
@@ -4393,6 +6744,11 @@ static PyObject * MGLTexture_build_mipmaps(MGLTexture * self, PyObject * args) {
     self->mag_filter = GL_LINEAR;
     self->max_level = max;
 
+    if (!self->external) {
+        long long memory = texture_memory(self->width, self->height, 1, 1, self->components * self->data_type->size, self->samples, mipmap_levels(self->width, self->height, 1, max));
+        memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, memory);
+    }
+
     Py_RETURN_NONE;
 }
 
@@ -4423,6 +6779,7 @@ static PyObject * MGLTexture_release(MGLTexture * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, 0);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -4434,6 +6791,7 @@ static PyObject * MGLTexture_get_repeat_x(MGLTexture * self, void * closure) {
 }
 
 static int MGLTexture_set_repeat_x(MGLTexture * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int texture_target = self->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
     const GLMethods & gl = self->context->gl;
@@ -4460,6 +6818,7 @@ static PyObject * MGLTexture_get_repeat_y(MGLTexture * self, void * closure) {
 }
 
 static int MGLTexture_set_repeat_y(MGLTexture * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int texture_target = self->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
     const GLMethods & gl = self->context->gl;
@@ -4486,6 +6845,7 @@ static PyObject * MGLTexture_get_filter(MGLTexture * self, void * closure) {
 }
 
 static int MGLTexture_set_filter(MGLTexture * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_filter(value, &self->min_filter, &self->mag_filter)) {
         MGLError_Set("invalid filter");
         return -1;
@@ -4504,6 +6864,7 @@ static int MGLTexture_set_filter(MGLTexture * self, PyObject * value, void * clo
 }
 
 static PyObject * MGLTexture_get_swizzle(MGLTexture * self, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     if (self->depth) {
         MGLError_Set("cannot get swizzle of depth textures");
@@ -4539,6 +6900,7 @@ static PyObject * MGLTexture_get_swizzle(MGLTexture * self, void * closure) {
 }
 
 static int MGLTexture_set_swizzle(MGLTexture * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * swizzle = PyUnicode_AsUTF8(value);
 
     if (self->depth) {
@@ -4589,6 +6951,7 @@ static int MGLTexture_set_swizzle(MGLTexture * self, PyObject * value, void * cl
 }
 
 static PyObject * MGLTexture_get_compare_func(MGLTexture * self, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!self->depth) {
         MGLError_Set("only depth textures have compare_func");
         return 0;
@@ -4598,6 +6961,7 @@ static PyObject * MGLTexture_get_compare_func(MGLTexture * self, void * closure)
 }
 
 static int MGLTexture_set_compare_func(MGLTexture * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!self->depth) {
         MGLError_Set("only depth textures have compare_func");
         return -1;
@@ -4630,8 +6994,8 @@ static PyObject * MGLTexture_get_anisotropy(MGLTexture * self, void * closure) {
 }
 
 static int MGLTexture_set_anisotropy(MGLTexture * self, PyObject * value, void * closure) {
-    if (self->context->max_anisotropy == 0) return 0;
-    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->max_anisotropy);
+    if (self->context->limits.max_texture_max_anisotropy == 0) return 0;
+    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->limits.max_texture_max_anisotropy);
     int texture_target = self->samples ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
     const GLMethods & gl = self->context->gl;
@@ -4644,6 +7008,7 @@ static int MGLTexture_set_anisotropy(MGLTexture * self, PyObject * value, void *
 }
 
 static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
     int depth;
@@ -4767,10 +7132,110 @@ static PyObject * MGLContext_texture3d(MGLContext * self, PyObject * args) {
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, texture->depth, 1, texture->components * texture->data_type->size, 0, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
+static PyObject * MGLContext_sparse_texture3d(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int width;
+    int height;
+    int depth;
+    int components;
+    const char * dtype;
+    int levels;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "(III)Isi",
+        &width,
+        &height,
+        &depth,
+        &components,
+        &dtype,
+        &levels
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (components < 1 || components > 4) {
+        MGLError_Set("the components must be 1, 2, 3 or 4");
+        return 0;
+    }
+
+    if (levels < 1) {
+        MGLError_Set("the texture must have at least one level");
+        return 0;
+    }
+
+    MGLDataType * data_type = from_dtype(dtype);
+
+    if (!data_type) {
+        MGLError_Set("invalid dtype");
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (!gl.TexPageCommitmentARB) {
+        MGLError_Set("sparse textures are not supported");
+        return 0;
+    }
+
+    int internal_format = data_type->internal_format[components];
+    int page_size[3] = {};
+
+    if (!sparse_page_size(gl, GL_TEXTURE_3D, internal_format, page_size)) {
+        MGLError_Set("the format does not support sparse textures");
+        return 0;
+    }
+
+    MGLTexture3D * texture = PyObject_New(MGLTexture3D, MGLTexture3D_type);
+    texture->released = false;
+
+    texture->texture_obj = 0;
+    gl.GenTextures(1, (GLuint *)&texture->texture_obj);
+
+    if (!texture->texture_obj) {
+        MGLError_Set("cannot create texture");
+        Py_DECREF(texture);
+        return 0;
+    }
+
+    gl.ActiveTexture(GL_TEXTURE0 + self->default_texture_unit);
+    gl.BindTexture(GL_TEXTURE_3D, texture->texture_obj);
+    gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+    gl.TexStorage3D(GL_TEXTURE_3D, levels, internal_format, width, height, depth);
+
+    int filter = data_type->float_type ? GL_LINEAR : GL_NEAREST;
+    gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, filter);
+    gl.TexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, filter);
+
+    texture->width = width;
+    texture->height = height;
+    texture->depth = depth;
+    texture->components = components;
+    texture->data_type = data_type;
+
+    texture->min_filter = filter;
+    texture->mag_filter = filter;
+    texture->max_level = levels - 1;
+
+    texture->repeat_x = true;
+    texture->repeat_y = true;
+    texture->repeat_z = true;
+
+    Py_INCREF(self);
+    texture->context = self;
+
+    return Py_BuildValue("(Oi(iii))", texture, texture->texture_obj, page_size[0], page_size[1], page_size[2]);
+}
+
 static PyObject * MGLTexture3D_read(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int alignment;
 
     int args_ok = PyArg_ParseTuple(
@@ -4811,6 +7276,7 @@ static PyObject * MGLTexture3D_read(MGLTexture3D * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture3D_read_into(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     int alignment;
     Py_ssize_t write_offset;
@@ -4886,6 +7352,7 @@ static PyObject * MGLTexture3D_read_into(MGLTexture3D * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture3D_write(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     PyObject * viewport_arg;
     int alignment;
@@ -4969,7 +7436,64 @@ static PyObject * MGLTexture3D_write(MGLTexture3D * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
+static PyObject * MGLTexture3D_commit(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    int level;
+    int x;
+    int y;
+    int z;
+    int width;
+    int height;
+    int depth;
+    int commit;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I(iiiiii)p",
+        &level,
+        &x,
+        &y,
+        &z,
+        &width,
+        &height,
+        &depth,
+        &commit
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (level > self->max_level) {
+        MGLError_Set("invalid level");
+        return 0;
+    }
+
+    int level_width = MGL_MAX(self->width >> level, 1);
+    int level_height = MGL_MAX(self->height >> level, 1);
+    int level_depth = MGL_MAX(self->depth >> level, 1);
+
+    if (x < 0 || y < 0 || z < 0 || width < 0 || height < 0 || depth < 0) {
+        MGLError_Set("the region is out of range");
+        return 0;
+    }
+
+    if (x + width > level_width || y + height > level_height || z + depth > level_depth) {
+        MGLError_Set("the region is out of range");
+        return 0;
+    }
+
+    const GLMethods & gl = self->context->gl;
+
+    gl.ActiveTexture(GL_TEXTURE0 + self->context->default_texture_unit);
+    gl.BindTexture(GL_TEXTURE_3D, self->texture_obj);
+    gl.TexPageCommitmentARB(GL_TEXTURE_3D, level, x, y, z, width, height, depth, commit);
+
+    Py_RETURN_NONE;
+}
+
 static PyObject * MGLTexture3D_meth_bind(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int unit;
     int read;
     int write;
@@ -5006,16 +7530,12 @@ static PyObject * MGLTexture3D_meth_bind(MGLTexture3D * self, PyObject * args) {
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLTexture3D_use(MGLTexture3D * self, PyObject * args) {
+static PyObject * MGLTexture3D_use(MGLTexture3D * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"location"};
+    PyObject * values[1];
     int index;
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "I",
-        &index
-    );
-
-    if (!args_ok) {
+    if (!fastcall_args("use", args, nargs, kwnames, keywords, 0, 1, values) || !fastcall_int(values[0], 0, &index)) {
         return 0;
     }
 
@@ -5027,6 +7547,7 @@ static PyObject * MGLTexture3D_use(MGLTexture3D * self, PyObject * args) {
 }
 
 static PyObject * MGLTexture3D_build_mipmaps(MGLTexture3D * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int base = 0;
     int max = 1000;
 
@@ -5065,6 +7586,9 @@ static PyObject * MGLTexture3D_build_mipmaps(MGLTexture3D * self, PyObject * arg
     self->mag_filter = GL_LINEAR;
     self->max_level = max;
 
+    long long memory = texture_memory(self->width, self->height, self->depth, 1, self->components * self->data_type->size, 0, mipmap_levels(self->width, self->height, self->depth, max));
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, memory);
+
     Py_RETURN_NONE;
 }
 
@@ -5095,6 +7619,7 @@ static PyObject * MGLTexture3D_release(MGLTexture3D * self, PyObject * args) {
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, 0);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -5106,6 +7631,7 @@ static PyObject * MGLTexture3D_get_repeat_x(MGLTexture3D * self, void * closure)
 }
 
 static int MGLTexture3D_set_repeat_x(MGLTexture3D * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5131,6 +7657,7 @@ static PyObject * MGLTexture3D_get_repeat_y(MGLTexture3D * self, void * closure)
 }
 
 static int MGLTexture3D_set_repeat_y(MGLTexture3D * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5156,6 +7683,7 @@ static PyObject * MGLTexture3D_get_repeat_z(MGLTexture3D * self, void * closure)
 }
 
 static int MGLTexture3D_set_repeat_z(MGLTexture3D * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5181,6 +7709,7 @@ static PyObject * MGLTexture3D_get_filter(MGLTexture3D * self, void * closure) {
 }
 
 static int MGLTexture3D_set_filter(MGLTexture3D * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_filter(value, &self->min_filter, &self->mag_filter)) {
         MGLError_Set("invalid filter");
         return -1;
@@ -5225,6 +7754,7 @@ static PyObject * MGLTexture3D_get_swizzle(MGLTexture3D * self, void * closure)
 }
 
 static int MGLTexture3D_set_swizzle(MGLTexture3D * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * swizzle = PyUnicode_AsUTF8(value);
 
     if (!swizzle[0]) {
@@ -5269,6 +7799,7 @@ static int MGLTexture3D_set_swizzle(MGLTexture3D * self, PyObject * value, void
 }
 
 static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
     int layers;
@@ -5393,10 +7924,13 @@ static PyObject * MGLContext_texture_array(MGLContext * self, PyObject * args) {
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, 1, texture->layers, texture->components * texture->data_type->size, 0, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
 static PyObject * MGLTextureArray_read(MGLTextureArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int alignment;
 
     int args_ok = PyArg_ParseTuple(
@@ -5458,6 +7992,7 @@ static PyObject * MGLTextureArray_read(MGLTextureArray * self, PyObject * args)
 }
 
 static PyObject * MGLTextureArray_read_into(MGLTextureArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     int alignment;
     Py_ssize_t write_offset;
@@ -5534,6 +8069,7 @@ static PyObject * MGLTextureArray_read_into(MGLTextureArray * self, PyObject * a
 }
 
 static PyObject * MGLTextureArray_write(MGLTextureArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     PyObject * viewport_arg;
     int alignment;
@@ -5618,6 +8154,7 @@ static PyObject * MGLTextureArray_write(MGLTextureArray * self, PyObject * args)
 }
 
 static PyObject * MGLTextureArray_meth_bind(MGLTextureArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int unit;
     int read;
     int write;
@@ -5654,16 +8191,12 @@ static PyObject * MGLTextureArray_meth_bind(MGLTextureArray * self, PyObject * a
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLTextureArray_use(MGLTextureArray * self, PyObject * args) {
+static PyObject * MGLTextureArray_use(MGLTextureArray * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"location"};
+    PyObject * values[1];
     int index;
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "I",
-        &index
-    );
-
-    if (!args_ok) {
+    if (!fastcall_args("use", args, nargs, kwnames, keywords, 0, 1, values) || !fastcall_int(values[0], 0, &index)) {
         return 0;
     }
 
@@ -5676,6 +8209,7 @@ static PyObject * MGLTextureArray_use(MGLTextureArray * self, PyObject * args) {
 }
 
 static PyObject * MGLTextureArray_build_mipmaps(MGLTextureArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int base = 0;
     int max = 1000;
 
@@ -5714,6 +8248,9 @@ static PyObject * MGLTextureArray_build_mipmaps(MGLTextureArray * self, PyObject
     self->mag_filter = GL_LINEAR;
     self->max_level = max;
 
+    long long memory = texture_memory(self->width, self->height, 1, self->layers, self->components * self->data_type->size, 0, mipmap_levels(self->width, self->height, 1, max));
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, memory);
+
     Py_RETURN_NONE;
 }
 
@@ -5744,6 +8281,7 @@ static PyObject * MGLTextureArray_release(MGLTextureArray * self, PyObject * arg
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, 0);
 
     Py_DECREF(self->context);
     Py_DECREF(self);
@@ -5755,6 +8293,7 @@ static PyObject * MGLTextureArray_get_repeat_x(MGLTextureArray * self, void * cl
 }
 
 static int MGLTextureArray_set_repeat_x(MGLTextureArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5780,6 +8319,7 @@ static PyObject * MGLTextureArray_get_repeat_y(MGLTextureArray * self, void * cl
 }
 
 static int MGLTextureArray_set_repeat_y(MGLTextureArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5805,6 +8345,7 @@ static PyObject * MGLTextureArray_get_filter(MGLTextureArray * self, void * clos
 }
 
 static int MGLTextureArray_set_filter(MGLTextureArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_filter(value, &self->min_filter, &self->mag_filter)) {
         MGLError_Set("invalid filter");
         return -1;
@@ -5849,6 +8390,7 @@ static PyObject * MGLTextureArray_get_swizzle(MGLTextureArray * self, void * clo
 }
 
 static int MGLTextureArray_set_swizzle(MGLTextureArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * swizzle = PyUnicode_AsUTF8(value);
 
     if (!swizzle[0]) {
@@ -5897,8 +8439,8 @@ static PyObject * MGLTextureArray_get_anisotropy(MGLTextureArray * self, void *
 }
 
 static int MGLTextureArray_set_anisotropy(MGLTextureArray * self, PyObject * value, void * closure) {
-    if (self->context->max_anisotropy == 0) return 0;
-    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->max_anisotropy);
+    if (self->context->limits.max_texture_max_anisotropy == 0) return 0;
+    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->limits.max_texture_max_anisotropy);
 
     const GLMethods & gl = self->context->gl;
 
@@ -5910,6 +8452,7 @@ static int MGLTextureArray_set_anisotropy(MGLTextureArray * self, PyObject * val
 }
 
 static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
 
@@ -6049,10 +8592,13 @@ static PyObject * MGLContext_texture_cube(MGLContext * self, PyObject * args) {
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, 1, 6, texture->components * texture->data_type->size, 0, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
 static PyObject * MGLContext_depth_texture_cube(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int width;
     int height;
 
@@ -6169,10 +8715,13 @@ static PyObject * MGLContext_depth_texture_cube(MGLContext * self, PyObject * ar
     Py_INCREF(self);
     texture->context = self;
 
+    memory_track(self, MGL_MEMORY_TEXTURE, texture->texture_obj, texture_memory(texture->width, texture->height, 1, 6, texture->components * texture->data_type->size, 0, 1));
+
     return Py_BuildValue("(Oi)", texture, texture->texture_obj);
 }
 
 static PyObject * MGLTextureCube_read(MGLTextureCube * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int face;
     int alignment;
 
@@ -6220,6 +8769,7 @@ static PyObject * MGLTextureCube_read(MGLTextureCube * self, PyObject * args) {
 }
 
 static PyObject * MGLTextureCube_read_into(MGLTextureCube * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * data;
     int face;
     int alignment;
@@ -6302,6 +8852,7 @@ static PyObject * MGLTextureCube_read_into(MGLTextureCube * self, PyObject * arg
 }
 
 static PyObject * MGLTextureCube_write(MGLTextureCube * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int face;
     PyObject * data;
     PyObject * viewport_arg;
@@ -6398,6 +8949,7 @@ static PyObject * MGLTextureCube_write(MGLTextureCube * self, PyObject * args) {
 }
 
 static PyObject * MGLTextureCube_meth_bind(MGLTextureCube * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int unit;
     int read;
     int write;
@@ -6434,16 +8986,12 @@ static PyObject * MGLTextureCube_meth_bind(MGLTextureCube * self, PyObject * arg
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLTextureCube_use(MGLTextureCube * self, PyObject * args) {
+static PyObject * MGLTextureCube_use(MGLTextureCube * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames) {
+    static const char * const keywords[] = {"location"};
+    PyObject * values[1];
     int index;
 
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "I",
-        &index
-    );
-
-    if (!args_ok) {
+    if (!fastcall_args("use", args, nargs, kwnames, keywords, 0, 1, values) || !fastcall_int(values[0], 0, &index)) {
         return 0;
     }
 
@@ -6474,6 +9022,7 @@ static PyObject * MGLTextureCube_get_handle(MGLTextureCube * self, PyObject * ar
 }
 
 static PyObject * MGLTextureCube_build_mipmaps(MGLTextureCube * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int base = 0;
     int max = 1000;
 
@@ -6512,6 +9061,9 @@ static PyObject * MGLTextureCube_build_mipmaps(MGLTextureCube * self, PyObject *
     self->mag_filter = GL_LINEAR;
     self->max_level = max;
 
+    long long memory = texture_memory(self->width, self->height, 1, 6, self->components * self->data_type->size, 0, mipmap_levels(self->width, self->height, 1, max));
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, memory);
+
     Py_RETURN_NONE;
 }
 
@@ -6525,6 +9077,7 @@ static PyObject * MGLTextureCube_release(MGLTextureCube * self, PyObject * args)
 
     const GLMethods & gl = self->context->gl;
     gl.DeleteTextures(1, (GLuint *)&self->texture_obj);
+    memory_track(self->context, MGL_MEMORY_TEXTURE, self->texture_obj, 0);
 
     Py_DECREF(self);
     Py_RETURN_NONE;
@@ -6535,6 +9088,7 @@ static PyObject * MGLTextureCube_get_filter(MGLTextureCube * self, void * closur
 }
 
 static int MGLTextureCube_set_filter(MGLTextureCube * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!parse_filter(value, &self->min_filter, &self->mag_filter)) {
         MGLError_Set("invalid filter");
         return -1;
@@ -6551,6 +9105,7 @@ static int MGLTextureCube_set_filter(MGLTextureCube * self, PyObject * value, vo
 }
 
 static PyObject * MGLTextureCube_get_swizzle(MGLTextureCube * self, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (self->depth) {
         MGLError_Set("cannot get swizzle of depth textures");
         return 0;
@@ -6583,6 +9138,7 @@ static PyObject * MGLTextureCube_get_swizzle(MGLTextureCube * self, void * closu
 }
 
 static int MGLTextureCube_set_swizzle(MGLTextureCube * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * swizzle = PyUnicode_AsUTF8(value);
 
     if (self->depth) {
@@ -6632,6 +9188,7 @@ static int MGLTextureCube_set_swizzle(MGLTextureCube * self, PyObject * value, v
 }
 
 static PyObject * MGLTextureCube_get_compare_func(MGLTextureCube * self, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!self->depth) {
         MGLError_Set("only depth textures have compare_func");
         return 0;
@@ -6641,6 +9198,7 @@ static PyObject * MGLTextureCube_get_compare_func(MGLTextureCube * self, void *
 }
 
 static int MGLTextureCube_set_compare_func(MGLTextureCube * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (!self->depth) {
         MGLError_Set("only depth textures have compare_func");
         return -1;
@@ -6672,8 +9230,8 @@ static PyObject * MGLTextureCube_get_anisotropy(MGLTextureCube * self, void * cl
 }
 
 static int MGLTextureCube_set_anisotropy(MGLTextureCube * self, PyObject * value, void * closure) {
-    if (self->context->max_anisotropy == 0) return 0;
-    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->max_anisotropy);
+    if (self->context->limits.max_texture_max_anisotropy == 0) return 0;
+    self->anisotropy = (float)MGL_MIN(MGL_MAX(PyFloat_AsDouble(value), 1.0), self->context->limits.max_texture_max_anisotropy);
 
     const GLMethods & gl = self->context->gl;
 
@@ -6684,10 +9242,36 @@ static int MGLTextureCube_set_anisotropy(MGLTextureCube * self, PyObject * value
     return 0;
 }
 
+// Buffer ranges are passed either as a Buffer or as a (Buffer, offset, size) tuple
+static bool parse_buffer_range(MGLModuleState * state, PyObject * obj, MGLBuffer ** buffer, Py_ssize_t * offset, Py_ssize_t * size) {
+    if (Py_TYPE(obj) == MGLBuffer_type) {
+        *buffer = (MGLBuffer *)obj;
+        *offset = 0;
+        *size = (*buffer)->size;
+        return true;
+    }
+
+    if (!PyTuple_Check(obj) || PyTuple_GET_SIZE(obj) != 3 || Py_TYPE(PyTuple_GET_ITEM(obj, 0)) != MGLBuffer_type) {
+        return false;
+    }
+
+    *buffer = (MGLBuffer *)PyTuple_GET_ITEM(obj, 0);
+    *offset = PyLong_AsSsize_t(PyTuple_GET_ITEM(obj, 1));
+    *size = PyLong_AsSsize_t(PyTuple_GET_ITEM(obj, 2));
+
+    if (PyErr_Occurred()) {
+        PyErr_Clear();
+        return false;
+    }
+
+    return *offset >= 0 && *size >= 0 && *offset + *size <= (*buffer)->size;
+}
+
 static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLProgram * program;
     PyObject * content;
-    MGLBuffer * index_buffer;
+    PyObject * index_buffer_arg;
     int index_element_size;
 
     int args_ok = PyArg_ParseTuple(
@@ -6696,7 +9280,7 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
         MGLProgram_type,
         &program,
         &content,
-        &index_buffer,
+        &index_buffer_arg,
         &index_element_size
     );
 
@@ -6709,6 +9293,15 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    MGLBuffer * index_buffer = (MGLBuffer *)Py_None;
+    Py_ssize_t index_offset = 0;
+    Py_ssize_t index_size = 0;
+
+    if (index_buffer_arg != Py_None && !parse_buffer_range(state, index_buffer_arg, &index_buffer, &index_offset, &index_size)) {
+        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(index_buffer_arg)->tp_name);
+        return 0;
+    }
+
     if (index_buffer != (MGLBuffer *)Py_None && index_buffer->context != self) {
         MGLError_Set("the index_buffer belongs to a different context");
         return 0;
@@ -6724,11 +9317,15 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
 
     for (int i = 0; i < content_len; ++i) {
         PyObject * tuple = PyTuple_GET_ITEM(content, i);
-        PyObject * buffer = PyTuple_GET_ITEM(tuple, 0);
+        PyObject * buffer_arg = PyTuple_GET_ITEM(tuple, 0);
         PyObject * format = PyTuple_GET_ITEM(tuple, 1);
 
-        if (Py_TYPE(buffer) != MGLBuffer_type) {
-            MGLError_Set("content[%d][0] must be a Buffer not %s", i, Py_TYPE(buffer)->tp_name);
+        MGLBuffer * buffer;
+        Py_ssize_t buffer_offset;
+        Py_ssize_t buffer_size;
+
+        if (!parse_buffer_range(state, buffer_arg, &buffer, &buffer_offset, &buffer_size)) {
+            MGLError_Set("content[%d][0] must be a Buffer not %s", i, Py_TYPE(buffer_arg)->tp_name);
             return 0;
         }
 
@@ -6737,7 +9334,7 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
             return 0;
         }
 
-        if (((MGLBuffer *)buffer)->context != self) {
+        if (buffer->context != self) {
             MGLError_Set("content[%d][0] belongs to a different context", i);
             return 0;
         }
@@ -6763,11 +9360,6 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
         }
     }
 
-    if (index_buffer != (MGLBuffer *)Py_None && Py_TYPE(index_buffer) != MGLBuffer_type) {
-        MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(index_buffer)->tp_name);
-        return 0;
-    }
-
     if (index_element_size != 1 && index_element_size != 2 && index_element_size != 4) {
         MGLError_Set("index_element_size must be 1, 2, or 4, not %d", index_element_size);
         return 0;
@@ -6797,13 +9389,14 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
 
     Py_INCREF(index_buffer);
     array->index_buffer = index_buffer;
+    array->index_offset = index_offset;
     array->index_element_size = index_element_size;
 
     const int element_types[5] = {0, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, 0, GL_UNSIGNED_INT};
     array->index_element_type = element_types[index_element_size];
 
     if (index_buffer != (MGLBuffer *)Py_None) {
-        array->num_vertices = (int)(index_buffer->size / index_element_size);
+        array->num_vertices = (int)(index_size / index_element_size);
         gl.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer->buffer_obj);
     } else {
         array->num_vertices = -1;
@@ -6812,13 +9405,17 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
     for (int i = 0; i < content_len; ++i) {
         PyObject * tuple = PyTuple_GET_ITEM(content, i);
 
-        MGLBuffer * buffer = (MGLBuffer *)PyTuple_GET_ITEM(tuple, 0);
+        MGLBuffer * buffer;
+        Py_ssize_t buffer_offset;
+        Py_ssize_t buffer_size;
+        parse_buffer_range(state, PyTuple_GET_ITEM(tuple, 0), &buffer, &buffer_offset, &buffer_size);
+
         const char * format = PyUnicode_AsUTF8(PyTuple_GET_ITEM(tuple, 1));
 
         FormatIterator it = FormatIterator(format);
         FormatInfo format_info = it.info();
 
-        int buf_vertices = (int)(buffer->size / format_info.size);
+        int buf_vertices = (int)(buffer_size / format_info.size);
 
         if (!format_info.divisor && array->index_buffer == (MGLBuffer *)Py_None && (!i || array->num_vertices > buf_vertices)) {
             array->num_vertices = buf_vertices;
@@ -6826,7 +9423,7 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
 
         gl.BindBuffer(GL_ARRAY_BUFFER, buffer->buffer_obj);
 
-        char * ptr = 0;
+        char * ptr = (char *)buffer_offset;
 
         int attributes_len = (int)PyTuple_GET_SIZE(tuple) - 2;
 
@@ -6882,19 +9479,21 @@ static PyObject * MGLContext_vertex_array(MGLContext * self, PyObject * args) {
     return Py_BuildValue("(Oi)", array, array->vertex_array_obj);
 }
 
-static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * args) {
+static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * const * args, Py_ssize_t nargs) {
+    MGLModuleState * state = module_state(self);
+    static const char * const keywords[] = {"mode", "vertices", "first", "instances"};
+    PyObject * values[4];
     int mode;
     int vertices;
-    int first;
-    int instances;
-
-    int args_ok = PyArg_ParseTuple(
-        args,
-        "IIII",
-        &mode,
-        &vertices,
-        &first,
-        &instances
+    int first;
+    int instances;
+
+    int args_ok = (
+        fastcall_args("render", args, nargs, NULL, keywords, 1, 4, values) &&
+        fastcall_int(values[0], 0, &mode) &&
+        fastcall_int(values[1], -1, &vertices) &&
+        fastcall_int(values[2], 0, &first) &&
+        fastcall_int(values[3], -1, &instances)
     );
 
     if (!args_ok) {
@@ -6920,7 +9519,7 @@ static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * args)
     gl.BindVertexArray(self->vertex_array_obj);
 
     if (self->index_buffer != (MGLBuffer *)Py_None) {
-        const void * ptr = (const void *)((GLintptr)first * self->index_element_size);
+        const void * ptr = (const void *)(self->index_offset + (GLintptr)first * self->index_element_size);
         gl.DrawElementsInstanced(mode, vertices, self->index_element_type, ptr, instances);
     } else {
         gl.DrawArraysInstanced(mode, first, vertices, instances);
@@ -6930,6 +9529,7 @@ static PyObject * MGLVertexArray_render(MGLVertexArray * self, PyObject * args)
 }
 
 static PyObject * MGLVertexArray_render_indirect(MGLVertexArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLBuffer * buffer;
     int mode;
     int count;
@@ -6953,6 +9553,12 @@ static PyObject * MGLVertexArray_render_indirect(MGLVertexArray * self, PyObject
         count = (int)(buffer->size / 20 - first);
     }
 
+    // The firstIndex of the commands counts from the start of the index buffer, a slice must be whole indices into it
+    if (self->index_buffer != (MGLBuffer *)Py_None && self->index_offset % self->index_element_size) {
+        MGLError_Set("the index buffer offset is not a multiple of the index element size");
+        return 0;
+    }
+
     const GLMethods & gl = self->context->gl;
 
     gl.UseProgram(self->program->program_obj);
@@ -6971,6 +9577,7 @@ static PyObject * MGLVertexArray_render_indirect(MGLVertexArray * self, PyObject
 }
 
 static PyObject * MGLVertexArray_transform(MGLVertexArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * outputs;
     int mode;
     int vertices;
@@ -7100,7 +9707,7 @@ static PyObject * MGLVertexArray_transform(MGLVertexArray * self, PyObject * arg
     gl.BeginTransformFeedback(output_mode);
 
     if (self->index_buffer != (MGLBuffer *)Py_None) {
-        const void * ptr = (const void *)((GLintptr)first * self->index_element_size);
+        const void * ptr = (const void *)(self->index_offset + (GLintptr)first * self->index_element_size);
         gl.DrawElementsInstanced(mode, vertices, self->index_element_type, ptr, instances);
     } else {
         gl.DrawArraysInstanced(mode, first, vertices, instances);
@@ -7116,6 +9723,7 @@ static PyObject * MGLVertexArray_transform(MGLVertexArray * self, PyObject * arg
 }
 
 static PyObject * MGLVertexArray_bind(MGLVertexArray * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     int location;
     const char * type;
     MGLBuffer * buffer;
@@ -7208,15 +9816,30 @@ static PyObject * MGLVertexArray_release(MGLVertexArray * self, PyObject * args)
 }
 
 static int MGLVertexArray_set_index_buffer(MGLVertexArray * self, PyObject * value, void * closure) {
-    if (Py_TYPE(value) != MGLBuffer_type) {
+    MGLModuleState * state = module_state(self);
+    MGLBuffer * index_buffer;
+    Py_ssize_t index_offset;
+    Py_ssize_t index_size;
+
+    if (!parse_buffer_range(state, value, &index_buffer, &index_offset, &index_size)) {
         MGLError_Set("the index_buffer must be a Buffer not %s", Py_TYPE(value)->tp_name);
         return -1;
     }
 
-    Py_INCREF(value);
+    if (index_buffer->context != self->context) {
+        MGLError_Set("the index_buffer belongs to a different context");
+        return -1;
+    }
+
+    const GLMethods & gl = self->context->gl;
+    gl.BindVertexArray(self->vertex_array_obj);
+    gl.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer->buffer_obj);
+
+    Py_INCREF(index_buffer);
     Py_DECREF(self->index_buffer);
-    self->index_buffer = (MGLBuffer *)value;
-    self->num_vertices = (int)(self->index_buffer->size / 4);
+    self->index_buffer = index_buffer;
+    self->index_offset = index_offset;
+    self->num_vertices = (int)(index_size / (self->index_element_size ? self->index_element_size : 4));
 
     return 0;
 }
@@ -7226,6 +9849,7 @@ static PyObject * MGLVertexArray_get_vertices(MGLVertexArray * self, void * clos
 }
 
 static int MGLVertexArray_set_vertices(MGLVertexArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int vertices = PyLong_AsUnsignedLong(value);
 
     if (PyErr_Occurred()) {
@@ -7243,6 +9867,7 @@ static PyObject * MGLVertexArray_get_instances(MGLVertexArray * self, void * clo
 }
 
 static int MGLVertexArray_set_instances(MGLVertexArray * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int instances = PyLong_AsUnsignedLong(value);
 
     if (PyErr_Occurred()) {
@@ -7256,6 +9881,7 @@ static int MGLVertexArray_set_instances(MGLVertexArray * self, PyObject * value,
 }
 
 static PyObject * MGLContext_set_label(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     const GLMethods & gl = self->gl;
 
     GLenum type = 0;
@@ -7271,8 +9897,8 @@ static PyObject * MGLContext_set_label(MGLContext * self, PyObject * args) {
     if (gl.ObjectLabel) {
         // OpenGL core 4.3
 
-        if (label_length > self->max_label_length) {
-            MGLError_Set("Context's max label length is %d, got one of length %d", self->max_label_length, label_length);
+        if (label_length > self->limits.max_label_length) {
+            MGLError_Set("Context's max label length is %d, got one of length %d", self->limits.max_label_length, label_length);
             return NULL;
         }
 
@@ -7319,6 +9945,7 @@ static PyObject * MGLContext_set_label(MGLContext * self, PyObject * args) {
 }
 
 static PyObject * MGLContext_get_label(MGLContext * ctx, PyObject * args) {
+    MGLModuleState * state = module_state(ctx);
     const GLMethods & gl = ctx->gl;
 
     GLenum type = 0;
@@ -7329,7 +9956,7 @@ static PyObject * MGLContext_get_label(MGLContext * ctx, PyObject * args) {
         return NULL;
     }
 
-    int label_buffer_length = ctx->max_label_length + 1;
+    int label_buffer_length = ctx->limits.max_label_length + 1;
     char * label = new char[label_buffer_length];
     GLsizei label_length = 0;
     if (gl.GetObjectLabel) {
@@ -7373,6 +10000,7 @@ static PyObject * MGLContext_get_label(MGLContext * ctx, PyObject * args) {
 }
 
 static PyObject * MGLContext_push_debug_scope(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     const GLMethods& gl = self->gl;
 
     GLenum source = 0;
@@ -7388,16 +10016,16 @@ static PyObject * MGLContext_push_debug_scope(MGLContext * self, PyObject * args
     if (gl.PushDebugGroup) {
         // OpenGL core 4.3
 
-        if (message_length >= self->max_debug_message_length) {
-            MGLError_Set("Context's max debug message length is %d, got one of length %d", self->max_debug_message_length, message_length);
+        if (message_length >= self->limits.max_debug_message_length) {
+            MGLError_Set("Context's max debug message length is %d, got one of length %d", self->limits.max_debug_message_length, message_length);
             return NULL;
         }
 
         int scope_stack_depth = 0;
         gl.GetIntegerv(GL_DEBUG_GROUP_STACK_DEPTH, &scope_stack_depth);
 
-        if (scope_stack_depth >= self->max_debug_group_stack_depth) {
-            MGLError_Set("Context's max debug group stack depth is %d, cannot push more scopes", self->max_debug_group_stack_depth);
+        if (scope_stack_depth >= self->limits.max_debug_group_stack_depth) {
+            MGLError_Set("Context's max debug group stack depth is %d, cannot push more scopes", self->limits.max_debug_group_stack_depth);
             return NULL;
         }
 
@@ -7424,6 +10052,7 @@ static PyObject * MGLContext_push_debug_scope(MGLContext * self, PyObject * args
 }
 
 static PyObject * MGLContext_pop_debug_scope(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
 
     const GLMethods& gl = self->gl;
 
@@ -7447,6 +10076,417 @@ static PyObject * MGLContext_pop_debug_scope(MGLContext * self, PyObject * args)
     Py_RETURN_NONE;
 }
 
+static void end_gl_capture(GLTrace * trace) {
+    // The traced calls on other threads see the capture only under the lock
+    gl_trace_lock.lock();
+    GLCapture * capture = trace->capture;
+    trace->capture = NULL;
+    gl_trace_lock.unlock();
+
+    if (!capture) {
+        return;
+    }
+
+    gl_capture_flush(*capture);
+    fclose(capture->file);
+    delete[] capture->data;
+    delete capture;
+}
+
+static void release_gl_trace(MGLContext * self) {
+    if (!self->trace) {
+        return;
+    }
+
+    end_gl_capture(self->trace);
+    self->gl = self->trace->original;
+
+    gl_trace_lock.lock();
+    if (gl_trace == self->trace) {
+        gl_trace = NULL;
+    }
+    gl_trace_lock.unlock();
+
+    delete[] self->trace->events;
+    delete self->trace;
+    self->trace = NULL;
+}
+
+static void reset_gl_trace(GLTrace * trace) {
+    std::lock_guard<std::mutex> guard(gl_trace_lock);
+    memset(trace->calls, 0, sizeof(trace->calls));
+    memset(trace->time, 0, sizeof(trace->time));
+    trace->num_events = 0;
+    trace->origin = std::chrono::steady_clock::now();
+}
+
+// Installs the instrumented dispatch table shared by the gl stats and the capture
+static bool acquire_gl_trace(MGLContext * self) {
+    MGLModuleState * state = module_state(self);
+    gl_trace_lock.lock();
+    bool busy = gl_trace && gl_trace != self->trace;
+    if (!busy && !self->trace) {
+        self->trace = trace_gl_methods(self->gl);
+        gl_trace = self->trace;
+    }
+    gl_trace_lock.unlock();
+
+    if (busy) {
+        MGLError_Set("another context is already traced");
+        return false;
+    }
+
+    return true;
+}
+
+static PyObject * MGLContext_enable_gl_stats(MGLContext * self, PyObject * args) {
+    int max_events;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "I",
+        &max_events
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (!acquire_gl_trace(self)) {
+        return 0;
+    }
+
+    GLTrace * trace = self->trace;
+    GLTraceEvent * events = max_events ? new GLTraceEvent[max_events] : NULL;
+    gl_trace_lock.lock();
+    std::swap(trace->events, events);
+    trace->max_events = max_events;
+    trace->stats = true;
+    gl_trace_lock.unlock();
+    delete[] events;
+    reset_gl_trace(trace);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_disable_gl_stats(MGLContext * self, PyObject * args) {
+    if (self->trace && self->trace->capture) {
+        self->trace->stats = false;
+        Py_RETURN_NONE;
+    }
+
+    release_gl_trace(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_reset_gl_stats(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    GLTrace * trace = self->trace;
+
+    if (!trace || !trace->stats) {
+        MGLError_Set("gl stats are not enabled");
+        return 0;
+    }
+
+    reset_gl_trace(trace);
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_gl_stats(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    GLTrace * trace = self->trace;
+
+    if (!trace || !trace->stats) {
+        MGLError_Set("gl stats are not enabled");
+        return 0;
+    }
+
+    // The counters are copied at once, no Python object is created under the lock
+    long long * calls = new long long[GL_TRACE_MAX_METHODS * 2];
+    long long * time = calls + GL_TRACE_MAX_METHODS;
+    gl_trace_lock.lock();
+    memcpy(calls, trace->calls, sizeof(trace->calls));
+    memcpy(time, trace->time, sizeof(trace->time));
+    gl_trace_lock.unlock();
+
+    PyObject * res = PyDict_New();
+
+    for (int i = 0; i < trace->num_methods; ++i) {
+        if (!calls[i]) {
+            continue;
+        }
+
+        PyObject * value = Py_BuildValue("(LL)", calls[i], time[i]);
+        PyDict_SetItemString(res, trace->names[i], value);
+        Py_DECREF(value);
+    }
+
+    delete[] calls;
+    return res;
+}
+
+static PyObject * MGLContext_gl_trace(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    GLTrace * trace = self->trace;
+
+    if (!trace || !trace->stats) {
+        MGLError_Set("gl stats are not enabled");
+        return 0;
+    }
+
+    // The ring buffer keeps the most recent calls, oldest first
+    std::vector<GLTraceEvent> events;
+    gl_trace_lock.lock();
+    long long first = trace->num_events > trace->max_events ? trace->num_events - trace->max_events : 0;
+    for (long long i = first; i < trace->num_events; ++i) {
+        events.push_back(trace->events[i % trace->max_events]);
+    }
+    gl_trace_lock.unlock();
+
+    PyObject * res = PyList_New((Py_ssize_t)events.size());
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        PyList_SET_ITEM(res, (Py_ssize_t)i, Py_BuildValue("(sLL)", trace->names[events[i].method], events[i].start, events[i].duration));
+    }
+
+    return res;
+}
+
+#define GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX 0x9047
+#define GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX 0x9048
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#define GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX 0x904B
+#define GL_VBO_FREE_MEMORY_ATI 0x87FB
+#define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+#define GL_RENDERBUFFER_FREE_MEMORY_ATI 0x87FD
+
+static PyObject * gpu_memory_info(MGLContext * self) {
+    const GLMethods & gl = self->gl;
+
+    // Both extensions report kilobytes
+    if (has_extension(self, "GL_NVX_gpu_memory_info")) {
+        int dedicated = 0;
+        int total_available = 0;
+        int current_available = 0;
+        int evicted = 0;
+        gl.GetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicated);
+        gl.GetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total_available);
+        gl.GetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &current_available);
+        gl.GetIntegerv(GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX, &evicted);
+        return Py_BuildValue(
+            "{sLsLsLsL}",
+            "dedicated", (long long)dedicated * 1024,
+            "total_available", (long long)total_available * 1024,
+            "current_available", (long long)current_available * 1024,
+            "evicted", (long long)evicted * 1024
+        );
+    }
+
+    if (has_extension(self, "GL_ATI_meminfo")) {
+        int vbo_free[4] = {};
+        int texture_free[4] = {};
+        int renderbuffer_free[4] = {};
+        gl.GetIntegerv(GL_VBO_FREE_MEMORY_ATI, vbo_free);
+        gl.GetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, texture_free);
+        gl.GetIntegerv(GL_RENDERBUFFER_FREE_MEMORY_ATI, renderbuffer_free);
+        return Py_BuildValue(
+            "{sLsLsL}",
+            "buffer_free", (long long)vbo_free[0] * 1024,
+            "texture_free", (long long)texture_free[0] * 1024,
+            "renderbuffer_free", (long long)renderbuffer_free[0] * 1024
+        );
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_memory_stats(MGLContext * self, PyObject * args) {
+    int reset_peak;
+
+    if (!PyArg_ParseTuple(args, "p", &reset_peak)) {
+        return 0;
+    }
+
+    // The counters are copied at once, objects may be created or released on other threads
+    MGLMutex_Lock(self->lock);
+    MGLMemoryStats stats = self->memory;
+    PyObject * objects = stats.objects ? PyDict_Copy(stats.objects) : PyDict_New();
+
+    long long total = 0;
+    for (int i = 0; i < MGL_MEMORY_KINDS; ++i) {
+        total += stats.total[i];
+    }
+
+    if (reset_peak) {
+        for (int i = 0; i < MGL_MEMORY_KINDS; ++i) {
+            self->memory.peak[i] = stats.total[i];
+        }
+        self->memory.peak_total = total;
+    }
+    MGLMutex_Unlock(self->lock);
+
+    PyObject * res = PyDict_New();
+
+    for (int i = 0; i < MGL_MEMORY_KINDS; ++i) {
+        PyObject * value = Py_BuildValue("{sLsLsL}", "count", stats.count[i], "total", stats.total[i], "peak", stats.peak[i]);
+        PyDict_SetItemString(res, memory_kind_names[i], value);
+        Py_DECREF(value);
+    }
+
+    PyObject * value = Py_BuildValue("{sLsLsNsN}", "total", total, "peak", stats.peak_total, "objects", objects, "gpu", gpu_memory_info(self));
+    PyDict_Update(res, value);
+    Py_DECREF(value);
+
+    return res;
+}
+
+static PyObject * MGLContext_begin_capture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    PyObject * path;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O&",
+        PyUnicode_FSConverter,
+        &path
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->trace && self->trace->capture) {
+        MGLError_Set("the context is already capturing");
+        Py_DECREF(path);
+        return 0;
+    }
+
+    FILE * file = fopen(PyBytes_AS_STRING(path), "wb");
+
+    if (!file) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        Py_DECREF(path);
+        return 0;
+    }
+
+    Py_DECREF(path);
+
+    if (!acquire_gl_trace(self)) {
+        fclose(file);
+        return 0;
+    }
+
+    GLTrace * trace = self->trace;
+    const GLMethods & gl = trace->original;
+
+    GLCapture * capture = new GLCapture();
+    capture->file = file;
+    capture->data = new char[GL_CAPTURE_BUFFER_SIZE];
+    gl.GetIntegerv(GL_PACK_ALIGNMENT, &capture->pack_alignment);
+    gl.GetIntegerv(GL_UNPACK_ALIGNMENT, &capture->unpack_alignment);
+    gl.GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &capture->pack_buffer);
+    gl.GetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &capture->unpack_buffer);
+
+    if (self->version_code >= 440 || has_extension(self, "GL_ARB_query_buffer_object")) {
+        gl.GetIntegerv(GL_QUERY_BUFFER_BINDING, &capture->query_buffer);
+    }
+
+    // The header lists the captured methods, calls refer to them by index
+    unsigned num_methods = trace->num_methods;
+    gl_capture_write(*capture, gl_capture_magic, 8);
+    gl_capture_write(*capture, &num_methods, 4);
+    for (int i = 0; i < trace->num_methods; ++i) {
+        gl_capture_write(*capture, trace->names[i], strlen(trace->names[i]) + 1);
+    }
+
+    gl_trace_lock.lock();
+    trace->capture = capture;
+    gl_trace_lock.unlock();
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_end_capture(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    if (!self->trace || !self->trace->capture) {
+        MGLError_Set("the context is not capturing");
+        return 0;
+    }
+
+    end_gl_capture(self->trace);
+
+    if (!self->trace->stats) {
+        release_gl_trace(self);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject * MGLContext_replay(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    PyObject * path;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O&",
+        PyUnicode_FSConverter,
+        &path
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    if (self->trace && self->trace->capture) {
+        MGLError_Set("cannot replay while capturing");
+        Py_DECREF(path);
+        return 0;
+    }
+
+    Py_ssize_t size = -1;
+    FILE * file = open_file_range(state, path, 0, &size);
+    Py_DECREF(path);
+
+    if (!file) {
+        return 0;
+    }
+
+    char * data = new char[size ? size : 1];
+    bool read_ok = read_file_chunk(state, file, data, size);
+    fclose(file);
+
+    if (!read_ok) {
+        delete[] data;
+        return 0;
+    }
+
+    GLReplay replay = {};
+    replay.ptr = data;
+    replay.end = data + size;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    long long calls = replay_gl_capture(self->gl, replay);
+    long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (calls < 0) {
+        if (replay.name) {
+            MGLError_Set("%s at %s", replay.error, replay.name);
+        } else {
+            MGLError_Set("%s", replay.error);
+        }
+    }
+
+    delete[] replay.names;
+    delete[] replay.methods;
+    delete[] replay.scratch;
+    delete[] replay.strings;
+    delete[] data;
+
+    if (calls < 0) {
+        return 0;
+    }
+
+    return Py_BuildValue("(LL)", calls, elapsed);
+}
+
 static PyObject * MGLContext_enable_only(MGLContext * self, PyObject * args) {
     int flags;
 
@@ -7460,7 +10500,9 @@ static PyObject * MGLContext_enable_only(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    MGLMutex_Lock(self->lock);
     self->enable_flags = flags;
+    MGLMutex_Unlock(self->lock);
 
     if (flags & MGL_BLEND) {
         self->gl.Enable(GL_BLEND);
@@ -7508,7 +10550,9 @@ static PyObject * MGLContext_enable(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    MGLMutex_Lock(self->lock);
     self->enable_flags |= flags;
+    MGLMutex_Unlock(self->lock);
 
     if (flags & MGL_BLEND) {
         self->gl.Enable(GL_BLEND);
@@ -7546,7 +10590,9 @@ static PyObject * MGLContext_disable(MGLContext * self, PyObject * args) {
         return 0;
     }
 
+    MGLMutex_Lock(self->lock);
     self->enable_flags &= ~flags;
+    MGLMutex_Unlock(self->lock);
 
     if (flags & MGL_BLEND) {
         self->gl.Disable(GL_BLEND);
@@ -7611,6 +10657,7 @@ static PyObject * MGLContext_finish(MGLContext * self, PyObject * args) {
 }
 
 static PyObject * MGLContext_copy_buffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     MGLBuffer * dst;
     MGLBuffer * src;
 
@@ -7638,26 +10685,166 @@ static PyObject * MGLContext_copy_buffer(MGLContext * self, PyObject * args) {
         size = src->size - read_offset;
     }
 
-    if (read_offset < 0 || write_offset < 0) {
-        MGLError_Set("buffer underflow");
-        return 0;
-    }
+    if (read_offset < 0 || write_offset < 0) {
+        MGLError_Set("buffer underflow");
+        return 0;
+    }
+
+    if (read_offset + size > src->size || write_offset + size > dst->size) {
+        MGLError_Set("buffer overflow");
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    gl.BindBuffer(GL_COPY_READ_BUFFER, src->buffer_obj);
+    gl.BindBuffer(GL_COPY_WRITE_BUFFER, dst->buffer_obj);
+    gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, read_offset, write_offset, size);
+
+    Py_RETURN_NONE;
+}
+
+struct MGLBufferCopy {
+    MGLBuffer * dst;
+    MGLBuffer * src;
+    Py_ssize_t size;
+    Py_ssize_t read_offset;
+    Py_ssize_t write_offset;
+};
+
+// Accepts the moderngl.Buffer wrapper too, unwrapping thousands of items in Python would cost more than the copies
+static MGLBuffer * buffer_copy_arg(MGLModuleState * state, PyObject * obj) {
+    if (Py_TYPE(obj) == state->buffer_type) {
+        return (MGLBuffer *)obj;
+    }
+    PyObject * mglo = PyObject_GetAttr(obj, state->mglo_str);
+    if (!mglo) {
+        PyErr_Clear();
+        return 0;
+    }
+    // The wrapper keeps its mglo alive
+    Py_DECREF(mglo);
+    return Py_TYPE(mglo) == state->buffer_type ? (MGLBuffer *)mglo : 0;
+}
+
+static PyObject * MGLContext_copy_buffers(MGLContext * self, PyObject * args) {
+    PyObject * copies_arg;
+
+    int args_ok = PyArg_ParseTuple(
+        args,
+        "O",
+        &copies_arg
+    );
+
+    if (!args_ok) {
+        return 0;
+    }
+
+    PyObject * seq = PySequence_Fast(copies_arg, "copies must be a sequence");
+    if (!seq) {
+        return 0;
+    }
+
+    Py_ssize_t num_copies = PySequence_Fast_GET_SIZE(seq);
+    PyObject ** items = PySequence_Fast_ITEMS(seq);
+    MGLBufferCopy * copies = new MGLBufferCopy[num_copies > 0 ? num_copies : 1];
+    MGLModuleState * state = module_state(self);
+
+    // Every copy is validated before the first one is issued
+    for (Py_ssize_t i = 0; i < num_copies; ++i) {
+        MGLBufferCopy & copy = copies[i];
+        copy.size = -1;
+        copy.read_offset = 0;
+        copy.write_offset = 0;
+
+        if (!PyTuple_Check(items[i])) {
+            MGLError_Set("copies[%d] must be a tuple", (int)i);
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        // Parsed by hand, a format string per item costs as much as a small copy
+        Py_ssize_t item_size = PyTuple_GET_SIZE(items[i]);
+        copy.dst = item_size >= 2 ? buffer_copy_arg(state, PyTuple_GET_ITEM(items[i], 0)) : 0;
+        copy.src = item_size >= 2 ? buffer_copy_arg(state, PyTuple_GET_ITEM(items[i], 1)) : 0;
+
+        if (item_size > 5 || !copy.dst || !copy.src) {
+            MGLError_Set("copies[%d] must be (dst, src, size, read_offset, write_offset)", (int)i);
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        Py_ssize_t * fields[3] = {&copy.size, &copy.read_offset, &copy.write_offset};
+        for (Py_ssize_t j = 2; j < item_size; ++j) {
+            *fields[j - 2] = PyLong_AsSsize_t(PyTuple_GET_ITEM(items[i], j));
+        }
+
+        if (PyErr_Occurred()) {
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (copy.size < 0) {
+            copy.size = copy.src->size - copy.read_offset;
+        }
+
+        if (copy.read_offset < 0 || copy.write_offset < 0) {
+            MGLError_Set("copies[%d]: buffer underflow", (int)i);
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
+
+        if (copy.read_offset + copy.size > copy.src->size || copy.write_offset + copy.size > copy.dst->size) {
+            MGLError_Set("copies[%d]: buffer overflow", (int)i);
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
 
-    if (read_offset + size > src->size || write_offset + size > dst->size) {
-        MGLError_Set("buffer overflow");
-        return 0;
+        if (copy.dst == copy.src && copy.read_offset < copy.write_offset + copy.size && copy.write_offset < copy.read_offset + copy.size) {
+            MGLError_Set("copies[%d]: the ranges overlap", (int)i);
+            delete[] copies;
+            Py_DECREF(seq);
+            return 0;
+        }
     }
 
     const GLMethods & gl = self->gl;
 
-    gl.BindBuffer(GL_COPY_READ_BUFFER, src->buffer_obj);
-    gl.BindBuffer(GL_COPY_WRITE_BUFFER, dst->buffer_obj);
-    gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, read_offset, write_offset, size);
+    if (gl.CopyNamedBufferSubData && (self->version_code >= 450 || has_extension(self, "GL_ARB_direct_state_access"))) {
+        for (Py_ssize_t i = 0; i < num_copies; ++i) {
+            const MGLBufferCopy & copy = copies[i];
+            gl.CopyNamedBufferSubData(copy.src->buffer_obj, copy.dst->buffer_obj, copy.read_offset, copy.write_offset, copy.size);
+        }
+    } else {
+        // Consecutive copies between the same buffers keep their bindings
+        int read_obj = -1;
+        int write_obj = -1;
+        for (Py_ssize_t i = 0; i < num_copies; ++i) {
+            const MGLBufferCopy & copy = copies[i];
+            if (copy.src->buffer_obj != read_obj) {
+                read_obj = copy.src->buffer_obj;
+                gl.BindBuffer(GL_COPY_READ_BUFFER, read_obj);
+            }
+            if (copy.dst->buffer_obj != write_obj) {
+                write_obj = copy.dst->buffer_obj;
+                gl.BindBuffer(GL_COPY_WRITE_BUFFER, write_obj);
+            }
+            gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, copy.read_offset, copy.write_offset, copy.size);
+        }
+    }
 
+    delete[] copies;
+    Py_DECREF(seq);
     Py_RETURN_NONE;
 }
 
 static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * dst;
     MGLFramebuffer * src;
 
@@ -7778,6 +10965,7 @@ static PyObject * MGLContext_copy_framebuffer(MGLContext * self, PyObject * args
 }
 
 static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
     PyObject * glo;
 
     int args_ok = PyArg_ParseTuple(
@@ -7811,9 +10999,9 @@ static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * ar
 
     gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
 
-    int num_color_attachments = self->max_color_attachments;
+    int num_color_attachments = self->limits.max_color_attachments;
 
-    for (int i = 0; i < self->max_color_attachments; ++i) {
+    for (int i = 0; i < self->limits.max_color_attachments; ++i) {
         int color_attachment_type = 0;
         gl.GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &color_attachment_type);
 
@@ -7851,6 +11039,11 @@ static PyObject * MGLContext_detect_framebuffer(MGLContext * self, PyObject * ar
     MGLFramebuffer * framebuffer = PyObject_New(MGLFramebuffer, MGLFramebuffer_type);
     framebuffer->released = false;
 
+    framebuffer->resolve_framebuffer_obj = 0;
+    framebuffer->resolve_textures = NULL;
+    framebuffer->resolve_depth_texture = NULL;
+    framebuffer->resolve_draw_buffers = NULL;
+
     framebuffer->framebuffer_obj = framebuffer_obj;
 
     framebuffer->draw_buffers_len = num_color_attachments;
@@ -7895,9 +11088,9 @@ static PyObject * MGLContext_clear_samplers(MGLContext * self, PyObject * args)
 
     start = MGL_MAX(start, 0);
     if (end == -1) {
-        end = self->max_texture_units;
+        end = self->limits.max_texture_image_units;
     } else {
-        end = MGL_MIN(end, self->max_texture_units);
+        end = MGL_MIN(end, self->limits.max_texture_image_units);
     }
 
     const GLMethods & gl = self->gl;
@@ -7917,11 +11110,405 @@ static PyObject * MGLContext_exit(MGLContext * self, PyObject * args) {
     return PyObject_CallMethod(self->ctx, "__exit__", NULL);
 }
 
+static PyObject * MGLContext_fence(MGLContext * self, PyObject * args) {
+    const GLMethods & gl = self->gl;
+
+    // The flush makes the fence visible to the shared contexts
+    GLsync sync = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl.Flush();
+
+    return PyLong_FromVoidPtr((void *)sync);
+}
+
+static PyObject * MGLContext_wait_fence(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    PyObject * handle;
+    int client;
+
+    if (!PyArg_ParseTuple(args, "Op", &handle, &client)) {
+        return 0;
+    }
+
+    GLsync sync = (GLsync)PyLong_AsVoidPtr(handle);
+    if (PyErr_Occurred()) {
+        return 0;
+    }
+
+    const GLMethods & gl = self->gl;
+
+    if (client) {
+        int status = 0;
+        Py_BEGIN_ALLOW_THREADS
+        status = gl.ClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        Py_END_ALLOW_THREADS
+        if (status == GL_WAIT_FAILED) {
+            MGLError_Set("cannot wait for the fence");
+            return 0;
+        }
+    } else {
+        gl.WaitSync(sync, 0, GL_TIMEOUT_IGNORED);
+    }
+
+    gl.DeleteSync(sync);
+    Py_RETURN_NONE;
+}
+
+static void adopt_object(MGLContext * self, MGLContext ** context, int kind, int glo) {
+    MGLContext * old = *context;
+
+    if (kind >= 0) {
+        PyObject * key = Py_BuildValue("(ii)", memory_label_types[kind], glo);
+        MGLMutex_Lock(old->lock);
+        PyObject * size = old->memory.objects ? PyDict_GetItem(old->memory.objects, key) : NULL;
+        long long memory = size ? PyLong_AsLongLong(size) : 0;
+        MGLMutex_Unlock(old->lock);
+        Py_DECREF(key);
+
+        memory_track(old, kind, glo, 0);
+        memory_track(self, kind, glo, memory);
+    }
+
+    Py_INCREF(self);
+    *context = self;
+    Py_DECREF(old);
+}
+
+static PyObject * MGLContext_adopt(MGLContext * self, PyObject * obj) {
+    MGLModuleState * state = module_state(self);
+    // Objects created by a shared context are moved over, their names are valid in both contexts
+    PyTypeObject * type = Py_TYPE(obj);
+
+    if (type == MGLBuffer_type) {
+        adopt_object(self, &((MGLBuffer *)obj)->context, MGL_MEMORY_BUFFER, ((MGLBuffer *)obj)->buffer_obj);
+    } else if (type == MGLTexture_type) {
+        adopt_object(self, &((MGLTexture *)obj)->context, MGL_MEMORY_TEXTURE, ((MGLTexture *)obj)->texture_obj);
+    } else if (type == MGLTexture3D_type) {
+        adopt_object(self, &((MGLTexture3D *)obj)->context, MGL_MEMORY_TEXTURE, ((MGLTexture3D *)obj)->texture_obj);
+    } else if (type == MGLTextureArray_type) {
+        adopt_object(self, &((MGLTextureArray *)obj)->context, MGL_MEMORY_TEXTURE, ((MGLTextureArray *)obj)->texture_obj);
+    } else if (type == MGLTextureCube_type) {
+        adopt_object(self, &((MGLTextureCube *)obj)->context, MGL_MEMORY_TEXTURE, ((MGLTextureCube *)obj)->texture_obj);
+    } else if (type == MGLRenderbuffer_type) {
+        adopt_object(self, &((MGLRenderbuffer *)obj)->context, MGL_MEMORY_RENDERBUFFER, ((MGLRenderbuffer *)obj)->renderbuffer_obj);
+    } else if (type == MGLSampler_type) {
+        adopt_object(self, &((MGLSampler *)obj)->context, -1, 0);
+    } else if (type == MGLProgram_type) {
+        adopt_object(self, &((MGLProgram *)obj)->context, -1, 0);
+    } else {
+        MGLError_Set("%s objects cannot be shared between contexts", type->tp_name);
+        return 0;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static bool release_queue_push(MGLContext * ctx, int kind, int name) {
+    MGLReleaseQueue & queue = ctx->release_queue;
+
+    // The names of a released context are gone with it, the objects are only marked released
+    if (ctx->released) {
+        return true;
+    }
+
+    if (queue.count[kind] == queue.capacity[kind]) {
+        int capacity = MGL_MAX(queue.capacity[kind] * 2, 64);
+        GLuint * names = (GLuint *)PyMem_Realloc(queue.names[kind], capacity * sizeof(GLuint));
+        if (!names) {
+            return false;
+        }
+        queue.names[kind] = names;
+        queue.capacity[kind] = capacity;
+    }
+
+    queue.names[kind][queue.count[kind]++] = name;
+    return true;
+}
+
+static PyObject * MGLContext_defer_release(MGLContext * self, PyObject * obj) {
+    MGLModuleState * state = module_state(self);
+    // No GL calls are made here, the objects may be collected on any thread.
+    // The native objects are marked released right away and their names are deleted by release_deferred()
+    MGLReleaseQueue & queue = self->release_queue;
+    PyTypeObject * type = Py_TYPE(obj);
+    bool queued = true;
+
+    MGLMutex_Lock(self->lock);
+
+    if (type == MGLBuffer_type && !((MGLBuffer *)obj)->mapped) {
+        MGLBuffer * buffer = (MGLBuffer *)obj;
+        if (!buffer->released && !buffer->external && release_queue_push(self, MGL_RELEASE_BUFFER, buffer->buffer_obj)) {
+            buffer->released = true;
+            Py_DECREF(buffer->context);
+            Py_DECREF(buffer);
+        }
+    } else if (type == MGLTexture_type) {
+        // External textures are not owned, there is nothing to delete
+        MGLTexture * texture = (MGLTexture *)obj;
+        if (!texture->released && !texture->external && release_queue_push(self, MGL_RELEASE_TEXTURE, texture->texture_obj)) {
+            texture->released = true;
+            Py_DECREF(texture->context);
+            Py_DECREF(texture);
+        }
+    } else if (type == MGLTexture3D_type) {
+        MGLTexture3D * texture = (MGLTexture3D *)obj;
+        if (!texture->released && release_queue_push(self, MGL_RELEASE_TEXTURE, texture->texture_obj)) {
+            texture->released = true;
+            Py_DECREF(texture->context);
+            Py_DECREF(texture);
+        }
+    } else if (type == MGLTextureArray_type) {
+        MGLTextureArray * texture = (MGLTextureArray *)obj;
+        if (!texture->released && release_queue_push(self, MGL_RELEASE_TEXTURE, texture->texture_obj)) {
+            texture->released = true;
+            Py_DECREF(texture->context);
+            Py_DECREF(texture);
+        }
+    } else if (type == MGLTextureCube_type) {
+        MGLTextureCube * texture = (MGLTextureCube *)obj;
+        if (!texture->released && release_queue_push(self, MGL_RELEASE_TEXTURE, texture->texture_obj)) {
+            texture->released = true;
+            Py_DECREF(texture);
+        }
+    } else if (type == MGLRenderbuffer_type) {
+        MGLRenderbuffer * renderbuffer = (MGLRenderbuffer *)obj;
+        if (!renderbuffer->released && release_queue_push(self, MGL_RELEASE_RENDERBUFFER, renderbuffer->renderbuffer_obj)) {
+            renderbuffer->released = true;
+            Py_DECREF(renderbuffer);
+        }
+    } else if (type == MGLSampler_type) {
+        MGLSampler * sampler = (MGLSampler *)obj;
+        if (!sampler->released && release_queue_push(self, MGL_RELEASE_SAMPLER, sampler->sampler_obj)) {
+            sampler->released = true;
+            Py_DECREF(sampler->context);
+            Py_DECREF(sampler);
+        }
+    } else if (type == MGLVertexArray_type) {
+        MGLVertexArray * vertex_array = (MGLVertexArray *)obj;
+        if (!vertex_array->released && release_queue_push(self, MGL_RELEASE_VERTEX_ARRAY, vertex_array->vertex_array_obj)) {
+            vertex_array->released = true;
+            Py_DECREF(vertex_array->program);
+            Py_XDECREF(vertex_array->index_buffer);
+            Py_DECREF(vertex_array);
+        }
+    } else if (type == MGLFramebuffer_type && !((MGLFramebuffer *)obj)->resolve_framebuffer_obj) {
+        MGLFramebuffer * framebuffer = (MGLFramebuffer *)obj;
+        if (!framebuffer->released && release_queue_push(self, MGL_RELEASE_FRAMEBUFFER, framebuffer->framebuffer_obj)) {
+            framebuffer->released = true;
+            if (framebuffer->framebuffer_obj) {
+                Py_DECREF(framebuffer->context);
+            }
+            Py_DECREF(framebuffer);
+        }
+    } else {
+        queued = false;
+    }
+    MGLMutex_Unlock(self->lock);
+
+    // Other objects are released one by one, InvalidObject instances of already released objects are skipped
+    if (!queued && PyObject_HasAttrString(obj, "release")) {
+        MGLMutex_Lock(self->lock);
+        int err = queue.objects ? PyList_Append(queue.objects, obj) : 0;
+        MGLMutex_Unlock(self->lock);
+        if (err < 0) {
+            return 0;
+        }
+    }
+
+    Py_RETURN_NONE;
+}
+
+// Objects released one by one that are already released, their release() does nothing
+static bool already_released(MGLModuleState * state, PyObject * obj) {
+    PyTypeObject * type = Py_TYPE(obj);
+    if (type == MGLBuffer_type) {
+        return ((MGLBuffer *)obj)->released || ((MGLBuffer *)obj)->external;
+    }
+    if (type == MGLProgram_type) {
+        return ((MGLProgram *)obj)->released;
+    }
+    if (type == MGLQuery_type) {
+        return ((MGLQuery *)obj)->released;
+    }
+    if (type == MGLOcclusionCuller_type) {
+        return ((MGLOcclusionCuller *)obj)->released;
+    }
+    if (type == MGLScope_type) {
+        return ((MGLScope *)obj)->released;
+    }
+    if (type == MGLTexture_type) {
+        return ((MGLTexture *)obj)->released || ((MGLTexture *)obj)->external;
+    }
+    if (type == MGLFramebuffer_type) {
+        return ((MGLFramebuffer *)obj)->released;
+    }
+    return false;
+}
+
+static PyObject * MGLContext_release_deferred(MGLContext * self, PyObject * args) {
+    MGLModuleState * state = module_state(self);
+    MGLReleaseQueue & queue = self->release_queue;
+
+    if (self->released) {
+        return PyLong_FromLong(0);
+    }
+
+    // Only the names deleted and the objects released here are counted
+    int released = 0;
+
+    // Buffers mapped by a view stay queued for a later call
+    PyObject * mapped = PyList_New(0);
+    if (!mapped) {
+        return 0;
+    }
+
+    // Releasing an object may defer others
+    while (true) {
+        MGLMutex_Lock(self->lock);
+        PyObject * objects = NULL;
+        if (PyList_GET_SIZE(queue.objects)) {
+            objects = queue.objects;
+            queue.objects = PyList_New(0);
+        }
+        MGLMutex_Unlock(self->lock);
+
+        if (!objects) {
+            break;
+        }
+
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(objects); ++i) {
+            PyObject * obj = PyList_GET_ITEM(objects, i);
+            if (already_released(state, obj)) {
+                continue;
+            }
+            if (Py_TYPE(obj) == MGLBuffer_type && ((MGLBuffer *)obj)->mapped) {
+                if (PyList_Append(mapped, obj) < 0) {
+                    Py_DECREF(objects);
+                    Py_DECREF(mapped);
+                    return 0;
+                }
+                continue;
+            }
+            PyObject * res = PyObject_CallMethod(obj, "release", NULL);
+            if (!res) {
+                Py_DECREF(objects);
+                Py_DECREF(mapped);
+                return 0;
+            }
+            Py_DECREF(res);
+            released += 1;
+        }
+
+        Py_DECREF(objects);
+    }
+
+    if (PyList_GET_SIZE(mapped)) {
+        MGLMutex_Lock(self->lock);
+        int res = PyList_SetSlice(queue.objects, 0, 0, mapped);
+        MGLMutex_Unlock(self->lock);
+        if (res < 0) {
+            Py_DECREF(mapped);
+            return 0;
+        }
+    }
+    Py_DECREF(mapped);
+
+    const GLMethods & gl = self->gl;
+
+    for (int kind = 0; kind < MGL_RELEASE_KINDS; ++kind) {
+        // The names are taken out of the queue, other threads keep deferring into a new array meanwhile
+        MGLMutex_Lock(self->lock);
+        int count = queue.count[kind];
+        int capacity = queue.capacity[kind];
+        GLuint * names = queue.names[kind];
+        if (count) {
+            queue.count[kind] = 0;
+            queue.capacity[kind] = 0;
+            queue.names[kind] = NULL;
+        }
+        MGLMutex_Unlock(self->lock);
+
+        if (!count) {
+            continue;
+        }
+
+        released += count;
+
+        switch (kind) {
+            case MGL_RELEASE_VERTEX_ARRAY: gl.DeleteVertexArrays(count, names); break;
+            case MGL_RELEASE_FRAMEBUFFER: gl.DeleteFramebuffers(count, names); break;
+            case MGL_RELEASE_SAMPLER: gl.DeleteSamplers(count, names); break;
+            case MGL_RELEASE_BUFFER: gl.DeleteBuffers(count, names); break;
+            case MGL_RELEASE_TEXTURE: gl.DeleteTextures(count, names); break;
+            case MGL_RELEASE_RENDERBUFFER: gl.DeleteRenderbuffers(count, names); break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            switch (kind) {
+                case MGL_RELEASE_BUFFER: memory_track(self, MGL_MEMORY_BUFFER, names[i], 0); break;
+                case MGL_RELEASE_TEXTURE: memory_track(self, MGL_MEMORY_TEXTURE, names[i], 0); break;
+                case MGL_RELEASE_RENDERBUFFER: memory_track(self, MGL_MEMORY_RENDERBUFFER, names[i], 0); break;
+            }
+        }
+
+        MGLMutex_Lock(self->lock);
+        if (!queue.names[kind]) {
+            queue.names[kind] = names;
+            queue.capacity[kind] = capacity;
+            names = NULL;
+        }
+        MGLMutex_Unlock(self->lock);
+        PyMem_Free(names);
+    }
+
+    return PyLong_FromLong(released);
+}
+
 static PyObject * MGLContext_release(MGLContext * self, PyObject * args) {
     if (self->released) {
         Py_RETURN_NONE;
     }
+
+    PyObject * deferred = MGLContext_release_deferred(self, NULL);
+    if (!deferred) {
+        return NULL;
+    }
+    Py_DECREF(deferred);
+
+    // The queue and the memory tracking are freed with the context, objects collected later are only marked released
+    MGLMutex_Lock(self->lock);
     self->released = true;
+    for (int kind = 0; kind < MGL_RELEASE_KINDS; ++kind) {
+        PyMem_Free(self->release_queue.names[kind]);
+    }
+    PyObject * queued_objects = self->release_queue.objects;
+    PyObject * memory_objects = self->memory.objects;
+    memset(self->release_queue.names, 0, sizeof(self->release_queue.names));
+    memset(self->release_queue.count, 0, sizeof(self->release_queue.count));
+    memset(self->release_queue.capacity, 0, sizeof(self->release_queue.capacity));
+    self->release_queue.objects = NULL;
+    self->memory.objects = NULL;
+    MGLMutex_Unlock(self->lock);
+
+    Py_XDECREF(queued_objects);
+    Py_XDECREF(memory_objects);
+
+    MGLStagingRing & ring = self->staging;
+    if (ring.buffer_obj) {
+        for (int i = 0; i < MGL_STAGING_SLOTS; ++i) {
+            if (ring.fences[i]) {
+                self->gl.DeleteSync(ring.fences[i]);
+            }
+        }
+        self->gl.DeleteBuffers(1, (GLuint *)&ring.buffer_obj);
+        memset(&ring, 0, sizeof(ring));
+    }
+
+    if (self->chunk_copy.program_obj) {
+        self->gl.DeleteProgram(self->chunk_copy.program_obj);
+        memset(&self->chunk_copy, 0, sizeof(self->chunk_copy));
+    }
+
+    release_gl_trace(self);
 
     PyObject * temp = PyObject_CallMethod(self->ctx, "release", NULL);
     if (!temp) {
@@ -7991,14 +11578,25 @@ static PyObject * MGLContext_set_storage_block_binding(MGLContext * self, PyObje
     Py_RETURN_NONE;
 }
 
-static PyObject * MGLContext_read_uniform(MGLContext * self, PyObject * args) {
+static PyObject * MGLContext_read_uniform(MGLContext * self, PyObject * const * args, Py_ssize_t nargs) {
+    static const char * const keywords[] = {"program_obj", "location", "gl_type", "array_length", "element_size"};
+    PyObject * values[5];
     int program_obj;
     int location;
     int gl_type;
     int array_length;
     int element_size;
 
-    if (!PyArg_ParseTuple(args, "IIIII", &program_obj, &location, &gl_type, &array_length, &element_size)) {
+    int args_ok = (
+        fastcall_args("_read_uniform", args, nargs, NULL, keywords, 5, 5, values) &&
+        fastcall_int(values[0], 0, &program_obj) &&
+        fastcall_int(values[1], 0, &location) &&
+        fastcall_int(values[2], 0, &gl_type) &&
+        fastcall_int(values[3], 0, &array_length) &&
+        fastcall_int(values[4], 0, &element_size)
+    );
+
+    if (!args_ok) {
         return NULL;
     }
 
@@ -8078,7 +11676,10 @@ static PyObject * MGLContext_read_uniform(MGLContext * self, PyObject * args) {
     return res;
 }
 
-static PyObject * MGLContext_write_uniform(MGLContext * self, PyObject * args) {
+static PyObject * MGLContext_write_uniform(MGLContext * self, PyObject * const * args, Py_ssize_t nargs) {
+    MGLModuleState * state = module_state(self);
+    static const char * const keywords[] = {"program_obj", "location", "gl_type", "array_length", "element_size", "data"};
+    PyObject * values[6];
     int program_obj;
     int location;
     int gl_type;
@@ -8086,12 +11687,22 @@ static PyObject * MGLContext_write_uniform(MGLContext * self, PyObject * args) {
     int element_size;
     Py_buffer view = {};
 
-    if (!PyArg_ParseTuple(args, "IIIIIy*", &program_obj, &location, &gl_type, &array_length, &element_size, &view)) {
+    int args_ok = (
+        fastcall_args("_write_uniform", args, nargs, NULL, keywords, 6, 6, values) &&
+        fastcall_int(values[0], 0, &program_obj) &&
+        fastcall_int(values[1], 0, &location) &&
+        fastcall_int(values[2], 0, &gl_type) &&
+        fastcall_int(values[3], 0, &array_length) &&
+        fastcall_int(values[4], 0, &element_size)
+    );
+
+    if (!args_ok || PyObject_GetBuffer(values[5], &view, PyBUF_SIMPLE) < 0) {
         return NULL;
     }
 
     if ((int)view.len != array_length * element_size) {
         MGLError_Set("invalid uniform size");
+        PyBuffer_Release(&view);
         return NULL;
     }
 
@@ -8260,6 +11871,7 @@ static PyObject * MGLContext_get_blend_func(MGLContext * self, void * closure) {
 }
 
 static int MGLContext_set_blend_func(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int func[4] = {};
     if (!parse_blend_func(value, func)) {
         MGLError_Set("invalid blend func");
@@ -8313,6 +11925,7 @@ static PyObject * MGLContext_get_blend_equation(MGLContext * self, void * closur
 }
 
 static int MGLContext_set_blend_equation(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     int equation[2] = {};
     if (!parse_blend_equation(value, equation)) {
         MGLError_Set("invalid blend equation");
@@ -8456,24 +12069,24 @@ static int MGLContext_set_default_texture_unit(MGLContext * self, PyObject * val
 }
 
 static PyObject * MGLContext_get_max_samples(MGLContext * self, void * closure) {
-    return PyLong_FromLong(self->max_samples);
+    return PyLong_FromLong(self->limits.max_samples);
 }
 
 static PyObject * MGLContext_get_max_integer_samples(MGLContext * self, void * closure) {
-    return PyLong_FromLong(self->max_integer_samples);
+    return PyLong_FromLong(self->limits.max_integer_samples);
 }
 
 static PyObject * MGLContext_get_max_texture_units(MGLContext * self, void * closure) {
-    return PyLong_FromLong(self->max_texture_units);
+    return PyLong_FromLong(self->limits.max_texture_image_units);
 }
 
 static PyObject * MGLContext_get_max_anisotropy(MGLContext * self, void * closure) {
-    return PyFloat_FromDouble(self->max_anisotropy);
+    return PyFloat_FromDouble(self->limits.max_texture_max_anisotropy);
 }
 
 static PyObject * MGLContext_get_max_label_length(MGLContext * self, void * closure) {
-    if (self->max_label_length > 0) {
-        return PyLong_FromLong(self->max_label_length);
+    if (self->limits.max_label_length > 0) {
+        return PyLong_FromLong(self->limits.max_label_length);
     }
     else {
         Py_RETURN_NONE;
@@ -8481,8 +12094,8 @@ static PyObject * MGLContext_get_max_label_length(MGLContext * self, void * clos
 }
 
 static PyObject * MGLContext_get_max_debug_message_length(MGLContext * self, void * closure) {
-    if (self->max_debug_message_length > 0) {
-        return PyLong_FromLong(self->max_debug_message_length);
+    if (self->limits.max_debug_message_length > 0) {
+        return PyLong_FromLong(self->limits.max_debug_message_length);
     }
     else {
         Py_RETURN_NONE;
@@ -8491,8 +12104,8 @@ static PyObject * MGLContext_get_max_debug_message_length(MGLContext * self, voi
 
 
 static PyObject * MGLContext_get_max_debug_group_stack_depth(MGLContext * self, void * closure) {
-    if (self->max_debug_group_stack_depth > 0) {
-        return PyLong_FromLong(self->max_debug_group_stack_depth);
+    if (self->limits.max_debug_group_stack_depth > 0) {
+        return PyLong_FromLong(self->limits.max_debug_group_stack_depth);
     }
     else {
         Py_RETURN_NONE;
@@ -8500,17 +12113,15 @@ static PyObject * MGLContext_get_max_debug_group_stack_depth(MGLContext * self,
 }
 
 static MGLFramebuffer * MGLContext_get_fbo(MGLContext * self, void * closure) {
-    Py_INCREF(self->bound_framebuffer);
-    return self->bound_framebuffer;
+    return get_bound_framebuffer(self);
 }
 
 static int MGLContext_set_fbo(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (Py_TYPE(value) != MGLFramebuffer_type) {
         return -1;
     }
-    Py_INCREF(value);
-    Py_DECREF(self->bound_framebuffer);
-    self->bound_framebuffer = (MGLFramebuffer *)value;
+    set_bound_framebuffer(self, (MGLFramebuffer *)value);
     return 0;
 }
 
@@ -8519,6 +12130,7 @@ static PyObject * MGLContext_get_wireframe(MGLContext * self, void * closure) {
 }
 
 static int MGLContext_set_wireframe(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     if (value == Py_True) {
         self->gl.PolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         self->wireframe = true;
@@ -8544,6 +12156,7 @@ static PyObject * MGLContext_get_front_face(MGLContext * self, void * closure) {
 }
 
 static int MGLContext_set_front_face(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * str = PyUnicode_AsUTF8(value);
 
     if (!strcmp(str, "cw")) {
@@ -8576,6 +12189,7 @@ static PyObject * MGLContext_get_cull_face(MGLContext * self, void * closure) {
 }
 
 static int MGLContext_set_cull_face(MGLContext * self, PyObject * value, void * closure) {
+    MGLModuleState * state = module_state(self);
     const char * str = PyUnicode_AsUTF8(value);
 
     if (!strcmp(str, "front")) {
@@ -8709,6 +12323,141 @@ static void set_info_int_xyz(MGLContext * self, PyObject * info, const char * na
     set_key(info, name, Py_BuildValue("(iii)", value[0], value[1], value[2]));
 }
 
+// The limits without a version are queried on every context, like they were before the table existed
+#define MGL_LIMIT(kind, field, param, version) {#field, param, MGL_LIMIT_ ## kind, version, offsetof(MGLLimits, field)}
+
+struct MGLLimitInfo {
+    const char * name;
+    GLenum param;
+    int kind;
+    int version;
+    size_t offset;
+};
+
+static const MGLLimitInfo limit_infos[] = {
+    MGL_LIMIT(INT, max_texture_size, GL_MAX_TEXTURE_SIZE, 0),
+    MGL_LIMIT(INT, max_3d_texture_size, GL_MAX_3D_TEXTURE_SIZE, 0),
+    MGL_LIMIT(INT, max_cube_map_texture_size, GL_MAX_CUBE_MAP_TEXTURE_SIZE, 0),
+    MGL_LIMIT(INT, max_array_texture_layers, GL_MAX_ARRAY_TEXTURE_LAYERS, 0),
+    MGL_LIMIT(INT, max_rectangle_texture_size, GL_MAX_RECTANGLE_TEXTURE_SIZE, 0),
+    MGL_LIMIT(INT, max_texture_buffer_size, GL_MAX_TEXTURE_BUFFER_SIZE, 0),
+    MGL_LIMIT(INT, max_renderbuffer_size, GL_MAX_RENDERBUFFER_SIZE, 0),
+    MGL_LIMIT(FLOAT, max_texture_lod_bias, GL_MAX_TEXTURE_LOD_BIAS, 0),
+    MGL_LIMIT(FLOAT, max_texture_max_anisotropy, GL_MAX_TEXTURE_MAX_ANISOTROPY, 0),
+    MGL_LIMIT(INT, max_samples, GL_MAX_SAMPLES, 0),
+    MGL_LIMIT(INT, max_integer_samples, GL_MAX_INTEGER_SAMPLES, 0),
+    MGL_LIMIT(INT, max_color_texture_samples, GL_MAX_COLOR_TEXTURE_SAMPLES, 0),
+    MGL_LIMIT(INT, max_depth_texture_samples, GL_MAX_DEPTH_TEXTURE_SAMPLES, 0),
+    MGL_LIMIT(INT, max_color_attachments, GL_MAX_COLOR_ATTACHMENTS, 0),
+    MGL_LIMIT(INT, max_draw_buffers, GL_MAX_DRAW_BUFFERS, 0),
+    MGL_LIMIT(INT, max_dual_source_draw_buffers, GL_MAX_DUAL_SOURCE_DRAW_BUFFERS, 0),
+    MGL_LIMIT(INT2, max_viewport_dims, GL_MAX_VIEWPORT_DIMS, 0),
+    MGL_LIMIT(FLOAT2, point_size_range, GL_POINT_SIZE_RANGE, 0),
+    MGL_LIMIT(FLOAT2, aliased_line_width_range, GL_ALIASED_LINE_WIDTH_RANGE, 0),
+    MGL_LIMIT(INT, max_vertex_attribs, GL_MAX_VERTEX_ATTRIBS, 0),
+    MGL_LIMIT(INT, max_elements_vertices, GL_MAX_ELEMENTS_VERTICES, 0),
+    MGL_LIMIT(INT, max_elements_indices, GL_MAX_ELEMENTS_INDICES, 0),
+    MGL_LIMIT(INT, max_texture_image_units, GL_MAX_TEXTURE_IMAGE_UNITS, 0),
+    MGL_LIMIT(INT, max_vertex_texture_image_units, GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, 0),
+    MGL_LIMIT(INT, max_combined_texture_image_units, GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, 0),
+    MGL_LIMIT(INT, max_vertex_uniform_components, GL_MAX_VERTEX_UNIFORM_COMPONENTS, 0),
+    MGL_LIMIT(INT, max_fragment_uniform_components, GL_MAX_FRAGMENT_UNIFORM_COMPONENTS, 0),
+    MGL_LIMIT(INT, max_varying_components, GL_MAX_VARYING_COMPONENTS, 0),
+    MGL_LIMIT(INT, max_geometry_output_vertices, GL_MAX_GEOMETRY_OUTPUT_VERTICES, 0),
+    MGL_LIMIT(INT, max_clip_distances, GL_MAX_CLIP_DISTANCES, 0),
+    MGL_LIMIT(INT, max_uniform_buffer_bindings, GL_MAX_UNIFORM_BUFFER_BINDINGS, 0),
+    MGL_LIMIT(INT, max_uniform_block_size, GL_MAX_UNIFORM_BLOCK_SIZE, 0),
+    MGL_LIMIT(INT, uniform_buffer_offset_alignment, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, 0),
+    MGL_LIMIT(INT64, max_server_wait_timeout, GL_MAX_SERVER_WAIT_TIMEOUT, 0),
+    MGL_LIMIT(INT, max_label_length, GL_MAX_LABEL_LENGTH, 0),
+    MGL_LIMIT(INT, max_debug_message_length, GL_MAX_DEBUG_MESSAGE_LENGTH, 0),
+    MGL_LIMIT(INT, max_debug_group_stack_depth, GL_MAX_DEBUG_GROUP_STACK_DEPTH, 0),
+    MGL_LIMIT(INT, max_patch_vertices, GL_MAX_PATCH_VERTICES, 400),
+    MGL_LIMIT(INT, max_tess_gen_level, GL_MAX_TESS_GEN_LEVEL, 400),
+    MGL_LIMIT(INT, max_transform_feedback_buffers, GL_MAX_TRANSFORM_FEEDBACK_BUFFERS, 400),
+    MGL_LIMIT(INT, max_viewports, GL_MAX_VIEWPORTS, 410),
+    MGL_LIMIT(INT, min_map_buffer_alignment, GL_MIN_MAP_BUFFER_ALIGNMENT, 420),
+    MGL_LIMIT(INT, max_atomic_counter_buffer_bindings, GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS, 420),
+    MGL_LIMIT(INT, max_image_units, GL_MAX_IMAGE_UNITS, 420),
+    MGL_LIMIT(INT, max_shader_storage_buffer_bindings, GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, 430),
+    MGL_LIMIT(INT64, max_shader_storage_block_size, GL_MAX_SHADER_STORAGE_BLOCK_SIZE, 430),
+    MGL_LIMIT(INT, shader_storage_buffer_offset_alignment, GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, 430),
+    MGL_LIMIT(INT3, max_compute_work_group_count, GL_MAX_COMPUTE_WORK_GROUP_COUNT, 430),
+    MGL_LIMIT(INT3, max_compute_work_group_size, GL_MAX_COMPUTE_WORK_GROUP_SIZE, 430),
+    MGL_LIMIT(INT, max_compute_work_group_invocations, GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, 430),
+    MGL_LIMIT(INT, max_compute_shared_memory_size, GL_MAX_COMPUTE_SHARED_MEMORY_SIZE, 430),
+    MGL_LIMIT(INT, max_vertex_attrib_bindings, GL_MAX_VERTEX_ATTRIB_BINDINGS, 430),
+    MGL_LIMIT(INT, max_vertex_attrib_relative_offset, GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET, 430),
+    MGL_LIMIT(INT64, max_element_index, GL_MAX_ELEMENT_INDEX, 430),
+    MGL_LIMIT(INT, max_framebuffer_width, GL_MAX_FRAMEBUFFER_WIDTH, 430),
+    MGL_LIMIT(INT, max_framebuffer_height, GL_MAX_FRAMEBUFFER_HEIGHT, 430),
+    MGL_LIMIT(INT, max_framebuffer_layers, GL_MAX_FRAMEBUFFER_LAYERS, 430),
+    MGL_LIMIT(INT, max_framebuffer_samples, GL_MAX_FRAMEBUFFER_SAMPLES, 430),
+    MGL_LIMIT(INT, max_uniform_locations, GL_MAX_UNIFORM_LOCATIONS, 430),
+};
+
+#undef MGL_LIMIT
+
+static void load_limits(MGLContext * self) {
+    const GLMethods & gl = self->gl;
+    memset(&self->limits, 0, sizeof(self->limits));
+
+    for (const MGLLimitInfo & info : limit_infos) {
+        if (info.version > self->version_code) {
+            continue;
+        }
+
+        void * value = (char *)&self->limits + info.offset;
+
+        switch (info.kind) {
+            case MGL_LIMIT_INT:
+            case MGL_LIMIT_INT2:
+                gl.GetIntegerv(info.param, (GLint *)value);
+                break;
+
+            case MGL_LIMIT_INT64:
+                if (gl.GetInteger64v) {
+                    gl.GetInteger64v(info.param, (GLint64 *)value);
+                }
+                break;
+
+            case MGL_LIMIT_FLOAT:
+            case MGL_LIMIT_FLOAT2:
+                gl.GetFloatv(info.param, (GLfloat *)value);
+                break;
+
+            case MGL_LIMIT_INT3:
+                if (gl.GetIntegeri_v) {
+                    for (int i = 0; i < 3; ++i) {
+                        gl.GetIntegeri_v(info.param, i, (GLint *)value + i);
+                    }
+                }
+                break;
+        }
+    }
+}
+
+static PyObject * MGLContext_get_limits(MGLContext * self, void * closure) {
+    PyObject * res = PyDict_New();
+
+    for (const MGLLimitInfo & info : limit_infos) {
+        void * value = (char *)&self->limits + info.offset;
+        const int * i = (const int *)value;
+        const float * f = (const float *)value;
+
+        switch (info.kind) {
+            case MGL_LIMIT_INT: set_key(res, info.name, PyLong_FromLong(i[0])); break;
+            case MGL_LIMIT_INT64: set_key(res, info.name, PyLong_FromLongLong(*(const long long *)value)); break;
+            case MGL_LIMIT_FLOAT: set_key(res, info.name, PyFloat_FromDouble(f[0])); break;
+            case MGL_LIMIT_INT2: set_key(res, info.name, Py_BuildValue("(ii)", i[0], i[1])); break;
+            case MGL_LIMIT_INT3: set_key(res, info.name, Py_BuildValue("(iii)", i[0], i[1], i[2])); break;
+            case MGL_LIMIT_FLOAT2: set_key(res, info.name, Py_BuildValue("(ff)", f[0], f[1])); break;
+        }
+    }
+
+    return res;
+}
+
 static PyObject * MGLContext_get_info(MGLContext * self, void * closure) {
     PyObject * info = PyDict_New();
 
@@ -8886,6 +12635,7 @@ static PyObject * strsize(PyObject * self, PyObject * args) {
 }
 
 static PyObject * expected_size(PyObject * self, PyObject * args) {
+    MGLModuleState * state = (MGLModuleState *)PyModule_GetState(self);
     int width;
     int height;
     int depth;
@@ -8917,9 +12667,19 @@ static PyObject * writable_bytes(PyObject * self, PyObject * arg) {
 }
 
 static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kwargs) {
+    MGLModuleState * state = (MGLModuleState *)PyModule_GetState(self);
     PyObject * context = PyDict_GetItemString(kwargs, "context");
+    PyObject * backend_name = PyDict_GetItemString(kwargs, "backend");
+    bool known_backend = !context;
 
-    if (!context) {
+    // The null backend stubs every entry point and does not need glcontext
+    if (!context && backend_name && PyUnicode_Check(backend_name) && !PyUnicode_CompareWithASCIIString(backend_name, "null")) {
+        context = PyObject_CallMethod(state->helper, "NullLoader", NULL);
+
+        if (!context) {
+            return NULL;
+        }
+    } else if (!context) {
         PyObject * glcontext = PyImport_ImportModule("glcontext");
         if (!glcontext) {
             // Displayed to user: ModuleNotFoundError: No module named 'glcontext'
@@ -8927,7 +12687,6 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
         }
 
         PyObject * backend = NULL;
-        PyObject * backend_name = PyDict_GetItemString(kwargs, "backend");
 
         // Use the specified backend
         if (backend_name) {
@@ -8963,7 +12722,7 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
     ctx->wireframe = false;
     ctx->ctx = context;
 
-    ctx->gl = load_gl_methods(context);
+    ctx->gl = load_gl_methods(context, known_backend);
     if (PyErr_Occurred()) {
         return NULL;
     }
@@ -9000,30 +12759,8 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
         gl.Enable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
     }
 
-    ctx->max_samples = 0;
-    gl.GetIntegerv(GL_MAX_SAMPLES, (GLint *)&ctx->max_samples);
-
-    ctx->max_integer_samples = 0;
-    gl.GetIntegerv(GL_MAX_INTEGER_SAMPLES, (GLint *)&ctx->max_integer_samples);
-
-    ctx->max_color_attachments = 0;
-    gl.GetIntegerv(GL_MAX_COLOR_ATTACHMENTS, (GLint *)&ctx->max_color_attachments);
-
-    ctx->max_texture_units = 0;
-    gl.GetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, (GLint *)&ctx->max_texture_units);
-    ctx->default_texture_unit = ctx->max_texture_units - 1;
-
-    ctx->max_label_length = 0;
-    gl.GetIntegerv(GL_MAX_LABEL_LENGTH, (GLint *)&ctx->max_label_length);
-
-    ctx->max_debug_message_length = 0;
-    gl.GetIntegerv(GL_MAX_DEBUG_MESSAGE_LENGTH, (GLint *)&ctx->max_debug_message_length);
-
-    ctx->max_debug_group_stack_depth = 0;
-    gl.GetIntegerv(GL_MAX_DEBUG_GROUP_STACK_DEPTH, (GLint *)&ctx->max_debug_group_stack_depth);
-
-    ctx->max_anisotropy = 0.0;
-    gl.GetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, (GLfloat *)&ctx->max_anisotropy);
+    load_limits(ctx);
+    ctx->default_texture_unit = ctx->limits.max_texture_image_units - 1;
 
     int bound_framebuffer = 0;
     gl.GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound_framebuffer);
@@ -9046,6 +12783,11 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
         MGLFramebuffer * framebuffer = PyObject_New(MGLFramebuffer, MGLFramebuffer_type);
         framebuffer->released = false;
 
+        framebuffer->resolve_framebuffer_obj = 0;
+        framebuffer->resolve_textures = NULL;
+        framebuffer->resolve_depth_texture = NULL;
+        framebuffer->resolve_draw_buffers = NULL;
+
         framebuffer->framebuffer_obj = 0;
         framebuffer->draw_buffers_len = 1;
 
@@ -9109,6 +12851,15 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
     ctx->polygon_offset_factor = 0.0f;
     ctx->polygon_offset_units = 0.0f;
 
+    memset(&ctx->staging, 0, sizeof(ctx->staging));
+    memset(&ctx->chunk_copy, 0, sizeof(ctx->chunk_copy));
+    memset(&ctx->memory, 0, sizeof(ctx->memory));
+    ctx->memory.objects = PyDict_New();
+    memset(&ctx->release_queue, 0, sizeof(ctx->release_queue));
+    ctx->release_queue.objects = PyList_New(0);
+    ctx->trace = NULL;
+    ctx->lock = MGLMutex();
+
     gl.GetError(); // clear errors
 
     if (PyErr_Occurred()) {
@@ -9119,7 +12870,20 @@ static PyObject * create_context(PyObject * self, PyObject * args, PyObject * kw
 }
 
 static void default_dealloc(PyObject * self) {
-    Py_TYPE(self)->tp_free(self);
+    // Instances of heap types hold a reference to their type
+    PyTypeObject * type = Py_TYPE(self);
+    type->tp_free(self);
+    #if PY_VERSION_HEX >= 0x03080000
+    Py_DECREF(type);
+    #endif
+}
+
+static PyObject * null_gl_function(PyObject * self, PyObject * arg) {
+    const char * name = PyUnicode_AsUTF8(arg);
+    if (!name) {
+        return NULL;
+    }
+    return PyLong_FromVoidPtr(null_gl_function(name));
 }
 
 static PyMethodDef MGL_module_methods[] = {
@@ -9127,6 +12891,7 @@ static PyMethodDef MGL_module_methods[] = {
     {(char *)"create_context", (PyCFunction)create_context, METH_VARARGS | METH_KEYWORDS},
     {(char *)"writable_bytes", (PyCFunction)writable_bytes, METH_O},
     {(char *)"expected_size", (PyCFunction)expected_size, METH_VARARGS},
+    {(char *)"null_gl_function", (PyCFunction)null_gl_function, METH_O},
     {},
 };
 
@@ -9135,18 +12900,23 @@ static PyGetSetDef MGLBuffer_getset[] = {
 };
 
 static PyMethodDef MGLBuffer_methods[] = {
-    {(char *)"write", (PyCFunction)MGLBuffer_write, METH_VARARGS},
-    {(char *)"read", (PyCFunction)MGLBuffer_read, METH_VARARGS},
+    {(char *)"write", (PyCFunction)(void(*)(void))MGLBuffer_write, METH_FASTCALL | METH_KEYWORDS},
+    {(char *)"write_from_file", (PyCFunction)MGLBuffer_write_from_file, METH_VARARGS},
+    {(char *)"commit", (PyCFunction)MGLBuffer_commit, METH_VARARGS},
+    {(char *)"read", (PyCFunction)(void(*)(void))MGLBuffer_read, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"read_into", (PyCFunction)MGLBuffer_read_into, METH_VARARGS},
     {(char *)"write_chunks", (PyCFunction)MGLBuffer_write_chunks, METH_VARARGS},
     {(char *)"read_chunks", (PyCFunction)MGLBuffer_read_chunks, METH_VARARGS},
     {(char *)"read_chunks_into", (PyCFunction)MGLBuffer_read_chunks_into, METH_VARARGS},
+    {(char *)"scatter", (PyCFunction)MGLBuffer_scatter, METH_VARARGS},
+    {(char *)"gather", (PyCFunction)MGLBuffer_gather, METH_VARARGS},
     {(char *)"clear", (PyCFunction)MGLBuffer_clear, METH_VARARGS},
     {(char *)"orphan", (PyCFunction)MGLBuffer_orphan, METH_VARARGS},
     {(char *)"bind_to_uniform_block", (PyCFunction)MGLBuffer_bind_to_uniform_block, METH_VARARGS},
     {(char *)"bind_to_storage_buffer", (PyCFunction)MGLBuffer_bind_to_storage_buffer, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLBuffer_release, METH_NOARGS},
     {(char *)"size", (PyCFunction)MGLBuffer_size, METH_NOARGS},
+    {(char *)"view", (PyCFunction)MGLBuffer_view, METH_VARARGS},
     {},
 };
 
@@ -9158,14 +12928,18 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"disable_direct", (PyCFunction)MGLContext_disable_direct, METH_VARARGS},
     {(char *)"finish", (PyCFunction)MGLContext_finish, METH_NOARGS},
     {(char *)"copy_buffer", (PyCFunction)MGLContext_copy_buffer, METH_VARARGS},
+    {(char *)"copy_buffers", (PyCFunction)MGLContext_copy_buffers, METH_VARARGS},
     {(char *)"copy_framebuffer", (PyCFunction)MGLContext_copy_framebuffer, METH_VARARGS},
     {(char *)"detect_framebuffer", (PyCFunction)MGLContext_detect_framebuffer, METH_VARARGS},
     {(char *)"clear_samplers", (PyCFunction)MGLContext_clear_samplers, METH_VARARGS},
 
     {(char *)"buffer", (PyCFunction)MGLContext_buffer, METH_VARARGS},
+    {(char *)"sparse_buffer", (PyCFunction)MGLContext_sparse_buffer, METH_VARARGS},
     {(char *)"external_buffer", (PyCFunction)MGLContext_external_buffer, METH_VARARGS},
     {(char *)"texture", (PyCFunction)MGLContext_texture, METH_VARARGS},
     {(char *)"texture3d", (PyCFunction)MGLContext_texture3d, METH_VARARGS},
+    {(char *)"sparse_texture", (PyCFunction)MGLContext_sparse_texture, METH_VARARGS},
+    {(char *)"sparse_texture3d", (PyCFunction)MGLContext_sparse_texture3d, METH_VARARGS},
     {(char *)"texture_array", (PyCFunction)MGLContext_texture_array, METH_VARARGS},
     {(char *)"texture_cube", (PyCFunction)MGLContext_texture_cube, METH_VARARGS},
     {(char *)"depth_texture", (PyCFunction)MGLContext_depth_texture, METH_VARARGS},
@@ -9176,6 +12950,11 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"framebuffer", (PyCFunction)MGLContext_framebuffer, METH_VARARGS},
     {(char *)"empty_framebuffer", (PyCFunction)MGLContext_empty_framebuffer, METH_VARARGS},
     {(char *)"query", (PyCFunction)MGLContext_query, METH_VARARGS},
+    {(char *)"occlusion_culler", (PyCFunction)MGLContext_occlusion_culler, METH_VARARGS},
+    {(char *)"timestamp_queries", (PyCFunction)MGLContext_timestamp_queries, METH_VARARGS},
+    {(char *)"delete_queries", (PyCFunction)MGLContext_delete_queries, METH_VARARGS},
+    {(char *)"query_counter", (PyCFunction)MGLContext_query_counter, METH_VARARGS},
+    {(char *)"query_timestamps", (PyCFunction)MGLContext_query_timestamps, METH_VARARGS},
     {(char *)"scope", (PyCFunction)MGLContext_scope, METH_VARARGS},
     {(char *)"sampler", (PyCFunction)MGLContext_sampler, METH_VARARGS},
     {(char *)"memory_barrier", (PyCFunction)MGLContext_memory_barrier, METH_VARARGS},
@@ -9183,6 +12962,20 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"set_label", (PyCFunction)MGLContext_set_label, METH_VARARGS},
     {(char *)"push_debug_scope", (PyCFunction)MGLContext_push_debug_scope, METH_VARARGS},
     {(char *)"pop_debug_scope", (PyCFunction)MGLContext_pop_debug_scope, METH_NOARGS},
+    {(char *)"enable_gl_stats", (PyCFunction)MGLContext_enable_gl_stats, METH_VARARGS},
+    {(char *)"disable_gl_stats", (PyCFunction)MGLContext_disable_gl_stats, METH_NOARGS},
+    {(char *)"reset_gl_stats", (PyCFunction)MGLContext_reset_gl_stats, METH_NOARGS},
+    {(char *)"gl_stats", (PyCFunction)MGLContext_gl_stats, METH_NOARGS},
+    {(char *)"gl_trace", (PyCFunction)MGLContext_gl_trace, METH_NOARGS},
+    {(char *)"memory_stats", (PyCFunction)MGLContext_memory_stats, METH_VARARGS},
+    {(char *)"defer_release", (PyCFunction)MGLContext_defer_release, METH_O},
+    {(char *)"fence", (PyCFunction)MGLContext_fence, METH_NOARGS},
+    {(char *)"adopt", (PyCFunction)MGLContext_adopt, METH_O},
+    {(char *)"wait_fence", (PyCFunction)MGLContext_wait_fence, METH_VARARGS},
+    {(char *)"release_deferred", (PyCFunction)MGLContext_release_deferred, METH_NOARGS},
+    {(char *)"begin_capture", (PyCFunction)MGLContext_begin_capture, METH_VARARGS},
+    {(char *)"end_capture", (PyCFunction)MGLContext_end_capture, METH_NOARGS},
+    {(char *)"replay", (PyCFunction)MGLContext_replay, METH_VARARGS},
 
     {(char *)"__enter__", (PyCFunction)MGLContext_enter, METH_NOARGS},
     {(char *)"__exit__", (PyCFunction)MGLContext_exit, METH_VARARGS},
@@ -9193,8 +12986,8 @@ static PyMethodDef MGLContext_methods[] = {
     {(char *)"_set_ubo_binding", (PyCFunction)MGLContext_set_ubo_binding, METH_VARARGS},
     {(char *)"_get_storage_block_binding", (PyCFunction)MGLContext_get_storage_block_binding, METH_VARARGS},
     {(char *)"_set_storage_block_binding", (PyCFunction)MGLContext_set_storage_block_binding, METH_VARARGS},
-    {(char *)"_write_uniform", (PyCFunction)MGLContext_write_uniform, METH_VARARGS},
-    {(char *)"_read_uniform", (PyCFunction)MGLContext_read_uniform, METH_VARARGS},
+    {(char *)"_write_uniform", (PyCFunction)MGLContext_write_uniform, METH_FASTCALL},
+    {(char *)"_read_uniform", (PyCFunction)MGLContext_read_uniform, METH_FASTCALL},
     {(char *)"_set_uniform_handle", (PyCFunction)MGLContext_set_uniform_handle, METH_VARARGS},
     {},
 };
@@ -9213,6 +13006,7 @@ static PyGetSetDef MGLContext_getset[] = {
     {(char *)"polygon_offset", (getter)MGLContext_get_polygon_offset, (setter)MGLContext_set_polygon_offset},
 
     {(char *)"default_texture_unit", (getter)MGLContext_get_default_texture_unit, (setter)MGLContext_set_default_texture_unit},
+    {(char *)"limits", (getter)MGLContext_get_limits, NULL},
     {(char *)"max_samples", (getter)MGLContext_get_max_samples, NULL},
     {(char *)"max_integer_samples", (getter)MGLContext_get_max_integer_samples, NULL},
     {(char *)"max_texture_units", (getter)MGLContext_get_max_texture_units, NULL},
@@ -9252,6 +13046,7 @@ static PyMethodDef MGLFramebuffer_methods[] = {
     {(char *)"clear", (PyCFunction)MGLFramebuffer_clear, METH_VARARGS},
     {(char *)"use", (PyCFunction)MGLFramebuffer_use, METH_NOARGS},
     {(char *)"read_into", (PyCFunction)MGLFramebuffer_read_into, METH_VARARGS},
+    {(char *)"resolve", (PyCFunction)MGLFramebuffer_resolve, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLFramebuffer_release, METH_NOARGS},
     {},
 };
@@ -9261,7 +13056,7 @@ static PyGetSetDef MGLProgram_getset[] = {
 };
 
 static PyMethodDef MGLProgram_methods[] = {
-    {(char *)"run", (PyCFunction)MGLProgram_run, METH_VARARGS},
+    {(char *)"run", (PyCFunction)(void(*)(void))MGLProgram_run, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"run_indirect", (PyCFunction)MGLProgram_run_indirect, METH_VARARGS},
     {(char *)"draw_mesh_tasks", (PyCFunction)MGLProgram_draw_mesh_tasks, METH_VARARGS},
     {(char *)"draw_mesh_tasks_indirect", (PyCFunction)MGLProgram_draw_mesh_tasks_indirect, METH_VARARGS},
@@ -9274,6 +13069,8 @@ static PyGetSetDef MGLQuery_getset[] = {
     {(char *)"samples", (getter)MGLQuery_get_samples, NULL},
     {(char *)"primitives", (getter)MGLQuery_get_primitives, NULL},
     {(char *)"elapsed", (getter)MGLQuery_get_elapsed, NULL},
+    {(char *)"available", (getter)MGLQuery_get_available, NULL},
+    {(char *)"statistics", (getter)MGLQuery_get_statistics, NULL},
     {},
 };
 
@@ -9282,10 +13079,22 @@ static PyMethodDef MGLQuery_methods[] = {
     {(char *)"end", (PyCFunction)MGLQuery_end, METH_NOARGS},
     {(char *)"begin_render", (PyCFunction)MGLQuery_begin_render, METH_NOARGS},
     {(char *)"end_render", (PyCFunction)MGLQuery_end_render, METH_NOARGS},
+    {(char *)"try_get", (PyCFunction)MGLQuery_try_get, METH_NOARGS},
+    {(char *)"write_to", (PyCFunction)MGLQuery_write_to, METH_VARARGS},
     // {(char *)"release", (PyCFunction)MGLQuery_release, METH_NOARGS},
     {},
 };
 
+static PyMethodDef MGLOcclusionCuller_methods[] = {
+    {(char *)"test", (PyCFunction)MGLOcclusionCuller_test, METH_VARARGS},
+    {(char *)"collect", (PyCFunction)MGLOcclusionCuller_collect, METH_NOARGS},
+    {(char *)"is_visible", (PyCFunction)MGLOcclusionCuller_is_visible, METH_VARARGS},
+    {(char *)"begin_render", (PyCFunction)MGLOcclusionCuller_begin_render, METH_VARARGS},
+    {(char *)"end_render", (PyCFunction)MGLOcclusionCuller_end_render, METH_NOARGS},
+    {(char *)"release", (PyCFunction)MGLOcclusionCuller_release, METH_NOARGS},
+    {},
+};
+
 static PyGetSetDef MGLRenderbuffer_getset[] = {
     {},
 };
@@ -9309,7 +13118,7 @@ static PyGetSetDef MGLSampler_getset[] = {
 };
 
 static PyMethodDef MGLSampler_methods[] = {
-    {(char *)"use", (PyCFunction)MGLSampler_use, METH_VARARGS},
+    {(char *)"use", (PyCFunction)(void(*)(void))MGLSampler_use, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"clear", (PyCFunction)MGLSampler_clear, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLSampler_release, METH_NOARGS},
     {},
@@ -9334,8 +13143,10 @@ static PyGetSetDef MGLTexture_getset[] = {
 
 static PyMethodDef MGLTexture_methods[] = {
     {(char *)"write", (PyCFunction)MGLTexture_write, METH_VARARGS},
+    {(char *)"write_from_file", (PyCFunction)MGLTexture_write_from_file, METH_VARARGS},
+    {(char *)"commit", (PyCFunction)MGLTexture_commit, METH_VARARGS},
     {(char *)"bind", (PyCFunction)MGLTexture_meth_bind, METH_VARARGS},
-    {(char *)"use", (PyCFunction)MGLTexture_use, METH_VARARGS},
+    {(char *)"use", (PyCFunction)(void(*)(void))MGLTexture_use, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"build_mipmaps", (PyCFunction)MGLTexture_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTexture_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTexture_read_into, METH_VARARGS},
@@ -9356,11 +13167,12 @@ static PyGetSetDef MGLTexture3D_getset[] = {
 static PyMethodDef MGLTexture3D_methods[] = {
     {(char *)"write", (PyCFunction)MGLTexture3D_write, METH_VARARGS},
     {(char *)"bind", (PyCFunction)MGLTexture3D_meth_bind, METH_VARARGS},
-    {(char *)"use", (PyCFunction)MGLTexture3D_use, METH_VARARGS},
+    {(char *)"use", (PyCFunction)(void(*)(void))MGLTexture3D_use, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"build_mipmaps", (PyCFunction)MGLTexture3D_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTexture3D_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTexture3D_read_into, METH_VARARGS},
     {(char *)"get_handle", (PyCFunction)MGLTexture3D_get_handle, METH_VARARGS},
+    {(char *)"commit", (PyCFunction)MGLTexture3D_commit, METH_VARARGS},
     {(char *)"release", (PyCFunction)MGLTexture3D_release, METH_NOARGS},
     {},
 };
@@ -9377,7 +13189,7 @@ static PyGetSetDef MGLTextureArray_getset[] = {
 static PyMethodDef MGLTextureArray_methods[] = {
     {(char *)"write", (PyCFunction)MGLTextureArray_write, METH_VARARGS},
     {(char *)"bind", (PyCFunction)MGLTextureArray_meth_bind, METH_VARARGS},
-    {(char *)"use", (PyCFunction)MGLTextureArray_use, METH_VARARGS},
+    {(char *)"use", (PyCFunction)(void(*)(void))MGLTextureArray_use, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"build_mipmaps", (PyCFunction)MGLTextureArray_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTextureArray_read, METH_VARARGS},
     {(char *)"read_into", (PyCFunction)MGLTextureArray_read_into, METH_VARARGS},
@@ -9396,7 +13208,7 @@ static PyGetSetDef MGLTextureCube_getset[] = {
 
 static PyMethodDef MGLTextureCube_methods[] = {
     {(char *)"write", (PyCFunction)MGLTextureCube_write, METH_VARARGS},
-    {(char *)"use", (PyCFunction)MGLTextureCube_use, METH_VARARGS},
+    {(char *)"use", (PyCFunction)(void(*)(void))MGLTextureCube_use, METH_FASTCALL | METH_KEYWORDS},
     {(char *)"bind", (PyCFunction)MGLTextureCube_meth_bind, METH_VARARGS},
     {(char *)"build_mipmaps", (PyCFunction)MGLTextureCube_build_mipmaps, METH_VARARGS},
     {(char *)"read", (PyCFunction)MGLTextureCube_read, METH_VARARGS},
@@ -9407,7 +13219,7 @@ static PyMethodDef MGLTextureCube_methods[] = {
 };
 
 static PyMethodDef MGLVertexArray_methods[] = {
-    {(char *)"render", (PyCFunction)MGLVertexArray_render, METH_VARARGS},
+    {(char *)"render", (PyCFunction)MGLVertexArray_render, METH_FASTCALL},
     {(char *)"render_indirect", (PyCFunction)MGLVertexArray_render_indirect, METH_VARARGS},
     {(char *)"transform", (PyCFunction)MGLVertexArray_transform, METH_VARARGS},
     {(char *)"bind", (PyCFunction)MGLVertexArray_bind, METH_VARARGS},
@@ -9433,6 +13245,15 @@ static PyType_Slot MGLBuffer_slots[] = {
     {},
 };
 
+static PyType_Slot MGLBufferView_slots[] = {
+    #if PY_VERSION_HEX >= 0x03090000
+    {Py_bf_getbuffer, (void *)MGLBufferView_tp_as_buffer_get_view},
+    {Py_bf_releasebuffer, (void *)MGLBufferView_tp_as_buffer_release_view},
+    #endif
+    {Py_tp_dealloc, (void *)MGLBufferView_dealloc},
+    {},
+};
+
 static PyType_Slot MGLContext_slots[] = {
     {Py_tp_methods, MGLContext_methods},
     {Py_tp_getset, MGLContext_getset},
@@ -9461,6 +13282,12 @@ static PyType_Slot MGLQuery_slots[] = {
     {},
 };
 
+static PyType_Slot MGLOcclusionCuller_slots[] = {
+    {Py_tp_methods, MGLOcclusionCuller_methods},
+    {Py_tp_dealloc, (void *)default_dealloc},
+    {},
+};
+
 static PyType_Slot MGLRenderbuffer_slots[] = {
     {Py_tp_methods, MGLRenderbuffer_methods},
     {Py_tp_getset, MGLRenderbuffer_getset},
@@ -9517,10 +13344,12 @@ static PyType_Slot MGLSampler_slots[] = {
 };
 
 static PyType_Spec MGLBuffer_spec = {"mgl.Buffer", sizeof(MGLBuffer), 0, Py_TPFLAGS_DEFAULT, MGLBuffer_slots};
+static PyType_Spec MGLBufferView_spec = {"mgl.BufferView", sizeof(MGLBufferView), 0, Py_TPFLAGS_DEFAULT, MGLBufferView_slots};
 static PyType_Spec MGLContext_spec = {"mgl.Context", sizeof(MGLContext), 0, Py_TPFLAGS_DEFAULT, MGLContext_slots};
 static PyType_Spec MGLFramebuffer_spec = {"mgl.Framebuffer", sizeof(MGLFramebuffer), 0, Py_TPFLAGS_DEFAULT, MGLFramebuffer_slots};
 static PyType_Spec MGLProgram_spec = {"mgl.Program", sizeof(MGLProgram), 0, Py_TPFLAGS_DEFAULT, MGLProgram_slots};
 static PyType_Spec MGLQuery_spec = {"mgl.Query", sizeof(MGLQuery), 0, Py_TPFLAGS_DEFAULT, MGLQuery_slots};
+static PyType_Spec MGLOcclusionCuller_spec = {"mgl.OcclusionCuller", sizeof(MGLOcclusionCuller), 0, Py_TPFLAGS_DEFAULT, MGLOcclusionCuller_slots};
 static PyType_Spec MGLRenderbuffer_spec = {"mgl.Renderbuffer", sizeof(MGLRenderbuffer), 0, Py_TPFLAGS_DEFAULT, MGLRenderbuffer_slots};
 static PyType_Spec MGLScope_spec = {"mgl.Scope", sizeof(MGLScope), 0, Py_TPFLAGS_DEFAULT, MGLScope_slots};
 static PyType_Spec MGLTexture_spec = {"mgl.Texture", sizeof(MGLTexture), 0, Py_TPFLAGS_DEFAULT, MGLTexture_slots};
@@ -9530,45 +13359,132 @@ static PyType_Spec MGLTexture3D_spec = {"mgl.Texture3D", sizeof(MGLTexture3D), 0
 static PyType_Spec MGLVertexArray_spec = {"mgl.VertexArray", sizeof(MGLVertexArray), 0, Py_TPFLAGS_DEFAULT, MGLVertexArray_slots};
 static PyType_Spec MGLSampler_spec = {"mgl.Sampler", sizeof(MGLSampler), 0, Py_TPFLAGS_DEFAULT, MGLSampler_slots};
 
-static PyModuleDef MGL_moduledef = {
-    PyModuleDef_HEAD_INIT,
-    "mgl",
-    0,
-    -1,
-    MGL_module_methods,
-    0,
-    0,
-    0,
-    0,
-};
+static PyTypeObject * module_type(PyObject * module, PyType_Spec * spec) {
+    #if PY_VERSION_HEX >= 0x03090000
+    return (PyTypeObject *)PyType_FromModuleAndSpec(module, spec, NULL);
+    #else
+    return (PyTypeObject *)PyType_FromSpec(spec);
+    #endif
+}
 
-extern "C" PyObject * PyInit_mgl() {
-    PyObject * module = PyModule_Create(&MGL_moduledef);
+static int MGL_module_exec(PyObject * module) {
+    MGLModuleState * state = (MGLModuleState *)PyModule_GetState(module);
 
-    helper = PyImport_ImportModule("_moderngl");
-    if (!helper) {
-        return NULL;
+    state->helper = PyImport_ImportModule("_moderngl");
+    if (!state->helper) {
+        return -1;
     }
 
-    moderngl_error = PyObject_GetAttrString(helper, "Error");
+    state->error = PyObject_GetAttrString(state->helper, "Error");
+    if (!state->error) {
+        return -1;
+    }
 
-    MGLBuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLBuffer_spec);
-    MGLContext_type = (PyTypeObject *)PyType_FromSpec(&MGLContext_spec);
-    MGLFramebuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLFramebuffer_spec);
-    MGLProgram_type = (PyTypeObject *)PyType_FromSpec(&MGLProgram_spec);
-    MGLQuery_type = (PyTypeObject *)PyType_FromSpec(&MGLQuery_spec);
-    MGLRenderbuffer_type = (PyTypeObject *)PyType_FromSpec(&MGLRenderbuffer_spec);
-    MGLScope_type = (PyTypeObject *)PyType_FromSpec(&MGLScope_spec);
-    MGLTexture_type = (PyTypeObject *)PyType_FromSpec(&MGLTexture_spec);
-    MGLTextureArray_type = (PyTypeObject *)PyType_FromSpec(&MGLTextureArray_spec);
-    MGLTextureCube_type = (PyTypeObject *)PyType_FromSpec(&MGLTextureCube_spec);
-    MGLTexture3D_type = (PyTypeObject *)PyType_FromSpec(&MGLTexture3D_spec);
-    MGLVertexArray_type = (PyTypeObject *)PyType_FromSpec(&MGLVertexArray_spec);
-    MGLSampler_type = (PyTypeObject *)PyType_FromSpec(&MGLSampler_spec);
+    state->mglo_str = PyUnicode_InternFromString("mglo");
+    if (!state->mglo_str) {
+        return -1;
+    }
 
-    PyObject * InvalidObject = PyObject_GetAttrString(helper, "InvalidObject");
+    state->buffer_type = module_type(module, &MGLBuffer_spec);
+    state->buffer_view_type = module_type(module, &MGLBufferView_spec);
+    state->context_type = module_type(module, &MGLContext_spec);
+    state->framebuffer_type = module_type(module, &MGLFramebuffer_spec);
+    state->program_type = module_type(module, &MGLProgram_spec);
+    state->query_type = module_type(module, &MGLQuery_spec);
+    state->occlusion_culler_type = module_type(module, &MGLOcclusionCuller_spec);
+    state->renderbuffer_type = module_type(module, &MGLRenderbuffer_spec);
+    state->scope_type = module_type(module, &MGLScope_spec);
+    state->texture_type = module_type(module, &MGLTexture_spec);
+    state->texture_array_type = module_type(module, &MGLTextureArray_spec);
+    state->texture_cube_type = module_type(module, &MGLTextureCube_spec);
+    state->texture3d_type = module_type(module, &MGLTexture3D_spec);
+    state->vertex_array_type = module_type(module, &MGLVertexArray_spec);
+    state->sampler_type = module_type(module, &MGLSampler_spec);
+
+    PyObject * InvalidObject = PyObject_GetAttrString(state->helper, "InvalidObject");
     PyModule_AddObject(module, "InvalidObject", InvalidObject);
     Py_INCREF(InvalidObject);
 
-    return module;
+    #if PY_VERSION_HEX < 0x03090000
+    module_state_single = state;
+    #endif
+
+    return 0;
+}
+
+static int MGL_module_traverse(PyObject * module, visitproc visit, void * arg) {
+    MGLModuleState * state = (MGLModuleState *)PyModule_GetState(module);
+    Py_VISIT(state->helper);
+    Py_VISIT(state->error);
+    Py_VISIT(state->buffer_type);
+    Py_VISIT(state->buffer_view_type);
+    Py_VISIT(state->context_type);
+    Py_VISIT(state->framebuffer_type);
+    Py_VISIT(state->program_type);
+    Py_VISIT(state->query_type);
+    Py_VISIT(state->occlusion_culler_type);
+    Py_VISIT(state->renderbuffer_type);
+    Py_VISIT(state->scope_type);
+    Py_VISIT(state->texture_type);
+    Py_VISIT(state->texture_array_type);
+    Py_VISIT(state->texture_cube_type);
+    Py_VISIT(state->texture3d_type);
+    Py_VISIT(state->vertex_array_type);
+    Py_VISIT(state->sampler_type);
+    return 0;
+}
+
+static int MGL_module_clear(PyObject * module) {
+    MGLModuleState * state = (MGLModuleState *)PyModule_GetState(module);
+    Py_CLEAR(state->helper);
+    Py_CLEAR(state->error);
+    Py_CLEAR(state->mglo_str);
+    Py_CLEAR(state->buffer_type);
+    Py_CLEAR(state->buffer_view_type);
+    Py_CLEAR(state->context_type);
+    Py_CLEAR(state->framebuffer_type);
+    Py_CLEAR(state->program_type);
+    Py_CLEAR(state->query_type);
+    Py_CLEAR(state->occlusion_culler_type);
+    Py_CLEAR(state->renderbuffer_type);
+    Py_CLEAR(state->scope_type);
+    Py_CLEAR(state->texture_type);
+    Py_CLEAR(state->texture_array_type);
+    Py_CLEAR(state->texture_cube_type);
+    Py_CLEAR(state->texture3d_type);
+    Py_CLEAR(state->vertex_array_type);
+    Py_CLEAR(state->sampler_type);
+    return 0;
+}
+
+static void MGL_module_free(void * module) {
+    MGL_module_clear((PyObject *)module);
+}
+
+static PyModuleDef_Slot MGL_module_slots[] = {
+    {Py_mod_exec, (void *)MGL_module_exec},
+    #if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+    #endif
+    #if PY_VERSION_HEX >= 0x030D0000
+    // The contexts guard the state shared between threads
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+    #endif
+    {},
+};
+
+static PyModuleDef MGL_moduledef = {
+    PyModuleDef_HEAD_INIT,
+    "mgl",
+    0,
+    sizeof(MGLModuleState),
+    MGL_module_methods,
+    MGL_module_slots,
+    MGL_module_traverse,
+    MGL_module_clear,
+    MGL_module_free,
+};
+
+extern "C" PyObject * PyInit_mgl() {
+    return PyModuleDef_Init(&MGL_moduledef);
 }
@@ -0,0 +1,47 @@
+import json
+import os
+import runpy
+
+import moderngl
+
+bench = runpy.run_path(os.path.join(os.path.dirname(__file__), "..", "benchmarks", "bench.py"))
+
+
+def test_benchmarks_null_backend(tmp_path):
+    output = str(tmp_path / "null.json")
+    argv = ["--backend", "null", "--budget", "0.001", "--repeat", "1", "--max-size", "1024", "-o", output]
+    assert bench["main"](argv) == 0
+
+    with open(output) as f:
+        res = json.load(f)
+
+    assert res["meta"]["backend"] == "null"
+    assert "buffer.write[64B]" in res["results"]
+    assert "scope.enter_exit" in res["results"]
+    assert "uniform.set[mat4]" in res["results"]
+    assert "vertex_array.render" in res["results"]
+    assert res["results"]["buffer.read[1KB]"]["min_ns"] > 0.0
+
+
+def test_benchmarks_filter_before_setup():
+    # The filtered out benchmarks allocate nothing
+    args = bench["parse_args"](["--budget", "0.001", "--repeat", "1", "-k", "context.program"])
+    ctx = moderngl.create_context(standalone=True, backend="null")
+    res = bench["run"](ctx, args)
+    stats = ctx.memory_stats()
+    ctx.release()
+
+    assert list(res["results"]) == ["context.program"]
+    assert stats["buffer"]["peak"] == 0
+    assert stats["texture"]["peak"] == 0
+
+
+def test_benchmarks_compare(tmp_path, capsys):
+    base, new = str(tmp_path / "base.json"), str(tmp_path / "new.json")
+    for path, ns in ((base, 100.0), (new, 150.0)):
+        with open(path, "w") as f:
+            json.dump({"meta": {}, "results": {"buffer.write[64B]": {"min_ns": ns}}}, f)
+
+    assert bench["main"](["--compare", base, new]) == 0
+    assert bench["main"](["--compare", base, new, "--threshold", "1.2"]) == 1
+    assert "REGRESSED" in capsys.readouterr().out
@@ -0,0 +1,149 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+def test_allocate_and_free(ctx):
+    arena = ctx.buffer_arena(1024, alignment=64)
+    a = arena.allocate(10)
+    b = arena.allocate(100)
+    c = arena.allocate(64)
+    assert (a.offset, b.offset, c.offset) == (0, 64, 192)
+    assert arena.used == 174
+
+    b.release()
+    assert b.arena is None
+    assert arena.allocate(128).offset == 64
+
+    a.release()
+    c.release()
+    assert arena.largest_free_block == 1024 - 192
+    arena.release()
+
+
+def test_out_of_memory(ctx):
+    arena = ctx.buffer_arena(256, alignment=16)
+    arena.allocate(200)
+    with pytest.raises(moderngl.Error):
+        arena.allocate(100)
+    arena.release()
+
+
+def test_write_read(ctx):
+    arena = ctx.buffer_arena(256, alignment=16)
+    a = arena.allocate(8)
+    b = arena.allocate(8)
+    a.write(b'aaaaaaaa')
+    b.write(b'bbbb', offset=4)
+    assert a.read() == b'aaaaaaaa'
+    assert b.read(4, offset=4) == b'bbbb'
+    with pytest.raises(moderngl.Error):
+        a.write(b'123456789')
+    arena.release()
+
+
+def test_defragment(ctx):
+    arena = ctx.buffer_arena(256, alignment=16)
+    slices = [arena.allocate(20) for _ in range(6)]
+    for i, x in enumerate(slices):
+        x.write(bytes([i]) * 20)
+
+    slices[0].release()
+    slices[2].release()
+    assert arena.defragment() == 4
+    live = [slices[1], slices[3], slices[4], slices[5]]
+    assert [x.offset for x in live] == [0, 32, 64, 96]
+    assert [x.read() for x in live] == [bytes([i]) * 20 for i in (1, 3, 4, 5)]
+    assert arena.largest_free_block == 256 - 128
+    assert arena.used == 80
+
+    # The moved slices are freed at their new offsets
+    slices[3].release()
+    assert arena.used == 60
+    assert arena.allocate(20).offset == 32
+    arena.release()
+    assert arena.used == 0
+
+
+def test_vertex_array_slices(ctx):
+    prog = ctx.program(
+        vertex_shader='''
+            #version 330
+
+            in float in_value;
+            out float out_value;
+
+            void main() {
+                out_value = in_value * 2.0;
+            }
+        ''',
+        varyings=['out_value']
+    )
+
+    arena = ctx.buffer_arena(1024, alignment=16)
+    arena.allocate(4).write(struct.pack('f', -1.0))
+    vertices = arena.allocate(12)
+    vertices.write(struct.pack('3f', 1.0, 2.0, 3.0))
+    indices = arena.allocate(12)
+    indices.write(struct.pack('3i', 2, 0, 1))
+
+    output = ctx.buffer(reserve=12)
+    vao = ctx.vertex_array(prog, [(vertices, 'f', 'in_value')])
+    assert vao.vertices == 3
+    vao.transform(output, moderngl.POINTS)
+    assert struct.unpack('3f', output.read()) == (2.0, 4.0, 6.0)
+
+    vao = ctx.vertex_array(prog, [(vertices, 'f', 'in_value')], index_buffer=indices)
+    vao.transform(output, moderngl.POINTS)
+    assert struct.unpack('3f', output.read()) == (6.0, 2.0, 4.0)
+    arena.release()
+
+
+def test_render_indirect_slices(ctx):
+    prog = ctx.program(
+        vertex_shader='''
+            #version 330
+            in float in_x;
+            void main() {
+                gl_Position = vec4(in_x, 0.0, 0.0, 1.0);
+            }
+        ''',
+        fragment_shader='''
+            #version 330
+            out vec4 color;
+            void main() {
+                color = vec4(1.0);
+            }
+        ''',
+    )
+
+    arena = ctx.buffer_arena(1024, alignment=16)
+    vertices = arena.allocate(16)
+    vertices.write(struct.pack('4f', -0.75, -0.25, 0.25, 0.75))
+    arena.allocate(32).write(struct.pack('8i', 0, 0, 0, 0, 0, 0, 0, 0))
+    indices = arena.allocate(4)
+    indices.write(struct.pack('i', 2))
+
+    fbo = ctx.simple_framebuffer((4, 1), components=1)
+    fbo.use()
+    fbo.clear()
+
+    vao = ctx.vertex_array(prog, [(vertices, 'f', 'in_x')], index_buffer=indices)
+    command = ctx.buffer(struct.pack('5I', 1, 1, indices.offset // 4, 0, 0))
+    vao.render_indirect(command, moderngl.POINTS)
+    assert fbo.read(components=1) == b'\x00\x00\xff\x00'
+
+    other = arena.allocate(4)
+    other.write(struct.pack('i', 1))
+    vao.index_buffer = other
+    assert vao.index_buffer is other
+    assert vao.vertices == 1
+    fbo.clear()
+    vao.render(moderngl.POINTS)
+    assert fbo.read(components=1) == b'\x00\xff\x00\x00'
+
+    vao.index_buffer = moderngl.BufferSlice(arena, 2, 4)
+    with pytest.raises(moderngl.Error):
+        vao.render_indirect(command, moderngl.POINTS)
@@ -0,0 +1,67 @@
+import pytest
+
+import moderngl
+
+
+def pattern(size):
+    return bytes(i % 251 for i in range(size))
+
+
+@pytest.mark.parametrize('chunk', [1, 3, 4, 8, 12, 16, 32, 64])
+def test_write_chunks_widths(ctx, chunk):
+    step = chunk + 5
+    count = 9
+    buf = ctx.buffer(b'\xff' * (step * count))
+    data = pattern(chunk * count)
+    buf.write_chunks(data, 2, step, count)
+    content = buf.read()
+    for i in range(count):
+        offset = 2 + i * step
+        assert content[offset:offset + chunk] == data[i * chunk:(i + 1) * chunk]
+        assert content[offset + chunk:offset + step] == b'\xff' * min(step - chunk, len(content) - offset - chunk)
+    assert content[:2] == b'\xff\xff'
+
+
+@pytest.mark.parametrize('chunk', [1, 4, 12, 16, 64])
+def test_read_chunks_widths(ctx, chunk):
+    step = chunk * 2
+    count = 11
+    content = pattern(step * count)
+    buf = ctx.buffer(content)
+    expected = b''.join(content[i * step:i * step + chunk] for i in range(count))
+    assert buf.read_chunks(chunk, 0, step, count) == expected
+
+    out = bytearray(len(expected) + 3)
+    buf.read_chunks_into(out, chunk, 0, step, count, write_offset=3)
+    assert bytes(out[3:]) == expected
+
+
+def test_chunks_negative_step(ctx):
+    buf = ctx.buffer(b'.' * 48)
+    buf.write_chunks(b'AAAABBBBCCCC', -16, -16, 3)
+    assert buf.read() == b'CCCC' + b'.' * 12 + b'BBBB' + b'.' * 12 + b'AAAA' + b'.' * 12
+    buf.write_chunks(b'AAAABBBBCCCC', 32, -16, 3)
+    assert buf.read_chunks(4, 0, 16, 3) == b'CCCCBBBBAAAA'
+    assert buf.read_chunks(4, -16, -16, 3) == b'AAAABBBBCCCC'
+
+
+def test_chunks_contiguous(ctx):
+    buf = ctx.buffer(b'.' * 32)
+    buf.write_chunks(b'0123456789abcdef', 8, 4, 4)
+    assert buf.read() == b'.' * 8 + b'0123456789abcdef' + b'.' * 8
+    assert buf.read_chunks(8, 8, 8, 2) == b'0123456789abcdef'
+
+
+def test_chunks_empty(ctx):
+    buf = ctx.buffer(b'abcd')
+    buf.write_chunks(b'', 0, 1, 0)
+    assert buf.read_chunks(0, 0, 2, 2) == b''
+    assert buf.read() == b'abcd'
+
+
+def test_read_chunks_into_overflow(ctx):
+    buf = ctx.buffer(b'abcdefgh')
+    with pytest.raises(moderngl.Error):
+        buf.read_chunks_into(bytearray(3), 2, 0, 4, 2)
+    with pytest.raises(moderngl.Error):
+        buf.read_chunks_into(bytearray(8), 2, 0, 4, 3)
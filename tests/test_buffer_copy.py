@@ -1,3 +1,7 @@
+import pytest
+
+import moderngl
+
 
 def test_1(ctx):
     buf1 = ctx.buffer(b'abc')
@@ -14,3 +18,33 @@ def test_2(ctx):
     ctx.copy_buffer(buf2, buf1, 3, read_offset=6, write_offset=6)
     ctx.copy_buffer(buf2, buf1, 3, read_offset=3, write_offset=9)
     assert buf2.read() == b'xyzabc123xyz'
+
+
+def test_copy_buffers(ctx):
+    buf1 = ctx.buffer(b'abcxyz123')
+    buf2 = ctx.buffer(reserve=12)
+    ctx.copy_buffers([
+        (buf2, buf1, 3, 3, 0),
+        (buf2, buf1, 3, 0, 3),
+        (buf2, buf1, 3, 6, 6),
+        (buf2, buf1, 3, 3, 9),
+    ])
+    assert buf2.read() == b'xyzabc123xyz'
+
+    buf3 = ctx.buffer(reserve=9)
+    ctx.copy_buffers([(buf3, buf1), (buf1, buf2, 3, 9, 6)])
+    assert buf3.read() == b'abcxyz123'
+    assert buf1.read() == b'abcxyzxyz'
+
+
+def test_copy_buffers_validates_first(ctx):
+    buf1 = ctx.buffer(b'abcdef')
+    buf2 = ctx.buffer(b'......')
+    with pytest.raises(moderngl.Error):
+        ctx.copy_buffers([(buf2, buf1, 3, 0, 0), (buf2, buf1, 3, 4, 0)])
+    with pytest.raises(moderngl.Error):
+        ctx.copy_buffers([(buf2, buf1, 3, 0, 0), (buf1, buf1, 3, 0, 2)])
+    assert buf2.read() == b'......'
+    ctx.copy_buffers([])
+    with pytest.raises(moderngl.Error):
+        ctx.copy_buffers([(buf2, b'abc', 3)])
@@ -0,0 +1,105 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+def pattern(size):
+    return bytes(i % 251 for i in range(size))
+
+
+@pytest.mark.parametrize('count', [3, 1000])
+@pytest.mark.parametrize('chunk', [4, 12, 6])
+def test_scatter_gather(ctx, count, chunk):
+    step = chunk * 4
+    vbo = ctx.buffer(b'\xff' * (step * count))
+    data = pattern(chunk * count)
+    staging = ctx.buffer(b'..' + data)
+
+    vbo.scatter(staging, 0, step, count, chunk, offset=2)
+    content = vbo.read()
+    for i in range(count):
+        assert content[i * step:i * step + chunk] == data[i * chunk:(i + 1) * chunk]
+        assert content[i * step + chunk:(i + 1) * step] == b'\xff' * (step - chunk)
+
+    out = ctx.buffer(reserve=len(data))
+    vbo.gather(out, 0, step, count, chunk)
+    assert out.read() == data
+
+
+def test_scatter_attribute(ctx):
+    vertices = 500
+    vbo = ctx.buffer(struct.pack('6f', 0, 0, 0, 1, 1, 1) * vertices)
+    positions = ctx.buffer(struct.pack('3f', 7, 8, 9) * vertices)
+    vbo.scatter(positions, 0, 24, vertices, 12)
+    assert vbo.read() == struct.pack('6f', 7, 8, 9, 1, 1, 1) * vertices
+    assert vbo.read_chunks(12, 12, 24, vertices) == struct.pack('3f', 1, 1, 1) * vertices
+
+
+def test_scatter_negative_step(ctx):
+    vbo = ctx.buffer(b'.' * 12)
+    staging = ctx.buffer(b'AABBCC')
+    vbo.scatter(staging, -4, -4, 3, 2)
+    assert vbo.read() == b'CC..BB..AA..'
+
+
+def test_scatter_keeps_storage_bindings(ctx):
+    if ctx.version_code < 430:
+        pytest.skip('compute shaders are not supported')
+    last = ctx.limits.max_shader_storage_buffer_bindings - 1
+    program = ctx.compute_shader('''
+        #version 430
+        layout (local_size_x = 1) in;
+        layout (std430, binding = %d) buffer Output {
+            uint value;
+        };
+        void main() {
+            value = 42u;
+        }
+    ''' % last)
+    ssbo = ctx.buffer(reserve=4)
+    ssbo.bind_to_storage_buffer(last)
+
+    vbo = ctx.buffer(reserve=8 * 100)
+    vbo.scatter(ctx.buffer(reserve=4 * 100), 0, 8, 100, 4)
+
+    program.run()
+    assert struct.unpack('I', ssbo.read()) == (42,)
+
+
+def test_scatter_errors(ctx):
+    vbo = ctx.buffer(reserve=16)
+    staging = ctx.buffer(reserve=8)
+    with pytest.raises(moderngl.Error):
+        vbo.scatter(staging, 0, 4, 5, 2)
+    with pytest.raises(moderngl.Error):
+        vbo.scatter(staging, 0, 4, 4, 4)
+    with pytest.raises(moderngl.Error):
+        vbo.scatter(staging, 0, 2, 4, 4)
+    with pytest.raises(moderngl.Error):
+        vbo.gather(vbo, 0, 8, 2, 4, offset=4)
+
+
+def test_gather_after_current_program_released(ctx):
+    prog = ctx.program(
+        vertex_shader='''
+            #version 330
+            in float in_value;
+            out float out_value;
+            void main() {
+                out_value = in_value * 2.0;
+            }
+        ''',
+        varyings=['out_value']
+    )
+    vbo = ctx.buffer(struct.pack('3f', 1.0, 2.0, 3.0))
+    output = ctx.buffer(reserve=12)
+    ctx.vertex_array(prog, [(vbo, 'f', 'in_value')]).transform(output, moderngl.POINTS)
+    prog.release()
+
+    a = ctx.buffer(pattern(16 * 100))
+    b = ctx.buffer(reserve=4 * 100)
+    a.gather(b, 0, 16, 100, 4)
+    assert ctx.error == 'GL_NO_ERROR'
+    assert b.read() == b''.join(pattern(16 * 100)[i * 16:i * 16 + 4] for i in range(100))
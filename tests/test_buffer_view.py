@@ -0,0 +1,118 @@
+import struct
+import sys
+
+import pytest
+
+import moderngl
+
+
+def test_typed_view(ctx):
+    buf = ctx.buffer(struct.pack("6f", *range(6)))
+
+    with buf.view("f4", (2, 3)) as view:
+        assert view.format == "f"
+        assert view.shape == (2, 3)
+        assert view.strides == (12, 4)
+        assert not view.readonly
+        assert view.tolist() == [[0.0, 1.0, 2.0], [3.0, 4.0, 5.0]]
+        view[1, 2] = 42.0
+
+    assert struct.unpack("6f", buf.read()) == (0.0, 1.0, 2.0, 3.0, 4.0, 42.0)
+
+
+def test_view_keeps_its_binding(ctx):
+    buf = ctx.buffer(struct.pack("4i", 1, 2, 3, 4))
+    other = ctx.buffer(reserve=16)
+
+    with buf.view("i4", offset=8) as view:
+        other.write(bytes(16))
+        assert view.tolist() == [3, 4]
+
+    assert ctx.error == "GL_NO_ERROR"
+    assert buf.read() == struct.pack("4i", 1, 2, 3, 4)
+
+
+def test_read_only_view(ctx):
+    buf = ctx.buffer(struct.pack("2H", 7, 8))
+
+    with buf.view("u2", access="r") as view:
+        assert view.readonly
+        assert view.tolist() == [7, 8]
+
+        with pytest.raises(TypeError):
+            view[0] = 1
+
+
+def test_invalid_view(ctx):
+    buf = ctx.buffer(reserve=24)
+
+    with pytest.raises(moderngl.Error):
+        buf.view("f4", 10)
+
+    with pytest.raises(moderngl.Error):
+        buf.view("f4", access="x")
+
+    with pytest.raises(moderngl.Error):
+        buf.view("f4", (-1, 2))
+
+
+def test_view_size_overflow(ctx):
+    buf = ctx.buffer(reserve=64)
+
+    # The byte size would wrap around to 8 bytes
+    with pytest.raises(moderngl.Error):
+        buf.view("f8", (2 ** 61 + 1,))
+
+    with pytest.raises(moderngl.Error):
+        buf.view("f4", (2 ** 40, 2 ** 40))
+
+    with pytest.raises(moderngl.Error):
+        buf.view("f4", (0, 4))
+
+
+def test_second_view_of_mapped_buffer(ctx):
+    buf = ctx.buffer(struct.pack("4f", 1.0, 2.0, 3.0, 4.0))
+
+    with buf.view("f4", 2) as view:
+        # The second mapping is refused before reaching GL
+        with pytest.raises(BufferError):
+            memoryview(buf.mglo.view("f", 4, (2,), 8, "rw"))
+        with pytest.raises(moderngl.Error):
+            buf.read()
+        assert ctx.error == "GL_NO_ERROR"
+        assert view.tolist() == [1.0, 2.0]
+
+    with buf.view("f4", 2, offset=8) as view:
+        assert view.tolist() == [3.0, 4.0]
+
+
+def test_view_byte_order(ctx):
+    buf = ctx.buffer(struct.pack("2f", 1.0, 2.0))
+    native = "<" if sys.byteorder == "little" else ">"
+    swapped = ">" if sys.byteorder == "little" else "<"
+
+    with buf.view(native + "f4") as view:
+        assert view.tolist() == [1.0, 2.0]
+
+    with pytest.raises(moderngl.Error, match="native byte order"):
+        buf.view(swapped + "f4")
+
+
+def test_release_while_mapped(ctx_new):
+    buf = ctx_new.buffer(struct.pack("4f", 1.0, 2.0, 3.0, 4.0))
+
+    with buf.view("f4") as view:
+        with pytest.raises(moderngl.Error):
+            buf.release()
+        with pytest.raises(moderngl.Error):
+            buf.orphan()
+        with pytest.raises(moderngl.Error):
+            buf.write(bytes(16))
+
+        # A deferred release waits for the view
+        ctx_new.mglo.defer_release(buf.mglo)
+        assert ctx_new.gc() == 0
+        assert ctx_new.error == "GL_NO_ERROR"
+        assert view.tolist() == [1.0, 2.0, 3.0, 4.0]
+
+    assert ctx_new.gc() == 1
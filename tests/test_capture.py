@@ -0,0 +1,131 @@
+import struct
+
+import pytest
+
+import moderngl
+from conftest import _create_context
+
+
+def render(ctx):
+    prog = ctx.program(
+        vertex_shader='''
+            #version 330
+
+            in vec2 in_vert;
+            uniform vec2 offset;
+
+            void main() {
+                gl_Position = vec4(in_vert + offset, 0.0, 1.0);
+            }
+        ''',
+        fragment_shader='''
+            #version 330
+
+            uniform sampler2D tex;
+            out vec4 color;
+
+            void main() {
+                color = texture(tex, vec2(0.5, 0.5));
+            }
+        ''',
+    )
+    vbo = ctx.buffer(reserve=24)
+    vbo.write_chunks(struct.pack('6f', -1.0, -1.0, 3.0, -1.0, -1.0, 3.0), 0, 8, 3)
+    vao = ctx.vertex_array(prog, [(vbo, '2f', 'in_vert')])
+    tex = ctx.texture((2, 2), 3, bytes([10, 20, 30] * 4))
+    tex.use()
+    prog['offset'] = (0.0, 0.0)
+    fbo = ctx.simple_framebuffer((4, 4))
+    fbo.use()
+    fbo.clear()
+    vao.render()
+    assert tex.read() == bytes([10, 20, 30] * 4)
+    return fbo
+
+
+def test_capture_replay(ctx_new, tmp_path):
+    path = tmp_path / 'frame.mglcap'
+    with ctx_new.capture(path):
+        fbo = render(ctx_new)
+    expected = fbo.read()
+    assert expected == bytes([10, 20, 30] * 16)
+
+    other = _create_context()
+    calls, elapsed = moderngl.replay(path, ctx=other)
+    assert calls > 0
+    assert elapsed > 0
+    assert other.detect_framebuffer(fbo.glo).read() == expected
+    other.release()
+
+
+def test_capture_mapped_writes(ctx_new, tmp_path):
+    ctx = ctx_new
+    pixels = tmp_path / 'pixels.bin'
+    pixels.write_bytes(bytes([40, 50, 60] * 4))
+    path = tmp_path / 'frame.mglcap'
+
+    with ctx.capture(path):
+        prog = ctx.program(
+            vertex_shader='''
+                #version 330
+                in vec2 in_vert;
+                void main() {
+                    gl_Position = vec4(in_vert, 0.0, 1.0);
+                }
+            ''',
+            fragment_shader='''
+                #version 330
+                uniform sampler2D tex;
+                out vec4 color;
+                void main() {
+                    color = texture(tex, vec2(0.5, 0.5));
+                }
+            ''',
+        )
+        vbo = ctx.buffer(reserve=24)
+        with vbo.view('f4', (6,), access='w') as view:
+            view.cast('B')[:] = struct.pack('6f', -1.0, -1.0, 3.0, -1.0, -1.0, 3.0)
+        vao = ctx.vertex_array(prog, [(vbo, '2f', 'in_vert')])
+        tex = ctx.texture((2, 2), 3)
+        tex.write_from_file(pixels, chunk=6)
+        tex.use()
+        fbo = ctx.simple_framebuffer((4, 4))
+        fbo.use()
+        fbo.clear()
+        vao.render()
+
+    expected = fbo.read()
+    assert expected == bytes([40, 50, 60] * 16)
+
+    other = _create_context()
+    moderngl.replay(path, ctx=other)
+    assert other.detect_framebuffer(fbo.glo).read() == expected
+    other.release()
+
+
+def test_replay_standalone(ctx_new, tmp_path):
+    path = tmp_path / 'frame.mglcap'
+    with ctx_new.capture(str(path)):
+        ctx_new.clear(1.0, 0.0, 0.0)
+        ctx_new.finish()
+    calls, _ = moderngl.replay(path, backend='null')
+    assert calls > 0
+
+
+def test_capture_with_stats(ctx_new, tmp_path):
+    ctx_new.enable_gl_stats()
+    with ctx_new.capture(tmp_path / 'frame.mglcap'):
+        ctx_new.finish()
+    assert ctx_new.gl_stats()['glFinish'][0] == 1
+    ctx_new.disable_gl_stats()
+
+
+def test_invalid_capture(ctx_new, tmp_path):
+    path = tmp_path / 'invalid.mglcap'
+    path.write_bytes(b'not a capture')
+    with pytest.raises(moderngl.Error, match='not a capture file'):
+        moderngl.replay(path, ctx=ctx_new)
+
+    with ctx_new.capture(tmp_path / 'frame.mglcap'):
+        with pytest.raises(moderngl.Error):
+            ctx_new.mglo.begin_capture(str(tmp_path / 'other.mglcap'))
@@ -0,0 +1,128 @@
+def test_batched_deletes(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+
+    buffers = [ctx.buffer(reserve=64) for _ in range(20)]
+    textures = [ctx.texture((4, 4), 4) for _ in range(10)]
+    samplers = [ctx.sampler() for _ in range(5)]
+    assert ctx.memory_stats()["buffer"]["count"] == 20
+
+    ctx.enable_gl_stats()
+    try:
+        buffers = textures = samplers = None
+        assert ctx.gc() == 35
+        stats = ctx.gl_stats()
+    finally:
+        ctx.disable_gl_stats()
+
+    assert stats["glDeleteBuffers"][0] == 1
+    assert stats["glDeleteTextures"][0] == 1
+    assert stats["glDeleteSamplers"][0] == 1
+    assert ctx.memory_stats()["buffer"]["count"] == 0
+    assert ctx.gc() == 0
+
+
+def test_mixed_objects(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            out vec4 color;
+            void main() {
+                color = vec4(1.0);
+            }
+        """,
+    )
+    vbo = ctx.buffer(reserve=24)
+    vao = ctx.vertex_array(prog, [(vbo, "2f", "in_vert")])
+    fbo = ctx.framebuffer(ctx.texture((4, 4), 4))
+
+    prog = vbo = vao = fbo = None
+    assert ctx.gc() == 5
+
+
+def test_manually_queued(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+
+    buf = ctx.buffer(reserve=64)
+    ctx.objects.append(buf.mglo)
+    assert ctx.gc() == 1
+    assert ctx.memory_stats()["buffer"]["count"] == 0
+    buf.release()
+
+
+def test_released_before_collected(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+
+    buf = ctx.buffer(reserve=64)
+    buf.release()
+    buf = None
+    assert ctx.gc() == 0
+
+    # Objects released one by one are not counted twice either
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            void main() {
+                gl_Position = vec4(0.0);
+            }
+        """,
+    )
+    ctx.objects.append(prog.mglo)
+    prog.mglo.release()
+    assert ctx.gc() == 0
+    assert len(ctx.objects) == 0
+
+
+def test_external_texture(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+
+    tex = ctx.texture((4, 4), 4)
+    ext = ctx.external_texture(tex.glo, (4, 4), 4, 0, "f1")
+
+    # Nothing is deleted for an external texture, it is not counted
+    ext = None
+    assert ctx.gc() == 0
+    assert ctx.memory_stats()["texture"]["count"] == 1
+
+    tex.release()
+    assert ctx.gc() == 0
+    ctx.gc_mode = None
+    tex = None
+
+
+def test_deferred_after_context_release(ctx_new):
+    ctx = ctx_new
+    ctx.gc_mode = "context_gc"
+    native = ctx.mglo
+
+    buf = ctx.buffer(reserve=64)
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            void main() {
+                gl_Position = vec4(0.0);
+            }
+        """,
+    )
+    ctx.release()
+
+    # The queue is freed with the context, the objects are only marked released
+    native.defer_release(buf.mglo)
+    native.defer_release(prog.mglo)
+    assert native.release_deferred() == 0
+
+    ctx.gc_mode = None
+    buf = prog = None
@@ -0,0 +1,83 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+@pytest.fixture
+def samples(ctx):
+    if ctx.max_samples < 4:
+        pytest.skip("multisampling is not supported")
+    return 4
+
+
+def test_resolve(ctx, samples):
+    fbo = ctx.simple_framebuffer((4, 4), samples=samples)
+    fbo.clear(1.0, 0.0, 1.0, 1.0)
+
+    texture = fbo.resolve()
+    assert texture.samples == 0
+    assert texture.size == (4, 4)
+    assert texture.components == 4
+    assert texture.read() == b'\xff\x00\xff\xff' * 16
+
+    # The resolve target is cached
+    fbo.clear(0.0, 1.0, 0.0, 1.0)
+    assert fbo.resolve() is texture
+    assert texture.read() == b'\x00\xff\x00\xff' * 16
+
+
+def test_resolve_attachments(ctx, samples):
+    rbo1 = ctx.renderbuffer((4, 4), samples=samples)
+    rbo2 = ctx.renderbuffer((4, 4), 2, samples=samples, dtype='f4')
+    fbo = ctx.framebuffer([rbo1, rbo2])
+    fbo.clear(0.25, 0.5, 0.0, 1.0)
+
+    texture = fbo.resolve(1)
+    assert texture.components == 2
+    assert texture.dtype == 'f4'
+    assert texture.read() == struct.pack('2f', 0.25, 0.5) * 16
+    assert fbo.resolve(0) is not texture
+
+
+def test_resolve_depth(ctx, samples):
+    fbo = ctx.simple_framebuffer((4, 4), samples=samples)
+    fbo.clear(depth=0.5)
+
+    texture = fbo.resolve(-1)
+    assert texture.depth is True
+    assert struct.unpack('16f', texture.read()) == pytest.approx([0.5] * 16, abs=1e-6)
+
+
+def test_read_resolved(ctx, samples):
+    fbo = ctx.simple_framebuffer((4, 4), samples=samples)
+    fbo.clear(1.0, 0.0, 0.0, 1.0)
+
+    assert fbo.read_resolved() == b'\xff\x00\x00' * 16
+    assert fbo.read_resolved(viewport=(2, 2), components=4) == b'\xff\x00\x00\xff' * 4
+
+
+def test_resolve_invalid_attachment(ctx, samples):
+    fbo = ctx.framebuffer(depth_attachment=ctx.depth_renderbuffer((4, 4), samples=samples))
+
+    with pytest.raises(Exception):
+        fbo.resolve(0)
+
+
+def test_resolve_after_target_released(ctx, samples):
+    fbo = ctx.simple_framebuffer((4, 4), samples=samples)
+    fbo.clear(1.0, 0.0, 0.0, 1.0)
+    fbo.resolve().release()
+
+    # The new target may get the name of the released one, it is attached again
+    fbo.clear(0.0, 0.0, 1.0, 1.0)
+    texture = fbo.resolve()
+    assert texture.read() == b'\x00\x00\xff\xff' * 16
+    assert fbo.read_resolved() == b'\x00\x00\xff' * 16
+
+    released = ctx.texture((4, 4), 4)
+    mglo = released.mglo
+    released.release()
+    with pytest.raises(moderngl.Error):
+        fbo.mglo.resolve(mglo, 0)
@@ -0,0 +1,49 @@
+import pytest
+
+import moderngl
+from conftest import _create_context
+
+
+def test_gl_stats(ctx_new):
+    ctx = ctx_new
+    ctx.enable_gl_stats()
+    buf = ctx.buffer(reserve=64)
+    buf.write(bytes(16))
+    buf.write(bytes(16))
+
+    stats = ctx.gl_stats()
+    calls, time = stats['glBufferSubData']
+    assert calls == 2
+    assert time >= 0
+    assert 'glDrawArrays' not in stats
+
+    ctx.reset_gl_stats()
+    assert ctx.gl_stats() == {}
+
+    ctx.disable_gl_stats()
+    with pytest.raises(moderngl.Error):
+        ctx.gl_stats()
+
+
+def test_gl_trace(ctx_new):
+    ctx = ctx_new
+    ctx.enable_gl_stats(trace=4)
+    for _ in range(3):
+        ctx.finish()
+    assert [name for name, _, _ in ctx.gl_trace()] == ['glFinish'] * 3
+
+    for _ in range(10):
+        ctx.finish()
+    trace = ctx.gl_trace()
+    assert len(trace) == 4
+    assert trace[0][1] <= trace[-1][1]
+    ctx.disable_gl_stats()
+
+
+def test_single_context(ctx_new):
+    ctx_new.enable_gl_stats()
+    other = _create_context()
+    with pytest.raises(moderngl.Error):
+        other.enable_gl_stats()
+    other.release()
+    ctx_new.release()
@@ -0,0 +1,78 @@
+import json
+from types import SimpleNamespace
+
+import pytest
+
+import moderngl
+
+
+def test_gpu_profiler(ctx):
+    prof = ctx.gpu_profiler(history=2)
+
+    for _ in range(3):
+        with prof.frame():
+            with prof.zone("outer"):
+                ctx.clear()
+                with prof.zone("inner"):
+                    ctx.clear()
+            with prof.zone("second"):
+                pass
+
+    ctx.finish()
+    prof.collect()
+    assert prof.pending == 0
+    assert len(prof.frames) == 2
+
+    frame = prof.frames[-1]
+    assert [zone.name for zone in frame.walk()] == ["frame", "outer", "inner", "second"]
+    assert [zone.depth for zone in frame.walk()] == [0, 1, 2, 1]
+    outer, second = frame.children
+    assert frame.start <= outer.start <= outer.children[0].start <= outer.end <= second.start <= frame.end
+    assert frame.as_dict()["children"][0]["children"][0]["name"] == "inner"
+    prof.release()
+
+
+def test_gpu_profiler_zone_outside_frame(ctx):
+    prof = ctx.gpu_profiler()
+    with pytest.raises(moderngl.Error):
+        with prof.zone("zone"):
+            pass
+    prof.release()
+
+
+def test_chrome_trace(ctx, tmp_path):
+    prof = ctx.gpu_profiler()
+    with prof.frame("first"):
+        with prof.zone("pass"):
+            ctx.clear()
+    ctx.finish()
+    prof.collect()
+
+    path = tmp_path / "trace.json"
+    prof.save_chrome_trace(path)
+    events = json.loads(path.read_text())["traceEvents"]
+    assert [e["name"] for e in events] == ["first", "pass"]
+    assert all(e["ph"] == "X" and e["dur"] >= 0 for e in events)
+    prof.release()
+
+
+def test_release_open_frame(ctx):
+    prof = ctx.gpu_profiler()
+    prof.begin_frame()
+    with prof.zone("zone"):
+        ctx.clear()
+
+    deleted = []
+
+    class Native:
+        def __getattr__(self, name):
+            return getattr(ctx.mglo, name)
+
+        def delete_queries(self, queries):
+            deleted.extend(queries)
+            ctx.mglo.delete_queries(queries)
+
+    # The queries of the frame still open are deleted with the free ones
+    prof.ctx = SimpleNamespace(mglo=Native())
+    prof.release()
+    assert len(deleted) == 32
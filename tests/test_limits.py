@@ -0,0 +1,25 @@
+import pytest
+
+
+def test_limits(ctx):
+    limits = ctx.limits
+
+    assert limits is ctx.limits
+    assert limits.max_texture_size == limits["max_texture_size"] == ctx.info["GL_MAX_TEXTURE_SIZE"]
+    assert limits.max_samples == ctx.max_samples
+    assert limits.max_texture_image_units == ctx.max_texture_units
+    assert len(limits.max_viewport_dims) == 2
+    assert len(limits.max_compute_work_group_size) == 3
+    assert "max_shader_storage_block_size" in limits
+    assert dict(limits) == {name: getattr(limits, name) for name in limits}
+
+
+def test_limits_read_only(ctx):
+    with pytest.raises(AttributeError):
+        ctx.limits.max_texture_size = 1
+
+    with pytest.raises(TypeError):
+        ctx.limits["max_texture_size"] = 1
+
+    with pytest.raises(AttributeError):
+        ctx.limits.max_unknown
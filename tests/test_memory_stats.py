@@ -0,0 +1,77 @@
+import pytest
+
+
+def test_buffer(ctx_new):
+    buf = ctx_new.buffer(reserve=1024)
+    stats = ctx_new.memory_stats()
+    assert stats['buffer'] == {'count': 1, 'total': 1024, 'peak': 1024}
+    assert stats['total'] == 1024
+
+    buf.orphan(4096)
+    assert ctx_new.memory_stats()['buffer']['total'] == 4096
+
+    buf.release()
+    stats = ctx_new.memory_stats()
+    assert stats['buffer'] == {'count': 0, 'total': 0, 'peak': 4096}
+    assert stats['peak'] == 4096
+
+
+def test_textures(ctx_new):
+    ctx_new.texture((16, 16), 4)
+    ctx_new.texture((8, 8), 1, dtype='f4', samples=0)
+    ctx_new.depth_texture((8, 8))
+    ctx_new.texture3d((4, 4, 4), 2)
+    ctx_new.texture_array((4, 4, 3), 1, dtype='f2')
+    ctx_new.texture_cube((4, 4), 3)
+
+    stats = ctx_new.memory_stats()
+    assert stats['texture']['count'] == 6
+    assert stats['texture']['total'] == 1024 + 256 + 256 + 128 + 96 + 288
+
+
+def test_mipmaps(ctx_new):
+    tex = ctx_new.texture((64, 64), 4)
+    tex.build_mipmaps()
+    assert ctx_new.memory_stats()['texture']['total'] == 4 * (4096 + 1024 + 256 + 64 + 16 + 4 + 1)
+
+    tex.build_mipmaps(max_level=1)
+    assert ctx_new.memory_stats()['texture']['total'] == 4 * (4096 + 1024)
+
+
+def test_renderbuffer(ctx_new):
+    if ctx_new.max_samples < 4:
+        pytest.skip('multisampling is not supported')
+
+    rbo = ctx_new.renderbuffer((16, 16), 4, samples=4)
+    assert ctx_new.memory_stats()['renderbuffer']['total'] == 16 * 16 * 4 * 4
+
+    rbo.release()
+    assert ctx_new.memory_stats()['renderbuffer']['total'] == 0
+
+
+def test_labels(ctx_new):
+    if not ctx_new.supports_labels:
+        pytest.skip('labels are not supported')
+
+    ctx_new.buffer(reserve=100).label = 'mesh'
+    ctx_new.buffer(reserve=200).label = 'mesh'
+    ctx_new.texture((4, 4), 4).label = 'albedo'
+    ctx_new.buffer(reserve=10)
+
+    assert ctx_new.memory_stats()['labels'] == {'mesh': 300, 'albedo': 64, None: 10}
+
+
+def test_reset_peak(ctx_new):
+    ctx_new.buffer(reserve=1000).release()
+    assert ctx_new.memory_stats(reset_peak=True)['peak'] == 1000
+    assert ctx_new.memory_stats()['peak'] == 0
+
+
+def test_after_context_release(ctx_new):
+    native = ctx_new.mglo
+    buf = ctx_new.buffer(reserve=64)
+    ctx_new.release()
+
+    # The tracked objects are freed with the context
+    assert native.memory_stats(False)['objects'] == {}
+    buf.release()
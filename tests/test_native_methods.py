@@ -0,0 +1,93 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+def test_bound_on_the_instance(ctx):
+    buf = ctx.buffer(reserve=16)
+    tex = ctx.texture((4, 4), 4)
+
+    assert type(buf.write).__name__ == "builtin_function_or_method"
+    assert type(buf.read).__name__ == "builtin_function_or_method"
+    assert type(tex.use).__name__ == "builtin_function_or_method"
+
+    # Released objects go back to the wrappers raising on use
+    buf.release()
+    tex.release()
+    with pytest.raises(AttributeError):
+        buf.write(bytes(16))
+    with pytest.raises(AttributeError):
+        tex.use()
+
+
+def test_buffer_arguments(ctx):
+    buf = ctx.buffer(reserve=16)
+
+    buf.write(struct.pack("4f", 1.0, 2.0, 3.0, 4.0))
+    buf.write(data=struct.pack("f", 5.0), offset=12)
+    buf.write(struct.pack("f", 6.0), offset=0)
+
+    assert struct.unpack("4f", buf.read()) == (6.0, 2.0, 3.0, 5.0)
+    assert struct.unpack("f", buf.read(4, 4)) == (2.0,)
+    assert struct.unpack("2f", buf.read(offset=8)) == (3.0, 5.0)
+    assert struct.unpack("f", buf.read(size=4, offset=8)) == (3.0,)
+
+
+def test_buffer_wrong_arguments(ctx):
+    buf = ctx.buffer(reserve=16)
+
+    with pytest.raises(TypeError, match="missing required argument 'data'"):
+        buf.write()
+    with pytest.raises(TypeError, match="missing required argument 'data'"):
+        buf.write(offset=4)
+    with pytest.raises(TypeError, match="positional arguments"):
+        buf.write(bytes(4), 0, 0)
+    with pytest.raises(TypeError, match="multiple values for argument 'offset'"):
+        buf.write(bytes(4), 0, offset=4)
+    with pytest.raises(TypeError, match="unexpected keyword argument 'offst'"):
+        buf.read(offst=4)
+    with pytest.raises(TypeError, match="positional arguments"):
+        buf.read(4, 0, 0)
+
+
+def test_texture_use(ctx):
+    tex = ctx.texture((4, 4), 4)
+    tex.use()
+    tex.use(1)
+    tex.use(location=2)
+
+    with pytest.raises(TypeError, match="positional arguments"):
+        tex.use(0, 1)
+    with pytest.raises(TypeError, match="unexpected keyword argument 'index'"):
+        tex.use(index=0)
+
+
+def test_compute_shader_run(ctx):
+    if ctx.version_code < 430:
+        pytest.skip("compute shaders need OpenGL 4.3")
+
+    buf = ctx.buffer(reserve=4 * 8)
+    buf.bind_to_storage_buffer(0)
+    compute = ctx.compute_shader("""
+        #version 430
+        layout(local_size_x = 1) in;
+        layout(std430, binding = 0) buffer Output {
+            uint values[];
+        };
+        void main() {
+            atomicAdd(values[gl_WorkGroupID.x], 1u);
+        }
+    """)
+
+    compute.run()
+    compute.run(2)
+    compute.run(group_x=4, group_z=1)
+    ctx.finish()
+    assert struct.unpack("8I", buf.read()) == (3, 2, 1, 1, 0, 0, 0, 0)
+
+    with pytest.raises(TypeError, match="positional arguments"):
+        compute.run(1, 1, 1, 1)
+    with pytest.raises(TypeError, match="multiple values for argument 'group_x'"):
+        compute.run(1, group_x=1)
@@ -0,0 +1,178 @@
+import ctypes
+import struct
+
+import pytest
+
+import _moderngl
+import moderngl
+
+
+@pytest.fixture
+def null_ctx():
+    ctx = moderngl.create_context(standalone=True, backend='null')
+    yield ctx
+    ctx.release()
+
+
+def test_context(null_ctx):
+    assert null_ctx.version_code == 460
+    assert null_ctx.info['GL_RENDERER'] == 'null'
+    assert null_ctx.error == 'GL_NO_ERROR'
+
+
+def test_objects(null_ctx):
+    ctx = null_ctx
+    buf = ctx.buffer(struct.pack('4f', 1.0, 2.0, 3.0, 4.0))
+    buf.write(bytes(8), offset=8)
+    assert len(buf.read()) == 16
+
+    tex = ctx.texture((4, 4), 4)
+    tex.write(bytes(64))
+    assert len(tex.read()) == 64
+    assert tex.glo != buf.glo
+
+    fbo = ctx.framebuffer(tex)
+    fbo.use()
+    fbo.clear(1.0, 0.0, 0.0)
+    assert len(fbo.read(components=4)) == 64
+
+
+def test_render(null_ctx):
+    ctx = null_ctx
+    prog = ctx.program(
+        vertex_shader='#version 330\nvoid main() {}',
+        fragment_shader='#version 330\nvoid main() {}',
+    )
+    vao = ctx.vertex_array(prog, [])
+    ctx.enable_gl_stats()
+    for _ in range(10):
+        vao.render(vertices=3)
+    assert ctx.gl_stats()['glDrawArraysInstanced'][0] == 10
+    ctx.disable_gl_stats()
+
+
+def test_introspection(null_ctx):
+    ctx = null_ctx
+    prog = ctx.program(
+        vertex_shader="""
+            #version 330
+            // uniform float commented;
+            layout(location = 0) in vec2 in_vert;
+            in vec3 in_color, in_normal;
+            uniform mat4 mvp;
+            uniform float weights[4];
+            uniform Block { vec4 value; };
+            void helper(in vec3 p) {}
+            void main() {}
+        """,
+        fragment_shader="""
+            #version 330
+            in vec3 v_color;
+            uniform sampler2D tex;
+            uniform mat4 mvp;
+            out vec4 color;
+            void main() {}
+        """,
+    )
+    assert list(prog) == ['in_vert', 'in_color', 'in_normal', 'mvp', 'weights', 'tex']
+    assert prog['in_color'].dimension == 3
+    assert prog['weights'].array_length == 4
+    assert prog['mvp'].value == (0.0,) * 16
+    prog['mvp'].value = tuple(range(16))
+
+    vbo = ctx.buffer(reserve=24)
+    vao = ctx.vertex_array(prog, [(vbo, '2f', 'in_vert')])
+    vao.render(vertices=3)
+    assert ctx.error == 'GL_NO_ERROR'
+
+
+def test_null_function():
+    from moderngl import mgl
+
+    assert mgl.null_gl_function('glDrawArrays') != 0
+    assert mgl.null_gl_function('glDoesNotExist') == 0
+
+
+def test_data_getters(null_ctx):
+    ctx = null_ctx
+    tex = ctx.texture((1, 1), 1, dtype='f1')
+    assert len(tex.read()) == 1
+    buf = ctx.buffer(reserve=1)
+    assert len(buf.read()) == 1
+    assert ctx.error == 'GL_NO_ERROR'
+
+
+class RecordingLoader:
+    def __init__(self):
+        self.names = []
+
+    def load_opengl_function(self, name):
+        from moderngl import mgl
+
+        self.names.append(name)
+        return mgl.null_gl_function(name)
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *args):
+        pass
+
+    def release(self):
+        pass
+
+
+def test_loader_passed_in_is_not_cached():
+    # Two loaders of the same type may resolve from different libraries, each one resolves its own table
+    for _ in range(2):
+        loader = RecordingLoader()
+        ctx = moderngl.create_context(standalone=True, context=loader)
+        assert 'glDrawArrays' in loader.names
+        ctx.release()
+
+
+class CachedLoader(RecordingLoader):
+    loaders = []
+
+    def __init__(self):
+        super().__init__()
+        self.loaders.append(self)
+
+
+def test_null_backend_is_cached(monkeypatch):
+    # The first null context of this loader type resolves the table, the next one only reads the driver strings
+    monkeypatch.setattr(_moderngl, 'NullLoader', CachedLoader)
+    for _ in range(2):
+        moderngl.create_context(standalone=True, backend='null').release()
+    first, second = CachedLoader.loaders
+    assert 'glDrawArrays' in first.names
+    assert second.names == ['glGetString']
+
+
+class RenamedLoader(RecordingLoader):
+    # Every instance resolves glGetString to the same function, only the renderer string changes
+    renderer = b'null'
+    strings = {}
+
+    @staticmethod
+    @ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_uint)
+    def get_string(name):
+        value = {0x1F00: b'moderngl', 0x1F01: RenamedLoader.renderer, 0x1F02: b'4.6.0 null'}.get(name, b'')
+        if value not in RenamedLoader.strings:
+            RenamedLoader.strings[value] = ctypes.create_string_buffer(value)
+        return ctypes.addressof(RenamedLoader.strings[value])
+
+    def load_opengl_function(self, name):
+        if name == 'glGetString':
+            self.names.append(name)
+            return ctypes.cast(self.get_string, ctypes.c_void_p).value
+        return super().load_opengl_function(name)
+
+
+def test_driver_strings_are_part_of_the_key(monkeypatch):
+    for renderer, resolved in [(b'first', True), (b'first', False), (b'second', True)]:
+        RenamedLoader.renderer = renderer
+        loader = RenamedLoader()
+        monkeypatch.setattr(_moderngl, 'NullLoader', lambda: loader)
+        moderngl.create_context(standalone=True, backend='null').release()
+        assert ('glDrawArrays' in loader.names) == resolved
@@ -0,0 +1,90 @@
+import struct
+
+import pytest
+
+IDENTITY = struct.pack('16f', 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1)
+
+
+@pytest.fixture
+def scene(ctx):
+    fbo = ctx.framebuffer(ctx.renderbuffer((16, 16)), ctx.depth_renderbuffer((16, 16)))
+    fbo.use()
+    aabbs = ctx.buffer(struct.pack(
+        '12f',
+        -0.5, -0.5, -0.5, 0.5, 0.5, 0.5,
+        3.0, 3.0, -0.5, 4.0, 4.0, 0.5,
+    ))
+    return fbo, aabbs
+
+
+def wait(ctx, culler):
+    ctx.finish()
+    culler.collect()
+
+
+def test_visibility(ctx, scene):
+    fbo, aabbs = scene
+    culler = ctx.occlusion_culler(2)
+    assert culler.visible == b'\x03'
+
+    fbo.clear(depth=1.0)
+    assert culler.test(aabbs, IDENTITY) == 2
+    wait(ctx, culler)
+    assert culler.is_visible(0) is True
+    assert culler.is_visible(1) is False
+
+    fbo.clear(depth=0.0)
+    culler.test(aabbs, IDENTITY)
+    wait(ctx, culler)
+    assert culler.is_visible(0) is False
+    assert culler.visible == b'\x00'
+    culler.release()
+
+
+def test_state_restored(ctx, scene):
+    fbo, aabbs = scene
+    fbo.clear(0.25, 0.5, 0.75, 1.0, depth=1.0)
+    culler = ctx.occlusion_culler(2)
+    culler.test(aabbs, [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1], count=1)
+    assert fbo.read(viewport=(8, 8, 1, 1)) == bytes([64, 128, 191])
+    assert fbo.read(viewport=(8, 8, 1, 1), components=1, attachment=-1, dtype='f4') == struct.pack('f', 1.0)
+    culler.release()
+
+
+def test_conditional(ctx, scene):
+    fbo, aabbs = scene
+    culler = ctx.occlusion_culler(2)
+    fbo.clear(depth=0.0)
+    culler.test(aabbs, IDENTITY)
+    wait(ctx, culler)
+
+    # Hidden, the clear is skipped
+    with culler.conditional(0):
+        fbo.clear(1.0, 1.0, 1.0, 1.0)
+    assert fbo.read(viewport=(8, 8, 1, 1)) == bytes([0, 0, 0])
+
+    with culler.conditional(1):
+        pass
+
+    fbo.clear(depth=1.0)
+    culler.test(aabbs, IDENTITY)
+    wait(ctx, culler)
+
+    # Visible, the clear is applied
+    with culler.conditional(0):
+        fbo.clear(1.0, 1.0, 1.0, 1.0)
+    assert fbo.read(viewport=(8, 8, 1, 1)) == bytes([255, 255, 255])
+
+    culler.release()
+
+
+def test_invalid(ctx, scene):
+    fbo, aabbs = scene
+    culler = ctx.occlusion_culler(1)
+    with pytest.raises(Exception):
+        culler.test(aabbs, IDENTITY, count=2)
+    with pytest.raises(Exception):
+        culler.test(aabbs, b'\x00' * 12, count=1)
+    with pytest.raises(Exception):
+        culler.is_visible(1)
+    culler.release()
@@ -0,0 +1,94 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+@pytest.fixture
+def quad(ctx):
+    prog = ctx.program(
+        vertex_shader='''
+            #version 330
+
+            in vec2 in_vert;
+
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        ''',
+        fragment_shader='''
+            #version 330
+
+            out vec4 color;
+
+            void main() {
+                color = vec4(1.0);
+            }
+        ''',
+    )
+    vbo = ctx.buffer(struct.pack('8f', -1.0, -1.0, 1.0, -1.0, -1.0, 1.0, 1.0, 1.0))
+    vao = ctx.vertex_array(prog, [(vbo, '2f', 'in_vert')], mode=moderngl.TRIANGLE_STRIP)
+    fbo = ctx.simple_framebuffer((8, 8))
+    fbo.use()
+    return vao
+
+
+def test_try_get(ctx, quad):
+    query = ctx.query(samples=True, primitives=True)
+    assert query.available is False
+    assert query.try_get() is None
+
+    with query:
+        quad.render()
+
+    ctx.finish()
+    assert query.available is True
+    assert query.try_get() == {'samples': 64, 'primitives': 2}
+
+
+def test_write_to(ctx, quad):
+    if ctx.version_code < 440 and 'GL_ARB_query_buffer_object' not in ctx.extensions:
+        pytest.skip('query buffer objects are not supported')
+
+    query = ctx.query(samples=True)
+    buf = ctx.buffer(bytes(16))
+
+    # A query that never ran has no result
+    with pytest.raises(moderngl.Error):
+        query.write_to(buf)
+    assert ctx.error == 'GL_NO_ERROR'
+
+    with query:
+        quad.render()
+
+    query.write_to(buf, offset=4)
+    query.write_to(buf, offset=8, wide=True)
+    assert struct.unpack('IIQ', buf.read()) == (0, 64, 64)
+
+    with pytest.raises(moderngl.Error):
+        query.write_to(buf, result='primitives')
+
+    with pytest.raises(moderngl.Error):
+        query.write_to(buf, offset=2)
+
+
+def test_statistics(ctx, quad):
+    if ctx.version_code < 460 and 'GL_ARB_pipeline_statistics_query' not in ctx.extensions:
+        pytest.skip('pipeline statistics queries are not supported')
+
+    query = ctx.query(statistics=True)
+    with query:
+        quad.render()
+
+    stats = query.statistics
+    assert stats['vertices_submitted'] == 4
+    assert stats['vertex_shader_invocations'] >= 4
+    assert stats['fragment_shader_invocations'] >= 64
+    assert stats['compute_shader_invocations'] == 0
+
+    ctx.finish()
+    assert query.try_get() == {'statistics': stats}
+
+    with pytest.raises(moderngl.Error):
+        query.samples
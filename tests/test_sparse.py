@@ -0,0 +1,50 @@
+import pytest
+
+import moderngl
+
+
+def test_not_sparse(ctx):
+    buf = ctx.buffer(reserve=64)
+    assert buf.page_size is None
+    with pytest.raises(moderngl.Error):
+        buf.commit()
+
+    tex = ctx.texture((4, 4), 4)
+    assert tex.page_size is None
+    with pytest.raises(moderngl.Error):
+        tex.commit()
+
+
+def test_sparse_buffer(ctx):
+    if "GL_ARB_sparse_buffer" not in ctx.extensions:
+        with pytest.raises(moderngl.Error):
+            ctx.sparse_buffer(1024)
+        pytest.skip("GL_ARB_sparse_buffer is not supported")
+
+    page = ctx.sparse_buffer(1).page_size
+    buf = ctx.sparse_buffer(page * 4)
+    assert buf.size == page * 4
+
+    buf.commit(page, page)
+    buf.write(b"\x01" * page, offset=page)
+    assert buf.read(page, offset=page) == b"\x01" * page
+    buf.decommit(page, page)
+
+    with pytest.raises(moderngl.Error):
+        buf.commit(1, page)
+
+
+def test_sparse_texture(ctx):
+    if "GL_ARB_sparse_texture" not in ctx.extensions:
+        with pytest.raises(moderngl.Error):
+            ctx.sparse_texture((256, 256), 4)
+        pytest.skip("GL_ARB_sparse_texture is not supported")
+
+    tex = ctx.sparse_texture((1024, 1024), 4)
+    px, py, _ = tex.page_size
+    tex.commit((0, 0, px, py))
+    tex.write(b"\xff" * px * py * 4, viewport=(0, 0, px, py))
+    tex.decommit((0, 0, px, py))
+
+    with pytest.raises(moderngl.Error):
+        tex.commit((1, 0, px, py))
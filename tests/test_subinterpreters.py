@@ -0,0 +1,72 @@
+import importlib
+import threading
+
+import pytest
+
+import moderngl
+
+for name in ("_interpreters", "_xxsubinterpreters"):
+    try:
+        interpreters = importlib.import_module(name)
+        break
+    except ImportError:
+        interpreters = None
+
+pytestmark = pytest.mark.skipif(interpreters is None, reason="subinterpreters are not available")
+
+# glcontext uses single-phase init and cannot be imported in a subinterpreter,
+# the null backend does not load it
+JOB = """
+import moderngl
+
+ctx = moderngl.create_context(standalone=True, backend="null")
+buf = ctx.buffer(b"moderngl")
+assert buf.size == 8
+assert ctx.memory_stats()["buffer"] == {"count": 1, "total": 8, "peak": 8}
+
+try:
+    ctx.mglo.adopt(object())
+    raise AssertionError("no error raised")
+except moderngl.Error:
+    pass
+
+ctx.release()
+"""
+
+
+def _run(code):
+    interp = interpreters.create()
+    try:
+        if hasattr(interpreters, "run_string"):
+            interpreters.run_string(interp, code)
+        else:
+            interpreters.exec(interp, code)
+    finally:
+        interpreters.destroy(interp)
+
+
+def test_isolated_module(ctx):
+    # One interpreter per thread, the contexts current on this thread are not touched
+    errors = []
+
+    def job():
+        try:
+            _run(JOB)
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=job) for _ in range(3)]
+
+    for thread in threads:
+        thread.start()
+
+    for thread in threads:
+        thread.join()
+
+    assert not errors
+
+    buf = ctx.buffer(b"main")
+    assert buf.read() == b"main"
+
+    with pytest.raises(moderngl.Error):
+        ctx.mglo.adopt(object())
@@ -0,0 +1,98 @@
+import gc
+import importlib.util
+import threading
+
+import pytest
+
+import moderngl
+
+
+def _render(results, index):
+    ctx = moderngl.create_context(standalone=True, backend="egl")
+    ctx.gc_mode = "context_gc"
+    data = bytes([index]) * 1024
+
+    for _ in range(50):
+        buf = ctx.buffer(data)
+        results[index] = buf.read() == data
+        del buf
+
+    ctx.gc()
+    results[index] = results[index] and ctx.memory_stats()["buffer"]["count"] == 0
+    ctx.release()
+
+
+def test_independent_contexts():
+    results = [False] * 4
+    threads = [threading.Thread(target=_render, args=(results, i)) for i in range(4)]
+
+    for thread in threads:
+        thread.start()
+
+    for thread in threads:
+        thread.join()
+
+    assert all(results)
+
+
+def _use_framebuffers(ctx, framebuffers, errors):
+    try:
+        for _ in range(200):
+            for fbo in framebuffers:
+                fbo.use()
+                ctx.enable(moderngl.BLEND)
+                ctx.disable(moderngl.BLEND)
+            assert ctx.fbo in framebuffers
+    except Exception as e:
+        errors.append(e)
+
+
+def test_shared_null_context():
+    # The null backend and the traced dispatch table are process wide, the context is used from several threads
+    ctx = moderngl.create_context(standalone=True, backend="null")
+    ctx.enable_gl_stats()
+    framebuffers = [ctx.simple_framebuffer((4, 4)) for _ in range(4)]
+    errors = []
+    threads = [threading.Thread(target=_use_framebuffers, args=(ctx, framebuffers, errors)) for _ in range(4)]
+
+    for thread in threads:
+        thread.start()
+
+    for thread in threads:
+        thread.join()
+
+    assert not errors
+    assert ctx.gl_stats()["glBindFramebuffer"][0] >= 4 * 200 * 4
+    ctx.disable_gl_stats()
+    ctx.release()
+
+
+def test_release_from_other_thread(ctx_new):
+    ctx_new.gc_mode = "context_gc"
+    buffers = [ctx_new.buffer(reserve=64) for _ in range(16)]
+
+    # The objects die on the other thread, the names are deleted by the thread owning the context
+    thread = threading.Thread(target=buffers.clear)
+    thread.start()
+    thread.join()
+
+    assert ctx_new.memory_stats()["buffer"]["count"] == 16
+    assert ctx_new.gc() == 16
+    assert ctx_new.memory_stats()["buffer"]["count"] == 0
+
+
+def test_second_module_instance(ctx):
+    # A fresh copy of the native module does not change the state seen by the existing objects
+    texture = ctx.texture((4, 4), 4)
+    spec = importlib.util.find_spec("moderngl.mgl")
+    mgl = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(mgl)
+    mgl = None
+    gc.collect()
+
+    fbo = ctx.framebuffer(color_attachments=[texture])
+    fbo.clear(1.0, 1.0, 1.0, 1.0)
+    assert texture.read() == b"\xff" * 64
+
+    with pytest.raises(moderngl.Error):
+        ctx.mglo.adopt(object())
@@ -0,0 +1,56 @@
+import struct
+
+import pytest
+
+
+def test_tiles(ctx):
+    renderer = ctx.tiled_renderer((10, 6), tile=(4, 4))
+    tiles = list(renderer.tiles())
+    assert [t.viewport for t in tiles] == [
+        (0, 0, 4, 4), (4, 0, 4, 4), (8, 0, 2, 4),
+        (0, 4, 4, 2), (4, 4, 4, 2), (8, 4, 2, 2),
+    ]
+    assert renderer.framebuffer.size == (4, 4)
+    renderer.release()
+
+
+def test_tile_matrix(ctx):
+    renderer = ctx.tiled_renderer((8, 8), tile=(4, 4))
+    tile = list(renderer.tiles())[3]
+    assert tile.viewport == (4, 4, 4, 4)
+    sx, sy = tile.scale
+    ox, oy = tile.offset
+    # The center of the image maps to the lower left corner of the last tile
+    assert (0.0 * sx + ox, 0.0 * sy + oy) == (-1.0, -1.0)
+    # The upper right corner of the image maps to the upper right corner of the tile
+    assert (1.0 * sx + ox, 1.0 * sy + oy) == (1.0, 1.0)
+    assert tile.matrix[0] == sx and tile.matrix[12] == ox
+    renderer.release()
+
+
+def test_render(ctx, tmp_path):
+    renderer = ctx.tiled_renderer((10, 6), tile=(4, 4))
+
+    def callback(tile):
+        # Encode the tile origin into the color of every pixel
+        ctx.clear(tile.x / 255.0, tile.y / 255.0, 0.0, 1.0)
+
+    path = tmp_path / "output.raw"
+    renderer.render(path, callback)
+    data = path.read_bytes()
+    assert len(data) == 10 * 6 * 4
+
+    for y in range(6):
+        for x in range(10):
+            pixel = data[(y * 10 + x) * 4:(y * 10 + x) * 4 + 4]
+            assert pixel == bytes([x // 4 * 4, y // 4 * 4, 0, 255])
+
+    renderer.release()
+
+
+def test_render_float(ctx, tmp_path):
+    renderer = ctx.tiled_renderer((5, 3), tile=(2, 2), components=1, dtype='f4')
+    renderer.render(tmp_path / "output.raw", lambda tile: ctx.clear(tile.x + tile.y * 10.0))
+    values = struct.unpack('15f', (tmp_path / "output.raw").read_bytes())
+    assert values == tuple(float(x // 2 * 2 + y // 2 * 20) for y in range(3) for x in range(5))
+    renderer.release()
@@ -0,0 +1,103 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+@pytest.fixture
+def worker(ctx_new):
+    worker = ctx_new.create_upload_worker(backend="egl")
+    yield worker
+    worker.release()
+
+
+def test_buffer(ctx_new, worker):
+    data = bytes(range(256)) * 1024
+    job = worker.buffer(data)
+    buf = job.result(timeout=10.0)
+
+    assert job.done()
+    assert buf.ctx is ctx_new
+    assert buf.read() == data
+    assert ctx_new.memory_stats()["buffer"]["total"] == len(data)
+
+
+def test_texture_and_program(ctx_new, worker):
+    tex_job = worker.texture((4, 4), 4, b"\x10\x20\x30\x40" * 16)
+    prog_job = worker.program(
+        vertex_shader="""
+            #version 330
+            in vec2 in_vert;
+            void main() {
+                gl_Position = vec4(in_vert, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330
+            uniform sampler2D tex;
+            out vec4 color;
+            void main() {
+                color = texture(tex, vec2(0.5));
+            }
+        """,
+    )
+
+    tex = tex_job.result(timeout=10.0)
+    prog = prog_job.result(timeout=10.0)
+
+    vbo = ctx_new.buffer(struct.pack("6f", -1.0, -1.0, 3.0, -1.0, -1.0, 3.0))
+    vao = ctx_new.vertex_array(prog, [(vbo, "2f", "in_vert")])
+    fbo = ctx_new.simple_framebuffer((2, 2))
+    fbo.use()
+    tex.use(0)
+    prog["tex"] = 0
+    vao.render()
+
+    assert fbo.read(components=4)[:4] == b"\x10\x20\x30\x40"
+
+
+def test_error(worker):
+    job = worker.texture((4, 4), 4, b"short")
+    with pytest.raises(moderngl.Error):
+        job.result(timeout=10.0)
+
+
+def test_submit(ctx_new, worker):
+    job = worker.submit(lambda ctx: [ctx.buffer(b"abcd"), ctx.buffer(b"efgh")])
+    a, b = job.result(timeout=10.0)
+    assert a.read() + b.read() == b"abcdefgh"
+
+
+def test_released(worker):
+    worker.release()
+    with pytest.raises(RuntimeError):
+        worker.buffer(b"abcd")
+
+
+def test_shares_with_its_context(ctx_new):
+    # Another context is current when the worker is created
+    other = moderngl.create_context(standalone=True, backend="egl")
+    worker = ctx_new.create_upload_worker(backend="egl")
+    buf = worker.buffer(b"abcd").result(timeout=10.0)
+    worker.release()
+    other.release()
+
+    ctx_new.mglo.__enter__()
+    assert buf.read() == b"abcd"
+
+
+def test_plain_result(worker):
+    assert worker.submit(lambda ctx: 42).result(timeout=10.0) == 42
+    assert worker.submit(lambda ctx: (ctx.buffer(b"abcd"), "label")).result(timeout=10.0)[1] == "label"
+
+
+def test_result_never_taken(ctx_new, worker):
+    job = worker.buffer(b"abcd")
+    worker.submit(lambda ctx: None).result(timeout=10.0)
+    assert job.done()
+
+    # The fence is deleted with the worker, the result can still be taken
+    worker.release()
+    assert not worker._fences
+    assert job.result().read() == b"abcd"
@@ -0,0 +1,76 @@
+import struct
+
+import pytest
+
+import moderngl
+
+
+def test_buffer_write_from_file(ctx, tmp_path):
+    data = bytes(range(256)) * 64
+    path = tmp_path / 'data.bin'
+    path.write_bytes(data)
+
+    buf = ctx.buffer(reserve=len(data))
+    buf.write_from_file(path, chunk=1000)
+    assert buf.read() == data
+    buf.release()
+
+
+def test_buffer_write_from_file_range(ctx, tmp_path):
+    path = tmp_path / 'data.bin'
+    path.write_bytes(b'0123456789')
+
+    buf = ctx.buffer(b'.' * 8)
+    buf.write_from_file(str(path), offset=2, size=4, file_offset=3, chunk=3)
+    assert buf.read() == b'..3456..'
+    buf.release()
+
+
+def test_buffer_write_from_file_errors(ctx, tmp_path):
+    path = tmp_path / 'data.bin'
+    path.write_bytes(b'0123456789')
+    buf = ctx.buffer(reserve=4)
+
+    with pytest.raises(moderngl.Error):
+        buf.write_from_file(path)
+
+    with pytest.raises(moderngl.Error):
+        buf.write_from_file(path, size=4, file_offset=8)
+
+    with pytest.raises(OSError):
+        buf.write_from_file(tmp_path / 'missing.bin')
+
+    buf.release()
+
+
+def test_texture_write_from_file(ctx, tmp_path):
+    data = bytes(range(64)) * 3
+    path = tmp_path / 'pixels.bin'
+    path.write_bytes(b'header' + data)
+
+    tex = ctx.texture((8, 8), 3)
+    tex.write_from_file(path, file_offset=6, chunk=50)
+    assert tex.read() == data
+
+    tex.write_from_file(path, viewport=(2, 2, 2, 2), alignment=4, file_offset=6)
+    pixels = tex.read()
+    assert pixels[(2 * 8 + 2) * 3:(2 * 8 + 4) * 3] == data[0:6]
+    assert pixels[(3 * 8 + 2) * 3:(3 * 8 + 4) * 3] == data[8:14]
+    tex.release()
+
+
+def test_texture_write_from_file_after_odd_chunk(ctx, tmp_path):
+    data = bytes(range(256)) * 4
+    path = tmp_path / 'data.bin'
+    path.write_bytes(data)
+    buf = ctx.buffer(reserve=len(data))
+    buf.write_from_file(path, chunk=1001)
+    assert buf.read() == data
+
+    pixels = struct.pack('16f', *range(16))
+    path = tmp_path / 'pixels.bin'
+    path.write_bytes(pixels)
+    tex = ctx.texture((4, 4), 1, dtype='f4')
+    tex.write_from_file(path, chunk=16)
+    assert tex.read() == pixels
+    assert ctx.error == 'GL_NO_ERROR'